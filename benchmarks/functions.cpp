@@ -0,0 +1,232 @@
+#include <benchmark/benchmark.h>
+#include <eigen3/Eigen/Core>
+#include <gsplines/Basis/BasisLegendre.hpp>
+#include <gsplines/Functions/CompiledExpression.hpp>
+#include <gsplines/Functions/ElementalFunctions.hpp>
+#include <gsplines/Functions/FunctionExpression.hpp>
+#include <gsplines/GSpline.hpp>
+#include <memory>
+#include <utility>
+
+using namespace gsplines;
+
+namespace {
+/* Derivative of a product of GSplines, as found in cost functions */
+functions::FunctionExpression product_derivative() {
+  const GSpline g1 = random_gspline({0.0, 1.0}, 6);
+  const GSpline g2 = random_gspline({0.0, 1.0}, 1);
+  return (g1.derivate().to_expression() * g2.to_expression() -
+          g1.derivate(2).to_expression())
+      .derivate(2);
+}
+
+/* Second derivative of a nested composition of elemental functions, whose
+ * leaves are cheap and whose tree is large */
+functions::FunctionExpression composition_derivative() {
+  const functions::Sin sin({-1.0, 1.0});
+  const functions::Cos cos({-1.0, 1.0});
+  const functions::Identity identity({-1.0, 1.0});
+  return (sin + identity + sin.compose(sin))
+      .compose(sin)
+      .compose(cos)
+      .derivate(2);
+}
+
+/* n-th derivative of a product of GSplines with constant factors, as found
+ * in cost functions. The product rule makes it grow combinatorially. */
+functions::FunctionExpression scaled_product_derivative(std::size_t _deg) {
+  const GSpline g1 = random_gspline({0.0, 1.0}, 3);
+  const GSpline g2 = random_gspline({0.0, 1.0}, 3);
+  const GSpline g3 = random_gspline({0.0, 1.0}, 1);
+  return ((2.0 * g1.to_expression() + g2.to_expression()) *
+          (3.0 * g3.to_expression()))
+      .derivate(_deg);
+}
+
+functions::FunctionExpression expression(int _kind) {
+  switch (_kind) {
+    case 0:
+      return product_derivative();
+    case 1:
+      return composition_derivative();
+    default:
+      // After simplification, the repeated products of the product rule
+      // remain as equal subtrees
+      return scaled_product_derivative(4).simplify();
+  }
+}
+}  // namespace
+
+/* First argument: 0 for GSplines, 1 for elemental functions, 2 for the
+ * simplified fourth derivative of a product of GSplines. Second argument:
+ * number of points */
+void BM_ExpressionTree(benchmark::State& state) {
+  const functions::FunctionExpression expression =
+      ::expression(static_cast<int>(state.range(0)));
+  const Eigen::VectorXd points =
+      Eigen::VectorXd::LinSpaced(state.range(1), 0.0, 1.0);
+  Eigen::MatrixXd result(points.size(), expression.get_codom_dim());
+  for (auto _ : state) {
+    expression.value(points, result);
+    benchmark::DoNotOptimize(result.data());
+  }
+  state.SetItemsProcessed(state.iterations() * state.range(1));
+}
+BENCHMARK(BM_ExpressionTree)->ArgsProduct({{0, 1, 2}, {8, 64, 512, 4096}});
+
+void BM_CompiledExpression(benchmark::State& state) {
+  const functions::CompiledExpression compiled =
+      ::expression(static_cast<int>(state.range(0))).compile();
+  const Eigen::VectorXd points =
+      Eigen::VectorXd::LinSpaced(state.range(1), 0.0, 1.0);
+  Eigen::MatrixXd result(points.size(), compiled.get_codom_dim());
+  for (auto _ : state) {
+    compiled.value(points, result);
+    benchmark::DoNotOptimize(result.data());
+  }
+  state.SetItemsProcessed(state.iterations() * state.range(1));
+  state.counters["instructions"] =
+      static_cast<double>(compiled.get_tape().size());
+}
+BENCHMARK(BM_CompiledExpression)->ArgsProduct({{0, 1, 2}, {8, 64, 512, 4096}});
+
+namespace {
+/* Concatenation of _pieces polynomials of degree 5 on unit intervals */
+functions::FunctionExpression concatenation(long _pieces) {
+  auto result = std::make_unique<functions::FunctionExpression>(
+      functions::CanonicPolynomial({0.0, 1.0}, Eigen::VectorXd::Random(6))
+          .to_expression());
+  for (long k = 1; k < _pieces; k++) {
+    result = std::make_unique<functions::FunctionExpression>(
+        std::move(*result).concat(
+            functions::CanonicPolynomial({static_cast<double>(k), k + 1.0},
+                                         Eigen::VectorXd::Random(6))
+                .to_expression()));
+  }
+  return std::move(*result);
+}
+
+/* Concatenation of _pieces GSplines with two intervals each, as produced by
+ * stitching planner segments */
+functions::FunctionExpression gspline_concatenation(long _pieces) {
+  auto result = std::make_unique<functions::FunctionExpression>(
+      random_gspline({0.0, 1.0}, 3).to_expression());
+  for (long k = 1; k < _pieces; k++) {
+    const GSpline piece({static_cast<double>(k), k + 1.0}, 3, 2,
+                        basis::BasisLegendre(6),
+                        Eigen::VectorXd(Eigen::VectorXd::Random(36)),
+                        Eigen::VectorXd(Eigen::VectorXd::Constant(2, 0.5)));
+    result = std::make_unique<functions::FunctionExpression>(
+        std::move(*result).concat(piece.to_expression()));
+  }
+  return std::move(*result);
+}
+}  // namespace
+
+/* Copy of a concatenation, argument: number of pieces */
+void BM_ConcatenationCopy(benchmark::State& state) {
+  const functions::FunctionExpression expression =
+      concatenation(state.range(0));
+  for (auto _ : state) {
+    functions::FunctionExpression copy(expression);
+    benchmark::DoNotOptimize(&copy);
+  }
+}
+BENCHMARK(BM_ConcatenationCopy)->RangeMultiplier(4)->Range(4, 256);
+
+/* Evaluation of a concatenation at 1000 points, argument: number of
+ * pieces */
+void BM_ConcatenationValue(benchmark::State& state) {
+  const functions::FunctionExpression expression =
+      concatenation(state.range(0));
+  const Eigen::VectorXd points = Eigen::VectorXd::LinSpaced(
+      1000, 0.0, static_cast<double>(state.range(0)));
+  Eigen::MatrixXd result(points.size(), 1);
+  for (auto _ : state) {
+    expression.value(points, result);
+    benchmark::DoNotOptimize(result.data());
+  }
+  state.SetItemsProcessed(state.iterations() * points.size());
+}
+BENCHMARK(BM_ConcatenationValue)->RangeMultiplier(4)->Range(4, 256);
+
+/* Evaluation of a concatenation of GSplines at 1000 points, argument:
+ * number of pieces */
+void BM_GSplineConcatenationValue(benchmark::State& state) {
+  const functions::FunctionExpression expression =
+      gspline_concatenation(state.range(0));
+  const Eigen::VectorXd points = Eigen::VectorXd::LinSpaced(
+      1000, 0.0, static_cast<double>(state.range(0)));
+  Eigen::MatrixXd result(points.size(), 3);
+  for (auto _ : state) {
+    expression.value(points, result);
+    benchmark::DoNotOptimize(result.data());
+  }
+  state.SetItemsProcessed(state.iterations() * points.size());
+}
+BENCHMARK(BM_GSplineConcatenationValue)->RangeMultiplier(4)->Range(4, 256);
+
+/* Stitching GSplines with chained concat calls on rvalues, argument: number
+ * of pieces */
+void BM_GSplineStitching(benchmark::State& state) {
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(gspline_concatenation(state.range(0)));
+  }
+  state.SetItemsProcessed(state.iterations() * state.range(0));
+}
+BENCHMARK(BM_GSplineStitching)->RangeMultiplier(4)->Range(4, 4096);
+
+/* Sum of _terms scaled exponentials built with +=, argument: number of
+ * terms */
+void BM_SumInPlace(benchmark::State& state) {
+  const functions::Exponential exp({0.0, 1.0});
+  for (auto _ : state) {
+    functions::FunctionExpression sum(exp);
+    for (long k = 1; k < state.range(0); k++) {
+      sum += 2.0 * exp;
+    }
+    benchmark::DoNotOptimize(&sum);
+  }
+}
+BENCHMARK(BM_SumInPlace)->RangeMultiplier(4)->Range(4, 1024);
+
+/* The same sum built as sum = std::move(sum) + term */
+void BM_SumChained(benchmark::State& state) {
+  const functions::Exponential exp({0.0, 1.0});
+  for (auto _ : state) {
+    auto sum = std::make_unique<functions::FunctionExpression>(exp);
+    for (long k = 1; k < state.range(0); k++) {
+      sum = std::make_unique<functions::FunctionExpression>(std::move(*sum) +
+                                                            2.0 * exp);
+    }
+    benchmark::DoNotOptimize(sum.get());
+  }
+}
+BENCHMARK(BM_SumChained)->RangeMultiplier(4)->Range(4, 1024);
+
+namespace {
+void evaluate(benchmark::State& state,
+              const functions::FunctionExpression& _expression) {
+  const Eigen::VectorXd points = Eigen::VectorXd::LinSpaced(512, 0.0, 1.0);
+  Eigen::MatrixXd result(points.size(), _expression.get_codom_dim());
+  for (auto _ : state) {
+    _expression.value(points, result);
+    benchmark::DoNotOptimize(result.data());
+  }
+  state.counters["nodes"] =
+      static_cast<double>(_expression.get_number_of_nodes());
+}
+}  // namespace
+
+/* Evaluation of the n-th derivative at 512 points, argument: n */
+void BM_Derivative(benchmark::State& state) {
+  evaluate(state, scaled_product_derivative(state.range(0)));
+}
+BENCHMARK(BM_Derivative)->DenseRange(1, 4);
+
+void BM_SimplifiedDerivative(benchmark::State& state) {
+  evaluate(state, scaled_product_derivative(state.range(0)).simplify());
+}
+BENCHMARK(BM_SimplifiedDerivative)->DenseRange(1, 4);
+
+BENCHMARK_MAIN();
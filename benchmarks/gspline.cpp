@@ -0,0 +1,56 @@
+#include <benchmark/benchmark.h>
+#include <eigen3/Eigen/Core>
+#include <gsplines/Basis/BasisLegendre.hpp>
+#include <gsplines/Functions/FunctionExpression.hpp>
+#include <gsplines/GSpline.hpp>
+#include <cstddef>
+
+using namespace gsplines;
+
+/* Scaling of a minimum-jerk-like curve to velocity and acceleration bounds.
+ * The argument is the execution time, which sets the number of samples
+ * needed by a sampled check */
+void BM_LinearScalingMaxVelocityMaxAcceleration(benchmark::State& state) {
+  const GSpline curve = random_gspline(
+      {0.0, static_cast<double>(state.range(0))}, 6, basis::BasisLegendre(6));
+  for (auto _ : state) {
+    GSpline result =
+        curve.linear_scaling_new_execution_time_max_velocity_max_acceleration(
+            0.4, 0.6);
+    benchmark::DoNotOptimize(result.get_interval_lengths().data());
+  }
+}
+BENCHMARK(BM_LinearScalingMaxVelocityMaxAcceleration)
+    ->RangeMultiplier(4)
+    ->Range(1, 64);
+
+namespace {
+void evaluate(benchmark::State& state,
+              const functions::FunctionBase& _function) {
+  const Eigen::VectorXd points = Eigen::VectorXd::LinSpaced(512, 0.0, 1.0);
+  Eigen::MatrixXd result(points.size(), _function.get_codom_dim());
+  for (auto _ : state) {
+    _function.value(points, result);
+    benchmark::DoNotOptimize(result.data());
+  }
+}
+}  // namespace
+
+/* Evaluation at 512 points of the n-th derivative of the product of two
+ * GSplines, as an expression and as a GSpline. Argument: n */
+void BM_GSplineProductExpression(benchmark::State& state) {
+  const GSpline g1 = random_gspline({0.0, 1.0}, 6);
+  const GSpline g2 = random_gspline({0.0, 1.0}, 1);
+  evaluate(state,
+           (g1.to_expression() * g2.to_expression()).derivate(state.range(0)));
+}
+BENCHMARK(BM_GSplineProductExpression)->DenseRange(0, 3);
+
+void BM_GSplineProduct(benchmark::State& state) {
+  const GSpline g1 = random_gspline({0.0, 1.0}, 6);
+  const GSpline g2 = random_gspline({0.0, 1.0}, 1);
+  evaluate(state, gspline_product(g1, g2).derivate(state.range(0)));
+}
+BENCHMARK(BM_GSplineProduct)->DenseRange(0, 3);
+
+BENCHMARK_MAIN();
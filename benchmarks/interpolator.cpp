@@ -0,0 +1,162 @@
+#include <benchmark/benchmark.h>
+#include <eigen3/Eigen/Core>
+#include <eigen3/Eigen/LU>
+#include <eigen3/Eigen/SparseLU>
+#include <gsplines/Basis/BasisLegendre.hpp>
+#include <gsplines/Interpolator.hpp>
+#include <cstddef>
+#include <vector>
+
+using namespace gsplines;
+
+namespace {
+constexpr std::size_t num_problems = 256;
+constexpr std::size_t num_intervals = 10;
+constexpr std::size_t codom_dim = 6;
+
+void random_problems(std::vector<Eigen::VectorXd>& _tau,
+                     std::vector<Eigen::MatrixXd>& _wp) {
+  for (std::size_t k = 0; k < num_problems; k++) {
+    _tau.emplace_back(Eigen::VectorXd::Random(num_intervals).array() + 1.5);
+    _wp.emplace_back(Eigen::MatrixXd::Random(num_intervals + 1, codom_dim));
+  }
+}
+}  // namespace
+
+/* Independent problems solved with a fresh Interpolator each */
+void BM_InterpolateSerial(benchmark::State& state) {
+  const basis::BasisLegendre basis(6);
+  std::vector<Eigen::VectorXd> tau;
+  std::vector<Eigen::MatrixXd> wp;
+  random_problems(tau, wp);
+  for (auto _ : state) {
+    for (std::size_t k = 0; k < num_problems; k++) {
+      benchmark::DoNotOptimize(interpolate(tau[k], wp[k], basis));
+    }
+  }
+  state.counters["problems_per_second"] = benchmark::Counter(
+      static_cast<double>(num_problems * state.iterations()),
+      benchmark::Counter::kIsRate);
+}
+BENCHMARK(BM_InterpolateSerial)->UseRealTime();
+
+/* Independent problems distributed over state.range(0) threads */
+void BM_InterpolateMany(benchmark::State& state) {
+  const basis::BasisLegendre basis(6);
+  std::vector<Eigen::VectorXd> tau;
+  std::vector<Eigen::MatrixXd> wp;
+  random_problems(tau, wp);
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(interpolate_many(
+        tau, wp, basis, static_cast<std::size_t>(state.range(0))));
+  }
+  state.counters["problems_per_second"] = benchmark::Counter(
+      static_cast<double>(num_problems * state.iterations()),
+      benchmark::Counter::kIsRate);
+}
+BENCHMARK(BM_InterpolateMany)
+    ->RangeMultiplier(2)
+    ->Range(1, 16)
+    ->UseRealTime();
+
+/* Problems sharing the interval lengths, solved with one factorization */
+void BM_InterpolateBatch(benchmark::State& state) {
+  const basis::BasisLegendre basis(6);
+  std::vector<Eigen::VectorXd> tau;
+  std::vector<Eigen::MatrixXd> wp;
+  random_problems(tau, wp);
+  Interpolator inter(codom_dim, num_intervals, basis);
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(inter.interpolate_batch(tau.front(), wp));
+  }
+  state.counters["problems_per_second"] = benchmark::Counter(
+      static_cast<double>(num_problems * state.iterations()),
+      benchmark::Counter::kIsRate);
+}
+BENCHMARK(BM_InterpolateBatch)->UseRealTime();
+
+namespace {
+constexpr long update_codom_dim = 6;
+constexpr long update_basis_dim = 6;
+
+/// Interval lengths after changing the length of interval k % N
+Eigen::VectorXd changed_lengths(const Eigen::VectorXd& _tau, long _k) {
+  Eigen::VectorXd result = _tau;
+  result(_k % _tau.size()) *= 1.1;
+  return result;
+}
+}  // namespace
+
+/* Change of the length of one interval followed by a solve, argument: number
+ * of intervals. update_interval_length re-assembles the column block of the
+ * interval and refactorizes the matrix. */
+void BM_UpdateIntervalLength(benchmark::State& state) {
+  const basis::BasisLegendre basis(update_basis_dim);
+  const long intervals = state.range(0);
+  const Eigen::VectorXd tau = Eigen::VectorXd::Random(intervals).array() + 1.5;
+  const Eigen::MatrixXd wp =
+      Eigen::MatrixXd::Random(intervals + 1, update_codom_dim);
+  Interpolator inter(update_codom_dim, intervals, basis);
+  Eigen::VectorXd coefficients(intervals * update_basis_dim * update_codom_dim);
+  inter.solve_interpolation(tau, wp, coefficients);
+  long k = 0;
+  for (auto _ : state) {
+    // Each pass over the intervals changes their lengths or restores them
+    const long interval = k % intervals;
+    inter.update_interval_length(interval,
+                                 (k / intervals) % 2 == 0
+                                     ? changed_lengths(tau, k)(interval)
+                                     : tau(interval));
+    inter.solve_interpolation(inter.get_factorized_interval_lengths(), wp,
+                              coefficients);
+    benchmark::DoNotOptimize(coefficients.data());
+    k++;
+  }
+}
+BENCHMARK(BM_UpdateIntervalLength)->Arg(4)->Arg(16)->Arg(64)->Arg(256);
+
+/* The same change applied as a Woodbury low-rank correction of the
+ * factorization at the original lengths. The change of the column block of
+ * the interval is precomputed, so its assembly is not timed. */
+void BM_WoodburyUpdate(benchmark::State& state) {
+  const basis::BasisLegendre basis(update_basis_dim);
+  const long intervals = state.range(0);
+  const long block = update_basis_dim * update_codom_dim;
+  const Eigen::VectorXd tau = Eigen::VectorXd::Random(intervals).array() + 1.5;
+  const Eigen::MatrixXd wp =
+      Eigen::MatrixXd::Random(intervals + 1, update_codom_dim);
+
+  Interpolator inter(update_codom_dim, intervals, basis);
+  inter.factorize_interpolating_matrix(tau);
+  const Eigen::SparseMatrix<double> matrix = inter.get_interpolating_matrix();
+  std::vector<Eigen::MatrixXd> column_changes;
+  for (long i = 0; i < intervals; i++) {
+    inter.factorize_interpolating_matrix(changed_lengths(tau, i));
+    column_changes.emplace_back(
+        Eigen::MatrixXd(inter.get_interpolating_matrix().middleCols(i * block,
+                                                                    block)) -
+        Eigen::MatrixXd(matrix.middleCols(i * block, block)));
+  }
+  Eigen::SparseLU<Eigen::SparseMatrix<double>> solver;
+  solver.compute(matrix);
+  const Eigen::VectorXd rhs = Eigen::VectorXd::Random(matrix.rows());
+
+  long k = 0;
+  for (auto _ : state) {
+    // (A + U E^T)^{-1} b = y - Z (I + E^T Z)^{-1} E^T y, with y = A^{-1} b
+    // and Z = A^{-1} U
+    const long interval = k % intervals;
+    const Eigen::MatrixXd z = solver.solve(column_changes[interval]);
+    Eigen::MatrixXd capacitance = z.middleRows(interval * block, block);
+    capacitance.diagonal().array() += 1.0;
+    const Eigen::VectorXd y = solver.solve(rhs);
+    const Eigen::VectorXd x =
+        y - z * capacitance.partialPivLu().solve(
+                    y.segment(interval * block, block));
+    benchmark::DoNotOptimize(x.data());
+    k++;
+  }
+}
+BENCHMARK(BM_WoodburyUpdate)->Arg(4)->Arg(16)->Arg(64)->Arg(256);
+
+BENCHMARK_MAIN();
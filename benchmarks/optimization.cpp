@@ -0,0 +1,205 @@
+#include <benchmark/benchmark.h>
+#include <eigen3/Eigen/Core>
+#include <gsplines/Basis/BasisLegendre.hpp>
+#include <gsplines/Optimization/batch_solver.hpp>
+#include <gsplines/Optimization/ipopt_solver.hpp>
+#include <cstddef>
+#include <optional>
+#include <string>
+#include <vector>
+
+using namespace gsplines;
+
+namespace {
+constexpr std::size_t codom_dim = 6;
+}  // namespace
+
+/* Minimum jerk time allocation with each backend. Range: number of intervals
+ * and backend (0 IPOPT, 1 NEWTON) */
+void BM_OptimalSobolevNorm(benchmark::State& state) {
+  const std::size_t intervals = state.range(0);
+  const auto backend = state.range(1) == 0
+                           ? optimization::SolverBackend::IPOPT
+                           : optimization::SolverBackend::NEWTON;
+  const basis::BasisLegendre basis(6);
+  const Eigen::MatrixXd wp = Eigen::MatrixXd::Random(intervals + 1, codom_dim);
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(optimization::optimal_sobolev_norm(
+        wp, basis, {{3, 1.0}}, static_cast<double>(intervals), backend));
+  }
+  state.SetLabel(state.range(1) == 0 ? "ipopt" : "newton");
+}
+BENCHMARK(BM_OptimalSobolevNorm)
+    ->ArgsProduct({{2, 4, 8, 16, 32}, {0, 1}})
+    ->Unit(benchmark::kMillisecond);
+
+/* Minimum jerk time allocation solved by IPOPT with the L-BFGS approximation
+ * of the Hessian (range(1) == 0) or with the exact Hessian (range(1) == 1).
+ * Range: number of intervals and Hessian */
+void BM_IpoptHessian(benchmark::State& state) {
+  const std::size_t intervals = state.range(0);
+  const bool exact = state.range(1) == 1;
+  const basis::BasisLegendre basis(6);
+  const double exec_time = static_cast<double>(intervals);
+  const Eigen::MatrixXd wp = Eigen::MatrixXd::Random(intervals + 1, codom_dim);
+  const optimization::IpoptSolverOptions options =
+      optimization::IpoptSolverOptions().set(
+          "hessian_approximation",
+          std::string(exact ? "exact" : "limited-memory"));
+  optimization::SolverStatistics statistics;
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(optimization::optimal_sobolev_norm(
+        wp, basis, {{3, 1.0}}, exec_time, Eigen::VectorXd::Ones(intervals),
+        options, &statistics));
+  }
+  state.counters["iterations"] = static_cast<double>(statistics.iterations);
+  state.SetLabel(exact ? "exact" : "limited-memory");
+}
+BENCHMARK(BM_IpoptHessian)
+    ->ArgsProduct({{4, 8, 16, 32, 64}, {0, 1}})
+    ->Unit(benchmark::kMillisecond);
+
+/* Replanning after a small displacement of the waypoints, starting from the
+ * uniform interval lengths (range(2) == 0) or from the previous solution
+ * (range(2) == 1). Reports the iterations of the solver. Range: number of
+ * intervals, backend (0 IPOPT, 1 NEWTON) and warm start */
+void BM_Replanning(benchmark::State& state) {
+  const std::size_t intervals = state.range(0);
+  const auto backend = state.range(1) == 0
+                           ? optimization::SolverBackend::IPOPT
+                           : optimization::SolverBackend::NEWTON;
+  const bool warm_start = state.range(2) == 1;
+  const basis::BasisLegendre basis(6);
+  const double exec_time = static_cast<double>(intervals);
+  const Eigen::MatrixXd wp = Eigen::MatrixXd::Random(intervals + 1, codom_dim);
+  const Eigen::MatrixXd new_wp =
+      wp + 1.0e-2 * Eigen::MatrixXd::Random(intervals + 1, codom_dim);
+
+  const std::optional<GSpline> previous = optimization::optimal_sobolev_norm(
+      wp, basis, {{3, 1.0}}, exec_time, backend);
+  if (not previous.has_value()) {
+    state.SkipWithError("The initial problem failed");
+    return;
+  }
+  const Eigen::VectorXd initial_tau =
+      warm_start ? previous->get_interval_lengths()
+                 : Eigen::VectorXd::Ones(intervals);
+
+  optimization::SolverStatistics statistics;
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(optimization::optimal_sobolev_norm(
+        new_wp, basis, {{3, 1.0}}, exec_time, initial_tau, backend,
+        &statistics));
+  }
+  state.counters["iterations"] = static_cast<double>(statistics.iterations);
+  state.SetLabel(std::string(state.range(1) == 0 ? "ipopt" : "newton") +
+                 (warm_start ? "/warm" : "/cold"));
+}
+BENCHMARK(BM_Replanning)
+    ->ArgsProduct({{4, 16, 32}, {0, 1}, {0, 1}})
+    ->Unit(benchmark::kMillisecond);
+
+/* Replanning with IPOPT after a small displacement of the waypoints,
+ * warm-started from the previous interval lengths only (range(1) == 0) or
+ * also from the previous multipliers (range(1) == 1). Both use the same warm
+ * start options. Reports the iterations of IPOPT. Range: number of
+ * intervals and warm start */
+void BM_IpoptWarmStart(benchmark::State& state) {
+  const std::size_t intervals = state.range(0);
+  const bool multipliers = state.range(1) == 1;
+  const basis::BasisLegendre basis(6);
+  const double exec_time = static_cast<double>(intervals);
+  const Eigen::MatrixXd wp = Eigen::MatrixXd::Random(intervals + 1, codom_dim);
+  const Eigen::MatrixXd new_wp =
+      wp + 1.0e-2 * Eigen::MatrixXd::Random(intervals + 1, codom_dim);
+  optimization::IpoptSolverOptions options =
+      optimization::IpoptSolverOptions::defaults();
+  options.set("mu_init", 1.0e-6)
+      .set("warm_start_bound_push", 1.0e-9)
+      .set("warm_start_mult_bound_push", 1.0e-9);
+
+  optimization::IpoptWarmStart uniform;
+  uniform.interval_lengths = Eigen::VectorXd::Ones(intervals);
+  optimization::IpoptWarmStart previous;
+  if (not optimization::optimal_sobolev_norm(wp, basis, {{3, 1.0}}, exec_time,
+                                             uniform, options, &previous)) {
+    state.SkipWithError("The initial problem failed");
+    return;
+  }
+  optimization::IpoptWarmStart warm_start;
+  warm_start.interval_lengths = previous.interval_lengths;
+  if (multipliers) {
+    warm_start = previous;
+  }
+
+  optimization::SolverStatistics statistics;
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(optimization::optimal_sobolev_norm(
+        new_wp, basis, {{3, 1.0}}, exec_time, warm_start, options, nullptr,
+        &statistics));
+  }
+  state.counters["iterations"] = static_cast<double>(statistics.iterations);
+  state.SetLabel(multipliers ? "primal-dual" : "primal");
+}
+BENCHMARK(BM_IpoptWarmStart)
+    ->ArgsProduct({{4, 16, 32}, {0, 1}})
+    ->Unit(benchmark::kMillisecond);
+
+/* Independent minimum jerk problems solved concurrently, one per thread, each
+ * with its own solver options. Range: backend (0 IPOPT, 1 NEWTON) */
+void BM_ParallelOptimalSobolevNorm(benchmark::State& state) {
+  const std::size_t intervals = 8;
+  const basis::BasisLegendre basis(6);
+  static const Eigen::MatrixXd wp =
+      Eigen::MatrixXd::Random(intervals + 1, codom_dim);
+  const double exec_time = static_cast<double>(intervals);
+  const optimization::IpoptSolverOptions options =
+      optimization::IpoptSolverOptions().set(
+          "tol", state.thread_index() % 2 == 0 ? 1.0e-3 : 1.0e-6);
+  for (auto _ : state) {
+    if (state.range(0) == 0) {
+      benchmark::DoNotOptimize(optimization::optimal_sobolev_norm(
+          wp, basis, {{3, 1.0}}, exec_time, options));
+    } else {
+      benchmark::DoNotOptimize(optimization::optimal_sobolev_norm(
+          wp, basis, {{3, 1.0}}, exec_time,
+          optimization::SolverBackend::NEWTON));
+    }
+  }
+  state.SetItemsProcessed(state.iterations());
+  state.SetLabel(state.range(0) == 0 ? "ipopt" : "newton");
+}
+BENCHMARK(BM_ParallelOptimalSobolevNorm)
+    ->Arg(0)
+    ->Arg(1)
+    ->ThreadRange(1, 8)
+    ->UseRealTime()
+    ->Unit(benchmark::kMillisecond);
+
+/* Batch of independent minimum jerk problems. Range: number of worker threads
+ * and backend (0 IPOPT, 1 NEWTON) */
+void BM_MinimumJerkPathBatch(benchmark::State& state) {
+  const std::size_t num_problems = 64;
+  const std::size_t intervals = 8;
+  std::vector<Eigen::MatrixXd> wp;
+  for (std::size_t k = 0; k < num_problems; k++) {
+    wp.emplace_back(Eigen::MatrixXd::Random(intervals + 1, codom_dim));
+  }
+  optimization::BatchOptions options;
+  options.num_threads = state.range(0);
+  options.backend = state.range(1) == 0 ? optimization::SolverBackend::IPOPT
+                                        : optimization::SolverBackend::NEWTON;
+  for (auto _ : state) {
+    benchmark::DoNotOptimize(optimization::minimum_jerk_path_batch(wp, options));
+  }
+  state.counters["problems_per_second"] = benchmark::Counter(
+      static_cast<double>(num_problems * state.iterations()),
+      benchmark::Counter::kIsRate);
+  state.SetLabel(state.range(1) == 0 ? "ipopt" : "newton");
+}
+BENCHMARK(BM_MinimumJerkPathBatch)
+    ->ArgsProduct({{1, 2, 4, 8}, {0, 1}})
+    ->UseRealTime()
+    ->Unit(benchmark::kMillisecond);
+
+BENCHMARK_MAIN();
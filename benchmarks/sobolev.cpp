@@ -0,0 +1,50 @@
+#include <benchmark/benchmark.h>
+#include <eigen3/Eigen/Core>
+#include <gsplines/Basis/BasisLegendre.hpp>
+#include <gsplines/FunctionalAnalysis/Sobolev.hpp>
+#include <cstddef>
+
+using namespace gsplines;
+
+namespace {
+constexpr std::size_t codom_dim = 6;
+}  // namespace
+
+/* Gradient of the jerk cost. Two interval lengths are alternated so that the
+ * memo of SobolevNorm does not hide the evaluation */
+void BM_SobolevGradient(benchmark::State& state) {
+  const std::size_t intervals = state.range(0);
+  const basis::BasisLegendre basis(6);
+  const Eigen::MatrixXd wp = Eigen::MatrixXd::Random(intervals + 1, codom_dim);
+  const Eigen::VectorXd tau_1 = Eigen::VectorXd::Random(intervals).array() + 2;
+  const Eigen::VectorXd tau_2 = tau_1 * 1.01;
+  functional_analysis::SobolevNorm cost(wp, basis, {{3, 1.0}});
+  Eigen::VectorXd gradient(intervals);
+  bool first = true;
+  for (auto _ : state) {
+    cost.deriv_wrt_interval_len(first ? tau_1 : tau_2, gradient);
+    benchmark::DoNotOptimize(gradient.data());
+    first = not first;
+  }
+}
+BENCHMARK(BM_SobolevGradient)->RangeMultiplier(2)->Range(4, 64);
+
+/* Exact Hessian of the jerk cost */
+void BM_SobolevHessian(benchmark::State& state) {
+  const std::size_t intervals = state.range(0);
+  const basis::BasisLegendre basis(6);
+  const Eigen::MatrixXd wp = Eigen::MatrixXd::Random(intervals + 1, codom_dim);
+  const Eigen::VectorXd tau_1 = Eigen::VectorXd::Random(intervals).array() + 2;
+  const Eigen::VectorXd tau_2 = tau_1 * 1.01;
+  functional_analysis::SobolevNorm cost(wp, basis, {{3, 1.0}});
+  Eigen::MatrixXd hessian(intervals, intervals);
+  bool first = true;
+  for (auto _ : state) {
+    cost.hessian_wrt_interval_len(first ? tau_1 : tau_2, hessian);
+    benchmark::DoNotOptimize(hessian.data());
+    first = not first;
+  }
+}
+BENCHMARK(BM_SobolevHessian)->RangeMultiplier(2)->Range(4, 64);
+
+BENCHMARK_MAIN();
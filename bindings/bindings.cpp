@@ -8,6 +8,7 @@
 #include <gsplines/Functions/ElementalFunctions.hpp>
 #include <gsplines/Functions/FunctionExpression.hpp>
 #include <gsplines/Optimization/ipopt_solver.hpp>
+#include <pybind11/functional.h>
 #include <vector>
 
 PYBIND11_MODULE(pygsplines, gsplines_module) {
@@ -321,21 +322,173 @@ PYBIND11_MODULE(pygsplines, gsplines_module) {
   // -----------------------
   // Optimization Submodule
   // -----------------------
-  optimization_submodule.def("broken_lines_path",
-                             &gsplines::optimization::broken_lines_path);
+  optimization_submodule.def(
+      "broken_lines_path",
+      py::overload_cast<const Eigen::Ref<const Eigen::MatrixXd>&>(
+          &gsplines::optimization::broken_lines_path));
+  optimization_submodule.def(
+      "broken_lines_path",
+      py::overload_cast<const Eigen::Ref<const Eigen::MatrixXd>&,
+                        const Eigen::Ref<const Eigen::VectorXd>&>(
+          &gsplines::optimization::broken_lines_path));
   optimization_submodule.def(
       "minimum_acceleration_path",
-      &gsplines::optimization::minimum_acceleration_path);
-  optimization_submodule.def("minimum_jerk_path",
-                             &gsplines::optimization::minimum_jerk_path);
-  optimization_submodule.def("minimum_snap_path",
-                             &gsplines::optimization::minimum_snap_path);
-  optimization_submodule.def("minimum_crackle_path",
-                             &gsplines::optimization::minimum_crackle_path);
+      py::overload_cast<const Eigen::Ref<const Eigen::MatrixXd>&>(
+          &gsplines::optimization::minimum_acceleration_path));
+  optimization_submodule.def(
+      "minimum_acceleration_path",
+      py::overload_cast<const Eigen::Ref<const Eigen::MatrixXd>&,
+                        const Eigen::Ref<const Eigen::VectorXd>&>(
+          &gsplines::optimization::minimum_acceleration_path));
+  optimization_submodule.def(
+      "minimum_jerk_path",
+      py::overload_cast<const Eigen::Ref<const Eigen::MatrixXd>&>(
+          &gsplines::optimization::minimum_jerk_path));
+  optimization_submodule.def(
+      "minimum_jerk_path",
+      py::overload_cast<const Eigen::Ref<const Eigen::MatrixXd>&,
+                        const Eigen::Ref<const Eigen::VectorXd>&>(
+          &gsplines::optimization::minimum_jerk_path));
+  optimization_submodule.def(
+      "minimum_snap_path",
+      py::overload_cast<const Eigen::Ref<const Eigen::MatrixXd>&>(
+          &gsplines::optimization::minimum_snap_path));
+  optimization_submodule.def(
+      "minimum_snap_path",
+      py::overload_cast<const Eigen::Ref<const Eigen::MatrixXd>&,
+                        const Eigen::Ref<const Eigen::VectorXd>&>(
+          &gsplines::optimization::minimum_snap_path));
+  optimization_submodule.def(
+      "minimum_crackle_path",
+      py::overload_cast<const Eigen::Ref<const Eigen::MatrixXd>&>(
+          &gsplines::optimization::minimum_crackle_path));
+  optimization_submodule.def(
+      "minimum_crackle_path",
+      py::overload_cast<const Eigen::Ref<const Eigen::MatrixXd>&,
+                        const Eigen::Ref<const Eigen::VectorXd>&>(
+          &gsplines::optimization::minimum_crackle_path));
   optimization_submodule.def("rojas_path", &gsplines::optimization::rojas_path);
 
-  optimization_submodule.def("optimal_sobolev_norm",
-                             &gsplines::optimization::optimal_sobolev_norm);
+  py::enum_<gsplines::optimization::SolverBackend>(optimization_submodule,
+                                                  "SolverBackend")
+      .value("IPOPT", gsplines::optimization::SolverBackend::IPOPT)
+      .value("NEWTON", gsplines::optimization::SolverBackend::NEWTON);
+
+  py::class_<gsplines::optimization::SolverStatistics>(optimization_submodule,
+                                                      "SolverStatistics")
+      .def(py::init<>())
+      .def_readwrite("callback",
+                     &gsplines::optimization::SolverStatistics::callback)
+      .def_property_readonly(
+          "return_status",
+          [](const gsplines::optimization::SolverStatistics& _stats) {
+            return static_cast<int>(_stats.return_status);
+          })
+      .def_readonly("iterations",
+                    &gsplines::optimization::SolverStatistics::iterations)
+      .def_readonly("cost_history",
+                    &gsplines::optimization::SolverStatistics::cost_history)
+      .def_readonly("total_time",
+                    &gsplines::optimization::SolverStatistics::total_time)
+      .def_readonly("solver_time",
+                    &gsplines::optimization::SolverStatistics::solver_time)
+      .def_property_readonly(
+          "cost_timings",
+          [](const gsplines::optimization::SolverStatistics& _stats) {
+            const auto& t = _stats.cost_timings;
+            py::dict result;
+            result["assembly"] = t.interpolation.assembly;
+            result["factorization"] = t.interpolation.factorization;
+            result["solve"] = t.interpolation.solve;
+            result["gram"] = t.gram;
+            result["gradient"] = t.gradient;
+            result["hessian"] = t.hessian;
+            result["evaluations"] = t.evaluations;
+            result["gradient_evaluations"] = t.gradient_evaluations;
+            result["hessian_evaluations"] = t.hessian_evaluations;
+            return result;
+          });
+
+  py::class_<gsplines::optimization::AnytimeSolution>(optimization_submodule,
+                                                     "AnytimeSolution")
+      .def_readonly("curve", &gsplines::optimization::AnytimeSolution::curve)
+      .def_readonly("converged",
+                    &gsplines::optimization::AnytimeSolution::converged)
+      .def_readonly("suboptimality",
+                    &gsplines::optimization::AnytimeSolution::suboptimality)
+      .def_readonly("elapsed_time",
+                    &gsplines::optimization::AnytimeSolution::elapsed_time);
+
+  optimization_submodule.def(
+      "optimal_sobolev_norm_anytime",
+      py::overload_cast<const Eigen::Ref<const Eigen::MatrixXd>&,
+                        const gsplines::basis::Basis&,
+                        const std::vector<std::pair<std::size_t, double>>&,
+                        double, double, gsplines::optimization::SolverBackend>(
+          &gsplines::optimization::optimal_sobolev_norm_anytime),
+      py::arg("waypoints"), py::arg("basis"), py::arg("weights"),
+      py::arg("exec_time"), py::arg("time_budget"),
+      py::arg("backend") = gsplines::optimization::SolverBackend::IPOPT);
+
+  py::class_<gsplines::optimization::IpoptSolverOptions>(
+      optimization_submodule, "IpoptSolverOptions")
+      .def(py::init<>())
+      .def("set",
+           py::overload_cast<const std::string&, const std::string&>(
+               &gsplines::optimization::IpoptSolverOptions::set),
+           py::return_value_policy::reference_internal)
+      .def("set",
+           py::overload_cast<const std::string&, int>(
+               &gsplines::optimization::IpoptSolverOptions::set),
+           py::return_value_policy::reference_internal)
+      .def("set",
+           py::overload_cast<const std::string&, double>(
+               &gsplines::optimization::IpoptSolverOptions::set),
+           py::return_value_policy::reference_internal)
+      .def_static("defaults",
+                  &gsplines::optimization::IpoptSolverOptions::defaults);
+
+  optimization_submodule.def(
+      "minimum_time_path", &gsplines::optimization::minimum_time_path,
+      py::arg("waypoints"), py::arg("basis"), py::arg("velocity_bounds"),
+      py::arg("acceleration_bounds"), py::arg("samples_per_interval") = 10,
+      py::arg("options") =
+          gsplines::optimization::IpoptSolverOptions::defaults());
+
+  optimization_submodule.def(
+      "optimal_sobolev_norm",
+      py::overload_cast<const Eigen::Ref<const Eigen::MatrixXd>&,
+                        const gsplines::basis::Basis&,
+                        const std::vector<std::pair<std::size_t, double>>&,
+                        double>(&gsplines::optimization::optimal_sobolev_norm));
+  optimization_submodule.def(
+      "optimal_sobolev_norm",
+      py::overload_cast<const Eigen::Ref<const Eigen::MatrixXd>&,
+                        const gsplines::basis::Basis&,
+                        const std::vector<std::pair<std::size_t, double>>&,
+                        double,
+                        const gsplines::optimization::IpoptSolverOptions&>(
+          &gsplines::optimization::optimal_sobolev_norm));
+  optimization_submodule.def(
+      "optimal_sobolev_norm",
+      py::overload_cast<const Eigen::Ref<const Eigen::MatrixXd>&,
+                        const gsplines::basis::Basis&,
+                        const std::vector<std::pair<std::size_t, double>>&,
+                        double, gsplines::optimization::SolverBackend>(
+          &gsplines::optimization::optimal_sobolev_norm));
+  optimization_submodule.def(
+      "optimal_sobolev_norm",
+      py::overload_cast<const Eigen::Ref<const Eigen::MatrixXd>&,
+                        const gsplines::basis::Basis&,
+                        const std::vector<std::pair<std::size_t, double>>&,
+                        double, const Eigen::Ref<const Eigen::VectorXd>&,
+                        gsplines::optimization::SolverBackend,
+                        gsplines::optimization::SolverStatistics*>(
+          &gsplines::optimization::optimal_sobolev_norm),
+      py::arg("waypoints"), py::arg("basis"), py::arg("weights"),
+      py::arg("exec_time"), py::arg("initial_interval_lengths"),
+      py::arg("backend") = gsplines::optimization::SolverBackend::IPOPT,
+      py::arg("statistics") = nullptr);
 
   // ---------------
   // Gsplines module
@@ -347,6 +500,7 @@ PYBIND11_MODULE(pygsplines, gsplines_module) {
                                                                "Interpolator")
       .def(py::init<std::size_t, std::size_t, gsplines::basis::Basis&>())
       .def("interpolate", &gsplines::PyInterpolator::py_interpolate)
+      .def("interpolate_batch", &gsplines::PyInterpolator::interpolate_batch)
       .def("solve_interpolation",
            &gsplines::PyInterpolator::py_solve_interpolation)
       .def("print_interpolating_matrix",
@@ -369,6 +523,10 @@ PYBIND11_MODULE(pygsplines, gsplines_module) {
   gsplines_module.def("interpolate", &gsplines::interpolate,
                       "iterpolates waypoints");
 
+  gsplines_module.def("interpolate_batch", &gsplines::interpolate_batch,
+                      "iterpolates several sets of waypoints with the same "
+                      "interval lengths");
+
   gsplines_module.def("pw_polynomial_interpolation",
                       &gsplines::pw_polynomial_interpolation);
   // ------------------------------
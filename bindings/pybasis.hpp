@@ -56,6 +56,21 @@ public:
     PYBIND11_OVERRIDE_PURE(void, Basis, add_derivative_matrix_deriv_wrt_tau,
                            _tau, _deg, _mat);
   }
+  void eval_second_derivative_wrt_tau_on_window(
+      double _s, double _tau, unsigned int _deg,
+      Eigen::Ref<Eigen::VectorXd, 0, Eigen::InnerStride<>> _buff)
+      const override {
+
+    PYBIND11_OVERRIDE(void, Basis, eval_second_derivative_wrt_tau_on_window,
+                      _s, _tau, _deg, _buff);
+  }
+  void add_derivative_matrix_second_deriv_wrt_tau(
+      double _tau, std::size_t _deg,
+      Eigen::Ref<Eigen::MatrixXd> _mat) override {
+
+    PYBIND11_OVERRIDE(void, Basis, add_derivative_matrix_second_deriv_wrt_tau,
+                      _tau, _deg, _mat);
+  }
   Eigen::MatrixXd derivative_matrix_impl(std::size_t _deg) const override {
 
     PYBIND11_OVERRIDE_PURE(Eigen::MatrixXd, Basis, derivative_matrix_impl,
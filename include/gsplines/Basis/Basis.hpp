@@ -57,6 +57,24 @@ private:
 protected:
   Eigen::MatrixXd derivative_matrix_;
 
+  /**
+   * @brief Second derivative wrt tau of the window evaluation of a
+   * polynomial basis, whose derivative of degree _deg scales as
+   * (2/tau)^_deg.
+   */
+  void polynomial_second_derivative_wrt_tau_on_window(
+      double _s, double _tau, unsigned int _deg,
+      Eigen::Ref<Eigen::VectorXd, 0, Eigen::InnerStride<>> _buff) const;
+
+  /**
+   * @brief Adds the second derivative wrt tau of the derivative matrix
+   * block of a polynomial basis, whose block of degree _deg is
+   * _blocks[_deg] scaled by (2/tau)^(2 _deg - 1).
+   */
+  void add_polynomial_derivative_matrix_second_deriv_wrt_tau(
+      double tau, std::size_t _deg, const std::vector<Eigen::MatrixXd> &_blocks,
+      Eigen::Ref<Eigen::MatrixXd> _mat) const;
+
 public:
   /**
    * @brief Constructor
@@ -157,6 +175,27 @@ public:
   add_derivative_matrix_deriv_wrt_tau(double tau, std::size_t _deg,
                                       Eigen::Ref<Eigen::MatrixXd> _mat) = 0;
 
+  /**
+   * @brief Evaluate the second derivative of the basis with respect to tau.
+   * Bases without a closed form throw std::logic_error.
+   *
+   * @param _s Value inside the window [-1, 1]
+   * @param _tau scaling factor, actual length of the interval in the GSpline
+   * @param _deg degree of the derivative
+   * @param _buff Buffer where the output is stored.
+   */
+  virtual void eval_second_derivative_wrt_tau_on_window(
+      double _s, double _tau, unsigned int _deg,
+      Eigen::Ref<Eigen::VectorXd, 0, Eigen::InnerStride<>> _buff) const;
+
+  /**
+   * @brief Adds the second derivative with respect to tau of the derivative
+   * matrix block. Bases without a closed form throw std::logic_error.
+   */
+  virtual void
+  add_derivative_matrix_second_deriv_wrt_tau(double tau, std::size_t _deg,
+                                             Eigen::Ref<Eigen::MatrixXd> _mat);
+
   virtual std::unique_ptr<Basis> clone() const = 0;
   virtual std::unique_ptr<Basis> move_clone() = 0;
 
@@ -39,6 +39,14 @@ public:
   void add_derivative_matrix_deriv_wrt_tau(
       double tau, std::size_t _deg, Eigen::Ref<Eigen::MatrixXd> _mat) override;
 
+  void eval_second_derivative_wrt_tau_on_window(
+      double _s, double _tau, unsigned int _deg,
+      Eigen::Ref<Eigen::VectorXd, 0, Eigen::InnerStride<>> _buff)
+      const override;
+
+  void add_derivative_matrix_second_deriv_wrt_tau(
+      double tau, std::size_t _deg, Eigen::Ref<Eigen::MatrixXd> _mat) override;
+
   std::unique_ptr<Basis> clone() const override {
     return std::make_unique<BasisLegendre>(*this);
   };
@@ -16,6 +16,22 @@
 namespace gsplines {
 namespace functional_analysis {
 
+/// Accumulated wall-clock time [s] and number of evaluations of SobolevNorm,
+/// see SobolevNorm::set_timings
+struct SobolevNormTimings {
+  /// Assembly, factorization and solution of the interpolation problem
+  InterpolationTimings interpolation;
+  /// Gram blocks and value of the norm
+  double gram = 0.0;
+  /// Gradient, once the interpolant is known
+  double gradient = 0.0;
+  /// Hessian, once the interpolant is known
+  double hessian = 0.0;
+  std::size_t evaluations = 0;
+  std::size_t gradient_evaluations = 0;
+  std::size_t hessian_evaluations = 0;
+};
+
 class SobolevNorm {
   friend class GSpline;
 
@@ -29,9 +45,32 @@ private:
   std::vector<std::pair<std::size_t, double>> weights_;
   Eigen::MatrixXd waypoints_;
 
-  double inner_prod(const Eigen::Ref<const Eigen::VectorXd> _interval_lengths,
-                    const Eigen::Ref<const Eigen::VectorXd> _v1,
-                    const Eigen::Ref<const Eigen::VectorXd> _v2);
+  /// Memo of the last evaluation point. IPOPT evaluates the cost and its
+  /// gradient at the same interval lengths, so we keep the coefficients of
+  /// the interpolant and the Gram blocks of each interval.
+  Eigen::VectorXd memo_interval_lengths_;
+  Eigen::VectorXd memo_coefficients_;
+  std::vector<Eigen::MatrixXd> memo_gram_blocks_;
+  double memo_value_;
+  Eigen::VectorXd memo_gradient_;
+  bool memo_gradient_valid_;
+
+  void update_memo(const Eigen::Ref<const Eigen::VectorXd> _interval_lengths);
+
+  double inner_prod(const Eigen::Ref<const Eigen::VectorXd> _v1,
+                    const Eigen::Ref<const Eigen::VectorXd> _v2) const;
+
+  /// _result = Q _v, where Q is the block diagonal Gram matrix of the memo
+  void gram_product(const Eigen::Ref<const Eigen::VectorXd> _v,
+                    Eigen::Ref<Eigen::VectorXd> _result) const;
+
+  /// Buffers of the Hessian: derivatives of the coefficients wrt each
+  /// interval length (one per column) and their product with Q
+  Eigen::MatrixXd coeff_derivatives_;
+  Eigen::MatrixXd gram_coeff_derivatives_;
+  Eigen::VectorXd gram_coeff_;
+
+  SobolevNormTimings *timings_ = nullptr;
 
 protected:
   Eigen::MatrixXd matrix_;
@@ -47,6 +86,20 @@ public:
   void deriv_wrt_interval_len(
       const Eigen::Ref<const Eigen::VectorXd> _interval_lengths,
       Eigen::Ref<Eigen::VectorXd> _buff);
+  /**
+   * @brief Exact Hessian of the norm with respect to the interval lengths.
+   * It reuses the factorization of the interpolating matrix: one adjoint
+   * solve plus one solve per interval.
+   */
+  void hessian_wrt_interval_len(
+      const Eigen::Ref<const Eigen::VectorXd> _interval_lengths,
+      Eigen::Ref<Eigen::MatrixXd> _hess);
+
+  /**
+   * @brief Accumulate the time spent in each phase of the evaluations in
+   * *_timings. Pass nullptr to stop timing.
+   */
+  void set_timings(SobolevNormTimings *_timings);
 };
 
 double
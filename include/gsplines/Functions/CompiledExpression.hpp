@@ -0,0 +1,120 @@
+#ifndef COMPILED_EXPRESSION
+#define COMPILED_EXPRESSION
+
+#include <cstddef>
+#include <eigen3/Eigen/Core>
+#include <gsplines/Functions/Function.hpp>
+#include <gsplines/Functions/FunctionExpression.hpp>
+#include <gsplines/Functions/FunctionInheritanceHelper.hpp>
+#include <limits>
+#include <memory>
+#include <vector>
+
+namespace gsplines {
+namespace functions {
+
+/**
+ * @brief Flat evaluation plan of a FunctionExpression.
+ *
+ * The expression tree is lowered once into a tape of instructions which
+ * operate on a file of registers, one matrix per intermediate value. Sums,
+ * products, negations, compositions and dot products become instructions of
+ * the tape. The leaves, i.e. the functions which are not expressions, and the
+ * concatenations are evaluated through their value method.
+ *
+ * Equal subexpressions, e.g. the repeated factors of the derivatives of a
+ * product, are evaluated once per call and their register is shared by all
+ * their uses. Leaves are compared with FunctionBase::is_same_function.
+ * Registers are reused as soon as their value is not read anymore.
+ *
+ * This sharing exists only inside the tape. The FunctionExpression it is
+ * compiled from still owns a deep copy of each repeated subtree, so
+ * derivate() builds, and value() evaluates, every copy separately. Compile
+ * the expression to evaluate each distinct subexpression once.
+ *
+ * The registers grow to the largest number of points evaluated so far.
+ * After that, evaluating into a preallocated result does not allocate, as
+ * long as the leaves do not allocate.
+ *
+ * The evaluation writes into the registers, so the same instance must not be
+ * evaluated concurrently. Use a copy per thread.
+ */
+class CompiledExpression
+    : public FunctionInheritanceHelper<CompiledExpression, Function,
+                                       FunctionExpression> {
+public:
+  enum OpCode {
+    EVAL, ///< dest = function(points in register lhs)
+    COPY, ///< dest = lhs
+    ADD,  ///< dest += lhs
+    MUL,  ///< dest *= first column of lhs, row by row
+    NEG,  ///< dest *= -1
+    DOT   ///< dest = row by row dot product of lhs and rhs
+  };
+
+  struct Instruction {
+    OpCode op;
+    const FunctionBase *function;
+    std::size_t dest;
+    std::size_t lhs;
+    std::size_t rhs;
+  };
+
+  /// Register index which denotes the points where the expression is
+  /// evaluated
+  static constexpr std::size_t input_register =
+      std::numeric_limits<std::size_t>::max();
+
+private:
+  std::unique_ptr<FunctionExpression> expression_;
+  std::vector<Instruction> tape_;
+  std::vector<std::size_t> register_cols_;
+  std::vector<std::size_t> free_registers_;
+  std::size_t output_register_;
+
+  mutable std::vector<Eigen::MatrixXd> registers_;
+  mutable long capacity_ = 0;
+
+  /// Tape over single assignment values, before register allocation
+  struct LoweringState;
+
+  void compile();
+  std::size_t lower(const FunctionBase &_function, std::size_t _points,
+                    LoweringState &_state);
+  void allocate_registers(const LoweringState &_state, std::size_t _output);
+  std::size_t new_register(std::size_t _cols);
+  void release_register(std::size_t _register);
+
+public:
+  explicit CompiledExpression(const FunctionExpression &_expression);
+  explicit CompiledExpression(FunctionExpression &&_expression);
+
+  CompiledExpression(const CompiledExpression &that);
+  CompiledExpression(CompiledExpression &&that);
+
+  ~CompiledExpression() override = default;
+
+  void value_impl(const Eigen::Ref<const Eigen::VectorXd> _domain_points,
+                  Eigen::Ref<Eigen::MatrixXd> _result) const override;
+
+  /// Grows the registers so that evaluating up to _num_points points does
+  /// not allocate
+  void reserve(std::size_t _num_points) const;
+
+  const FunctionExpression &get_expression() const { return *expression_; }
+
+  const std::vector<Instruction> &get_tape() const { return tape_; }
+
+  std::size_t get_number_of_registers() const {
+    return register_cols_.size();
+  }
+
+  void print(std::size_t _indent = 0) const override;
+
+protected:
+  FunctionExpression *deriv_impl(std::size_t _deg) const override;
+};
+
+} // namespace functions
+} // namespace gsplines
+#endif
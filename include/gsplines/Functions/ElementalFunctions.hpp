@@ -34,6 +34,10 @@ public:
 
   ConstFunction(const ConstFunction &_that);
 
+  const Eigen::VectorXd &get_values() const { return values_; }
+
+  bool is_same_function(const FunctionBase &_that) const override;
+
   void value_impl(const Eigen::Ref<const Eigen::VectorXd> _domain_points,
                   Eigen::Ref<Eigen::MatrixXd> _result) const override;
 
@@ -55,6 +59,8 @@ public:
 
   DomainLinearDilation(const DomainLinearDilation &that);
 
+  bool is_same_function(const FunctionBase &_that) const override;
+
   void value_impl(const Eigen::Ref<const Eigen::VectorXd> _domain_points,
                   Eigen::Ref<Eigen::MatrixXd> _result) const override;
 
@@ -86,6 +92,10 @@ public:
 
   Exponential(const Exponential &that);
 
+  bool is_same_function(const FunctionBase &_that) const override {
+    return same_signature(_that);
+  }
+
   void value_impl(const Eigen::Ref<const Eigen::VectorXd> _domain_points,
                   Eigen::Ref<Eigen::MatrixXd> _result) const override;
 
@@ -103,6 +113,10 @@ public:
 
   Cos(const Cos &that);
 
+  bool is_same_function(const FunctionBase &_that) const override {
+    return same_signature(_that);
+  }
+
   void value_impl(const Eigen::Ref<const Eigen::VectorXd> _domain_points,
                   Eigen::Ref<Eigen::MatrixXd> _result) const override;
 
@@ -117,6 +131,10 @@ public:
 
   Sin(const Sin &that);
 
+  bool is_same_function(const FunctionBase &_that) const override {
+    return same_signature(_that);
+  }
+
   void value_impl(const Eigen::Ref<const Eigen::VectorXd> _domain_points,
                   Eigen::Ref<Eigen::MatrixXd> _result) const override;
 
@@ -141,6 +159,8 @@ public:
 
   CanonicPolynomial(CanonicPolynomial &&that);
 
+  bool is_same_function(const FunctionBase &_that) const override;
+
   void value_impl(const Eigen::Ref<const Eigen::VectorXd> _domain_points,
                   Eigen::Ref<Eigen::MatrixXd> _result) const override;
 
@@ -150,6 +170,8 @@ protected:
 
 class DotProduct : public FunctionInheritanceHelper<DotProduct, Function,
                                                     FunctionExpression> {
+  friend class CompiledExpression;
+
 private:
   FunctionExpression f1_;
   FunctionExpression f2_;
@@ -163,6 +185,8 @@ public:
 
   DotProduct(DotProduct &&that);
 
+  bool is_same_function(const FunctionBase &_that) const override;
+
   void value_impl(const Eigen::Ref<const Eigen::VectorXd> _domain_points,
                   Eigen::Ref<Eigen::MatrixXd> _result) const override;
 
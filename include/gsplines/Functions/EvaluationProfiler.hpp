@@ -0,0 +1,108 @@
+#ifndef EVALUATION_PROFILER
+#define EVALUATION_PROFILER
+
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <map>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace gsplines {
+namespace functions {
+
+/**
+ * @brief Opt-in profile of the evaluation of functions.
+ *
+ * While the profiler of a thread is enabled, each call of FunctionBase::value
+ * in that thread is recorded in a call tree. A node of the tree is labelled
+ * by the type of the expression (SUM, MULTIPLICATION, ...) or by the name of
+ * the function evaluated, and the calls with the same label under the same
+ * parent are accumulated in the same node. When no profiler is enabled,
+ * value() only pays for the load of a counter.
+ */
+class EvaluationProfiler {
+public:
+  struct Node {
+    std::string label;
+    std::size_t calls = 0;
+    /// Number of points evaluated
+    std::size_t points = 0;
+    /// Seconds spent, children included
+    double time = 0.0;
+    /// Bytes allocated by the EvaluationWorkspace, children included
+    std::size_t bytes = 0;
+    std::vector<std::unique_ptr<Node>> children;
+
+    double get_self_time() const;
+    std::size_t get_self_bytes() const;
+  };
+
+  /// Totals of the nodes with the same label, children excluded
+  struct Summary {
+    std::size_t calls = 0;
+    std::size_t points = 0;
+    double time = 0.0;
+    std::size_t bytes = 0;
+  };
+
+  /// Records a call during its lifetime
+  class Scope {
+  private:
+    EvaluationProfiler &profiler_;
+    Node *parent_;
+    std::size_t workspace_size_;
+    std::chrono::steady_clock::time_point start_;
+
+  public:
+    Scope(EvaluationProfiler &_profiler, const std::string &_label,
+          std::size_t _points);
+    Scope(const Scope &) = delete;
+    Scope &operator=(const Scope &) = delete;
+    ~Scope();
+  };
+
+private:
+  static std::atomic<std::size_t> num_enabled_;
+  bool enabled_ = false;
+  Node root_;
+  Node *current_;
+
+public:
+  EvaluationProfiler();
+  EvaluationProfiler(const EvaluationProfiler &) = delete;
+  EvaluationProfiler &operator=(const EvaluationProfiler &) = delete;
+  ~EvaluationProfiler();
+
+  /// Profiler of the calling thread
+  static EvaluationProfiler &thread_instance();
+
+  /// True if the profiler of some thread is enabled
+  static bool is_any_enabled() {
+    return num_enabled_.load(std::memory_order_relaxed) > 0;
+  }
+
+  void enable();
+  void disable();
+  bool is_enabled() const { return enabled_; }
+
+  /// Forgets the calls recorded. No evaluation can be in progress.
+  void clear();
+
+  /// Root of the call tree, its children are the outermost calls
+  const Node &get_root() const { return root_; }
+
+  /// Totals by label
+  std::map<std::string, Summary> get_summary() const;
+
+  /// Prints the call tree
+  void print() const;
+
+  /// Call tree as a JSON array of the outermost calls
+  std::string to_json() const;
+};
+
+} // namespace functions
+} // namespace gsplines
+#endif
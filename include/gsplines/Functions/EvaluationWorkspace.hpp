@@ -0,0 +1,66 @@
+#ifndef EVALUATION_WORKSPACE
+#define EVALUATION_WORKSPACE
+
+#include <cstddef>
+#include <deque>
+#include <eigen3/Eigen/Core>
+
+namespace gsplines {
+namespace functions {
+
+/**
+ * @brief Stack of reusable buffers for the temporaries of the evaluation of
+ * expressions.
+ *
+ * The evaluation of a FunctionExpression needs temporaries sized to the
+ * number of points at each node. They are taken from the workspace of the
+ * evaluating thread as Block objects, which return their buffer when they go
+ * out of scope. The recursion of the evaluation releases them in reverse
+ * order, so the workspace works as a stack. The buffers only grow, hence
+ * once the workspace has seen the largest evaluation, evaluating again does
+ * not allocate.
+ */
+class EvaluationWorkspace {
+private:
+  std::deque<Eigen::VectorXd> buffers_;
+  std::size_t used_ = 0;
+  std::size_t num_growths_ = 0;
+
+public:
+  /// Temporary matrix borrowed from the workspace during its lifetime
+  class Block {
+  private:
+    EvaluationWorkspace &workspace_;
+
+  public:
+    Eigen::Map<Eigen::MatrixXd> matrix;
+
+    Block(EvaluationWorkspace &_workspace, long _rows, long _cols);
+    Block(const Block &) = delete;
+    Block &operator=(const Block &) = delete;
+    ~Block() { workspace_.used_--; }
+  };
+
+  EvaluationWorkspace() = default;
+  EvaluationWorkspace(const EvaluationWorkspace &) = delete;
+  EvaluationWorkspace &operator=(const EvaluationWorkspace &) = delete;
+
+  /// Workspace of the calling thread
+  static EvaluationWorkspace &thread_instance();
+
+  /// Number of buffers, i.e. largest number of simultaneous temporaries
+  std::size_t get_number_of_buffers() const { return buffers_.size(); }
+
+  /// Number of times a buffer was created or enlarged
+  std::size_t get_number_of_growths() const { return num_growths_; }
+
+  /// Number of doubles held by the buffers
+  std::size_t get_size() const;
+
+  /// Frees the buffers. No block can be alive.
+  void clear();
+};
+
+} // namespace functions
+} // namespace gsplines
+#endif
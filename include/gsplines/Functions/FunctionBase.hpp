@@ -3,6 +3,7 @@
 
 #include <eigen3/Eigen/Core>
 #include <cstddef>
+#include <gsplines/Functions/EvaluationProfiler.hpp>
 #include <memory>
 #include <string>
 #include <utility>
@@ -51,6 +52,16 @@ class FunctionBase {
     return domain_.second - domain_.first;
   }
 
+  /**
+   * @brief True if _that is known to be the same function. By default only
+   * the object itself is, functions override it to compare their type and
+   * parameters. Used by CompiledExpression to share equal subexpressions of
+   * its tape.
+   */
+  [[nodiscard]] virtual bool is_same_function(const FunctionBase& _that) const {
+    return this == &_that;
+  }
+
   [[nodiscard]] std::unique_ptr<FunctionBase> clone() const& {
     return std::unique_ptr<FunctionBase>(this->clone_impl());
   }
@@ -71,15 +82,20 @@ class FunctionBase {
       const Eigen::Ref<const Eigen::VectorXd> _domain_points,
       Eigen::Ref<Eigen::MatrixXd> _result) const = 0;
 
+  /// Evaluates the function, see also EvaluationProfiler
   void value(const Eigen::Ref<const Eigen::VectorXd> _domain_points,
              Eigen::Ref<Eigen::MatrixXd> _result) const {
+    if (EvaluationProfiler::is_any_enabled()) {
+      profiled_value(_domain_points, _result);
+      return;
+    }
     value_impl(_domain_points, _result);
   }
 
   Eigen::MatrixXd operator()(
       const Eigen::Ref<const Eigen::VectorXd> _domain_points) const {
     Eigen::MatrixXd result(_domain_points.size(), get_codom_dim());
-    value_impl(_domain_points, result);
+    value(_domain_points, result);
     return result;
   }
 
@@ -122,6 +138,19 @@ class FunctionBase {
   virtual FunctionExpression compose(const FunctionExpression& that) &&;
   virtual FunctionExpression compose(FunctionExpression&& that) &&;
 
+  /**
+   * @brief Function equal to this one on its domain, followed by that.
+   *
+   * Consecutive GSplines with the same basis and codomain dimension are
+   * fused into one GSpline, which changes the value at the joints and out of
+   * the domain. The pieces of a concatenation are defined on [t_k, t_{k+1}),
+   * so a joint is evaluated with the function on its right, whereas a fused
+   * GSpline evaluates it with the interval on its left, on (t_k, t_{k+1}].
+   * Both agree only where the pieces, and for derivatives their derivatives,
+   * are continuous. Out of the domain, a fused GSpline extrapolates the
+   * polynomial of its first or last interval, whereas other concatenations
+   * clamp the point to the domain.
+   */
   [[nodiscard]] virtual FunctionExpression concat(
       const FunctionExpression& that) const&;
   virtual FunctionExpression concat(FunctionExpression&& that) const&;
@@ -130,6 +159,14 @@ class FunctionBase {
   virtual FunctionExpression concat(FunctionExpression&& that) &&;
 
  protected:
+  /// Same dynamic type, domain, codomain dimension and name
+  [[nodiscard]] bool same_signature(const FunctionBase& _that) const;
+
+  /// value() when a profiler is enabled, records the call if it is the one
+  /// of the calling thread
+  void profiled_value(const Eigen::Ref<const Eigen::VectorXd> _domain_points,
+                      Eigen::Ref<Eigen::MatrixXd> _result) const;
+
   void set_domain(double _t0, double _t1) {
     domain_.first = _t0;
     domain_.second = _t1;
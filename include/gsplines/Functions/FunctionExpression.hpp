@@ -5,10 +5,9 @@
 
 #include <cstddef>
 #include <eigen3/Eigen/Core>
-#include <functional>
 #include <gsplines/Functions/FunctionBase.hpp>
 #include <gsplines/Functions/FunctionInheritanceHelper.hpp>
-#include <list>
+#include <gsplines/SmallVector.hpp>
 #include <memory>
 #include <utility>
 #include <vector>
@@ -16,6 +15,20 @@
 namespace gsplines {
 namespace functions {
 class Function;
+class CompiledExpression;
+
+/// Children of an expression node. They are stored contiguously and, as most
+/// nodes are binary, the first two of them inside the node itself.
+typedef tools::SmallVector<std::unique_ptr<FunctionBase>, 2> FunctionArray;
+
+/// Evaluates each child of a concatenation at the points in its domain,
+/// passing each run of consecutive points in the same domain at once.
+/// Points out of the domain are evaluated at the closest bound.
+void eval_concat_functions(
+    const FunctionArray &_function_array,
+    const Eigen::VectorXd &_break_points,
+    const Eigen::Ref<const Eigen::VectorXd> _domain_points,
+    Eigen::Ref<Eigen::MatrixXd> _result);
 
 class FunctionExpression
     : public FunctionInheritanceHelper<FunctionExpression, FunctionBase,
@@ -32,22 +45,22 @@ public:
     EMPTY
   };
 
-  std::list<std::unique_ptr<FunctionBase>> function_array_;
+  FunctionArray function_array_;
 
 private:
-  typedef void(Eval_Function_Type)(
-      const std::list<std::unique_ptr<FunctionBase>> &,
-      const Eigen::Ref<const Eigen::VectorXd> &,
-      Eigen::Ref<Eigen::MatrixXd> _result);
+  typedef void(Eval_Function_Type)(const FunctionArray &,
+                                   const Eigen::Ref<const Eigen::VectorXd>,
+                                   Eigen::Ref<Eigen::MatrixXd> _result);
 
-  typedef FunctionExpression *(Deriv_Function_Type)(
-      const std::list<std::unique_ptr<FunctionBase>> &, std::size_t);
+  typedef FunctionExpression *(Deriv_Function_Type)(const FunctionArray &,
+                                                     std::size_t);
 
-  std::function<Eval_Function_Type> eval_operation_;
-  std::function<Deriv_Function_Type> deriv_operation_;
+  Eval_Function_Type *eval_operation_;
+  Deriv_Function_Type *deriv_operation_;
 
   Type type_;
 
+  /// Bounds of the domains of the children of a concatenation, in order
   Eigen::VectorXd domain_break_points_;
 
   static std::size_t num_call_constructor_;
@@ -58,14 +71,13 @@ private:
 public:
   FunctionExpression(
       std::pair<double, double> _domain, std::size_t _codom_dim, Type _type,
-      const std::list<std::unique_ptr<FunctionBase>> &_function_array,
+      const FunctionArray &_function_array,
       const std::string &_name = "FunctionExpression");
 
   FunctionExpression(std::pair<double, double> _domain, std::size_t _codom_dim);
 
   FunctionExpression(std::pair<double, double> _domain, std::size_t _codom_dim,
-                     Type _type,
-                     std::list<std::unique_ptr<FunctionBase>> &&_function_array,
+                     Type _type, FunctionArray &&_function_array,
                      const std::string &_name = "FunctionExpression");
 
   FunctionExpression(const FunctionExpression &that);
@@ -78,6 +90,11 @@ public:
   value_impl(const Eigen::Ref<const Eigen::VectorXd> _domain_points,
              Eigen::Ref<Eigen::MatrixXd> _result) const override {
 
+    if (type_ == CONCATENATION) {
+      eval_concat_functions(function_array_, domain_break_points_,
+                            _domain_points, _result);
+      return;
+    }
     eval_operation_(function_array_, _domain_points, _result);
   };
 
@@ -129,9 +146,13 @@ public:
   virtual FunctionExpression concat(const FunctionExpression &that) && override;
   virtual FunctionExpression concat(FunctionExpression &&that) && override;
 
+  /// Appends that to this sum, in place. The cost of each call does not
+  /// depend on the number of terms already in the sum.
   void operator+=(FunctionExpression &&that);
   void operator+=(const FunctionExpression &that);
 
+  /// Appends that to this product, in place. As the first factor is the
+  /// vector valued one, that cannot have a larger codomain than this.
   void operator*=(FunctionExpression &&that);
   void operator*=(const FunctionExpression &that);
 
@@ -141,8 +162,44 @@ public:
 
   std::vector<std::pair<double, double>> get_arg_domains() const;
 
+  /**
+   * @brief Lowers the expression into a flat evaluation plan, see
+   * CompiledExpression (gsplines/Functions/CompiledExpression.hpp). Equal
+   * subexpressions are shared in the plan only; this tree keeps its copies.
+   */
+  CompiledExpression compile() const &;
+  CompiledExpression compile() &&;
+
+  /**
+   * @brief Returns an equivalent expression with fewer nodes.
+   *
+   * Constant terms and factors are folded into a single ConstFunction, zero
+   * terms are removed, products by zero become zero, negations are moved
+   * out of products and cancelled in pairs, and GSplines of the same vector
+   * space are summed, or scaled by constant factors, into one GSpline.
+   * Products and compositions of GSplines of polynomial bases are computed
+   * exactly as one GSpline, see gspline_product and gspline_composition.
+   * Nested sums, products and compositions are flattened.
+   */
+  FunctionExpression simplify() const;
+
+  /// Number of nodes of the expression tree, leaves included
+  std::size_t get_number_of_nodes() const;
+
+  /// True if _that is an expression of the same type whose children are the
+  /// same functions, in the same order
+  bool is_same_function(const FunctionBase &_that) const override;
+
   void initialize();
 
+private:
+  /// Appends _that to the operands, turning this into an operation of type
+  /// _type if it is not one already
+  void append_in_place(const FunctionExpression &_that, Type _type);
+  void append_in_place(FunctionExpression &&_that, Type _type);
+
+public:
+
   virtual ~FunctionExpression() = default;
 
   std::unique_ptr<FunctionExpression> deriv(std::size_t _deg = 1) const {
@@ -158,22 +215,46 @@ protected:
   }
 
 public:
-  static std::list<std::unique_ptr<FunctionBase>>
+  /**
+   * @brief Concatenation of the functions of _function_array, in order.
+   *
+   * Consecutive GSplines of the same basis and codomain are fused into one
+   * GSpline. If a single function remains, it is wrapped as UNIQUE.
+   */
+  static FunctionExpression concatenation(std::pair<double, double> _domain,
+                                          std::size_t _codom_dim,
+                                          FunctionArray &&_function_array);
+
+  /// Appends _operand to the operands _result of an operation of type
+  /// _opt_type. The children of _operand are spliced when it is UNIQUE or of
+  /// type _opt_type.
+  static void append_operand(const FunctionExpression &_operand,
+                             FunctionExpression::Type _opt_type,
+                             FunctionArray &_result);
+
+  /// As above, but moving the children of _operand. If _result is empty, it
+  /// takes the children array of _operand, so that chaining
+  /// std::move(a) + b does not move the terms of a one by one.
+  static void append_operand(FunctionExpression &&_operand,
+                             FunctionExpression::Type _opt_type,
+                             FunctionArray &_result);
+
+  static FunctionArray
   const_const_operation_handler(const FunctionExpression &_first,
                                 const FunctionExpression &_second,
                                 FunctionExpression::Type _opt_type);
 
-  static std::list<std::unique_ptr<FunctionBase>>
+  static FunctionArray
   const_nonconst_operation_handler(const FunctionExpression &_first,
                                    FunctionExpression &&_second,
                                    FunctionExpression::Type _opt_type);
 
-  static std::list<std::unique_ptr<FunctionBase>>
+  static FunctionArray
   nonconst_const_operation_handler(FunctionExpression &&_first,
                                    const FunctionExpression &_second,
                                    FunctionExpression::Type _opt_type);
 
-  static std::list<std::unique_ptr<FunctionBase>>
+  static FunctionArray
   nonconst_nonconst_operation_handler(FunctionExpression &&_first,
                                       FunctionExpression &&_second,
                                       FunctionExpression::Type _opt_type);
@@ -183,58 +264,47 @@ FunctionExpression operator*(double, const FunctionExpression &);
 FunctionExpression operator*(double, FunctionExpression &&);
 
 void eval_unique_functions(
-    const std::list<std::unique_ptr<FunctionBase>> &_function_array,
+    const FunctionArray &_function_array,
     const Eigen::Ref<const Eigen::VectorXd> _domain_points,
     Eigen::Ref<Eigen::MatrixXd> _result);
 
 void eval_sum_functions(
-    const std::list<std::unique_ptr<FunctionBase>> &_function_array,
+    const FunctionArray &_function_array,
     const Eigen::Ref<const Eigen::VectorXd> _domain_points,
     Eigen::Ref<Eigen::MatrixXd> _result);
 
 void eval_mul_functions(
-    const std::list<std::unique_ptr<FunctionBase>> &_function_array,
+    const FunctionArray &_function_array,
     const Eigen::Ref<const Eigen::VectorXd> _domain_points,
     Eigen::Ref<Eigen::MatrixXd> _result);
 
 void eval_compose_functions(
-    const std::list<std::unique_ptr<FunctionBase>> &_function_array,
-    const Eigen::Ref<const Eigen::VectorXd> _domain_points,
-    Eigen::Ref<Eigen::MatrixXd> _result);
-
-void eval_concat_functions(
-    const std::list<std::unique_ptr<FunctionBase>> &_function_array,
+    const FunctionArray &_function_array,
     const Eigen::Ref<const Eigen::VectorXd> _domain_points,
     Eigen::Ref<Eigen::MatrixXd> _result);
 
 void eval_negative_functions(
-    const std::list<std::unique_ptr<FunctionBase>> &_function_array,
+    const FunctionArray &_function_array,
     const Eigen::Ref<const Eigen::VectorXd> _domain_points,
     Eigen::Ref<Eigen::MatrixXd> _result);
 
 FunctionExpression *deriv_unique_functions(
-    const std::list<std::unique_ptr<FunctionBase>> &_function_array,
-    std::size_t _deg);
+    const FunctionArray &_function_array, std::size_t _deg);
 
 FunctionExpression *deriv_sum_functions(
-    const std::list<std::unique_ptr<FunctionBase>> &_function_array,
-    std::size_t _deg);
+    const FunctionArray &_function_array, std::size_t _deg);
 
 FunctionExpression *deriv_mul_functions(
-    const std::list<std::unique_ptr<FunctionBase>> &_function_array,
-    std::size_t _deg);
+    const FunctionArray &_function_array, std::size_t _deg);
 
 FunctionExpression *deriv_compose_functions(
-    const std::list<std::unique_ptr<FunctionBase>> &_function_array,
-    std::size_t _deg);
+    const FunctionArray &_function_array, std::size_t _deg);
 
 FunctionExpression *deriv_concat_functions(
-    const std::list<std::unique_ptr<FunctionBase>> &_function_array,
-    std::size_t _deg);
+    const FunctionArray &_function_array, std::size_t _deg);
 
 FunctionExpression *deriv_negative_functions(
-    const std::list<std::unique_ptr<FunctionBase>> &_function_array,
-    std::size_t _deg);
+    const FunctionArray &_function_array, std::size_t _deg);
 
 } // namespace functions
 } // namespace gsplines
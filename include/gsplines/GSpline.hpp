@@ -18,10 +18,12 @@
 
 namespace gsplines {
 class SobolevNorm;
+class Interpolator;
 
 class GSplineBase : public functions::FunctionInheritanceHelper<
                         GSplineBase, functions::Function, GSplineBase> {
   friend SobolevNorm;
+  friend Interpolator;
   template <typename Current, typename Base>
   friend class GSplineInheritanceHelper;
 
@@ -64,6 +66,19 @@ class GSplineBase : public functions::FunctionInheritanceHelper<
 
   Eigen::MatrixXd get_waypoints() const;
 
+  /**
+   * @brief Maximum over the domain of the absolute value of the derivative
+   * of order _deg of each component.
+   *
+   * For the polynomial bases (Legendre and Lagrange) the maximum of each
+   * segment is exact: it is attained at the end points of the window or at a
+   * real root of the next derivative, which are found as the eigenvalues of
+   * its companion matrix. For other bases the derivative is sampled with
+   * step _dt.
+   */
+  Eigen::VectorXd max_abs_derivative(std::size_t _deg,
+                                     double _dt = 0.01) const;
+
   virtual ~GSplineBase() = default;
   const Eigen::VectorXd& get_coefficients() const { return coefficients_; }
 
@@ -81,12 +96,28 @@ class GSplineBase : public functions::FunctionInheritanceHelper<
 
   const basis::Basis& get_basis() const { return *basis_; }
 
+  /// True if the basis spans polynomials on the window, i.e. it is a
+  /// Legendre or a Lagrange basis
+  bool has_polynomial_basis() const;
+
   bool same_vector_space(const GSplineBase& _that) const;
 
+  /**
+   * @brief Appends the intervals of _that, which must have the same basis
+   * and codomain dimension and start where this GSpline ends.
+   *
+   * The coefficients are resized in place, so the ones already stored are
+   * not copied when the allocator can extend their block. Appending N pieces
+   * one by one is then linear in N.
+   */
+  void append(const GSplineBase& _that);
+
   bool operator==(const GSplineBase& _that) const;
 
   bool operator!=(const GSplineBase& _that) const;
 
+  bool is_same_function(const FunctionBase& _that) const override;
+
  protected:
   GSplineBase* deriv_impl(std::size_t unused_degree) const override {
     (void)unused_degree;
@@ -218,7 +249,7 @@ class GSplineInheritanceHelper
       throw std::invalid_argument("Cannot sum Incompatible Gspline");
     }
     Base::coefficients_ += that.coefficients_;
-    return *this;
+    return static_cast<Current&>(*this);
   }
 
   Current& operator-=(const Current& that) {
@@ -227,7 +258,7 @@ class GSplineInheritanceHelper
     }
 
     Base::coefficients_ -= that.coefficients_;
-    return *this;
+    return static_cast<Current&>(*this);
   }
 
   Current linear_scaling_new_execution_time(double _new_exec_time) const {
@@ -292,46 +323,36 @@ class GSplineInheritanceHelper
     if (_dt < 1.0e-8) {
       throw std::invalid_argument("dt cannot be negative or too small");
     }
-    if (_velocity_bound.value().size() != this->get_codom_dim() ||
-        _acceleration_bound.value().size() != this->get_codom_dim()) {
+    if ((_velocity_bound.has_value() &&
+         _velocity_bound.value().size() != this->get_codom_dim()) ||
+        (_acceleration_bound.has_value() &&
+         _acceleration_bound.value().size() != this->get_codom_dim())) {
       throw std::invalid_argument(
           "Bounds for velocity and acceleration must correspont to codom dim");
     }
 
-    std::size_t number_of_segments = this->get_domain_length() / _dt;
-    const double t0 = this->get_domain().first;
-    const double t1 = this->get_domain().second;
-    const Eigen::VectorXd time_spam = Eigen::VectorXd::LinSpaced(
-        static_cast<long>(number_of_segments) + 1, t0, t1);
-
-    const gsplines::functions::FunctionExpression gspline_diff_1 =
-        this->derivate();
-    const gsplines::functions::FunctionExpression gspline_diff_2 =
-        gspline_diff_1.derivate();
-
-    Eigen::MatrixXd gspline_diff_1_evaluated = gspline_diff_1(time_spam);
-    Eigen::MatrixXd gspline_diff_2_evaluated = gspline_diff_2(time_spam);
-
-    const Eigen::Map<const Eigen::VectorXd> velocity_bound(
-        _velocity_bound.value().data(),
-        static_cast<long>(_velocity_bound.value().size()));
-    const Eigen::Map<const Eigen::VectorXd> acceleration_bound(
-        _acceleration_bound.value().data(),
-        static_cast<long>(_acceleration_bound.value().size()));
-
-    const double max_velocity_ratio =
-        (gspline_diff_1_evaluated.array().abs().colwise().maxCoeff() /
-         velocity_bound.transpose().array())
-            .maxCoeff();
-
-    const double max_acceleration_ratio =
-        Eigen::sqrt(
-            gspline_diff_2_evaluated.array().abs().colwise().maxCoeff() /
-            acceleration_bound.transpose().array())
-            .maxCoeff();
-
-    const double time_scale_factor =
-        std::max(max_velocity_ratio, max_acceleration_ratio);
+    double time_scale_factor = 0.0;
+
+    if (_velocity_bound.has_value()) {
+      const Eigen::Map<const Eigen::VectorXd> velocity_bound(
+          _velocity_bound.value().data(),
+          static_cast<long>(_velocity_bound.value().size()));
+      const double max_velocity_ratio =
+          (this->max_abs_derivative(1, _dt).array() / velocity_bound.array())
+              .maxCoeff();
+      time_scale_factor = std::max(time_scale_factor, max_velocity_ratio);
+    }
+
+    if (_acceleration_bound.has_value()) {
+      const Eigen::Map<const Eigen::VectorXd> acceleration_bound(
+          _acceleration_bound.value().data(),
+          static_cast<long>(_acceleration_bound.value().size()));
+      const double max_acceleration_ratio =
+          Eigen::sqrt(this->max_abs_derivative(2, _dt).array() /
+                      acceleration_bound.array())
+              .maxCoeff();
+      time_scale_factor = std::max(time_scale_factor, max_acceleration_ratio);
+    }
 
     Eigen::VectorXd new_domain_interva_lengths =
         Base::domain_interval_lengths_ * time_scale_factor;
@@ -385,6 +406,38 @@ GSpline operator*(GSpline&& _that, double _a);
 GSpline operator-(const GSpline& _that);
 GSpline operator-(GSpline&& _that);
 
+/**
+ * @brief Product of two GSplines of polynomial bases, as a GSpline.
+ *
+ * The result is exact: its breakpoints are the union of the breakpoints of
+ * both and its basis has the degree of the product, of the family of the
+ * basis of _lhs (Lagrange bases are replaced by Gauss-Lobatto ones). As in a
+ * product expression, at most one of the factors is vector valued.
+ */
+GSpline gspline_product(const GSplineBase& _lhs, const GSplineBase& _rhs);
+
+/**
+ * @brief Composition _outer(_inner(t)) of two GSplines of polynomial bases,
+ * as a GSpline.
+ *
+ * _inner is scalar and its range must lie in the domain of _outer. The
+ * breakpoints of the result are those of _inner and the points where _inner
+ * crosses a breakpoint of _outer, found as roots of the polynomials of
+ * _inner, so the result is exact.
+ */
+GSpline gspline_composition(const GSplineBase& _outer,
+                            const GSplineBase& _inner);
+
+/**
+ * @brief GSpline equal to _first on its domain, followed by _second.
+ *
+ * Both must have the same basis and codomain dimension, and _second must
+ * start where _first ends. The intervals and coefficients of both are
+ * joined, so evaluation walks a single GSpline.
+ */
+GSpline gspline_concatenation(const GSplineBase& _first,
+                              const GSplineBase& _second);
+
 GSpline random_gspline(std::pair<double, double> _domain,
                        std::size_t _codom_dim);
 
@@ -1,10 +1,25 @@
 #ifndef INTERPOLATOR_H
 #define INTERPOLATOR_H
 #include <eigen3/Eigen/SparseCore>
+#include <eigen3/Eigen/SparseLU>
 #include <gsplines/Basis/Basis.hpp>
 #include <gsplines/GSpline.hpp>
+#include <vector>
 
 namespace gsplines {
+
+/// Accumulated wall-clock time [s] of the phases of the interpolation, see
+/// Interpolator::set_timings
+struct InterpolationTimings {
+  /// Filling the interpolating matrix
+  double assembly = 0.0;
+  /// Sparse LU factorization of the interpolating matrix
+  double factorization = 0.0;
+  /// Filling the interpolating vector and the triangular solves
+  double solve = 0.0;
+  std::size_t factorizations = 0;
+};
+
 class Interpolator {
 private:
   Interpolator(const Interpolator &that);
@@ -25,9 +40,42 @@ private:
   Eigen::MatrixXd
       derivative_buffer_tranposed_; // this is (basis.dim - 2) \times basis.dim
   std::vector<Eigen::SparseMatrix<double>> interpolation_matrix_ders_;
+  std::vector<Eigen::SparseMatrix<double>> interpolation_matrix_second_ders_;
   Eigen::VectorXd position_buffer_; // this is basis.dim vector
   Eigen::VectorXi nnz_vec_;
   Eigen::VectorXd sol_buffer_;
+  /// LU factorization of the interpolating matrix. The sparsity pattern does
+  /// not depend on the interval lengths, so it is analyzed only once.
+  Eigen::SparseLU<Eigen::SparseMatrix<double>> solver_;
+  bool pattern_analyzed_;
+  /// Interval lengths at which solver_ holds a valid factorization
+  Eigen::VectorXd factorized_interval_lengths_;
+  /// Right hand sides and solutions of the batch interpolation, one column per
+  /// set of waypoints
+  Eigen::MatrixXd batch_rhs_buffer_;
+  Eigen::MatrixXd batch_sol_buffer_;
+  /// Factorization of the transposed interpolating matrix, computed only
+  /// when adjoint variables are required
+  Eigen::SparseMatrix<double> transposed_matrix_;
+  Eigen::SparseLU<Eigen::SparseMatrix<double>> transposed_solver_;
+  bool transposed_pattern_analyzed_;
+  Eigen::VectorXd transposed_factorized_interval_lengths_;
+  Eigen::VectorXd transposed_sol_buffer_;
+  /// Workspace of solve_factorized
+  Eigen::VectorXd solve_buffer_;
+  InterpolationTimings *timings_ = nullptr;
+
+  void fill_interpolating_vector(
+      const Eigen::Ref<const Eigen::MatrixXd> _waypoints,
+      Eigen::Ref<Eigen::VectorXd> _vector) const;
+
+  /**
+   * @brief Solves the interpolating system with the current factorization.
+   * The only allocation is the workspace of the supernodal forward
+   * substitution of Eigen. _result may alias _rhs.
+   */
+  void solve_factorized(const Eigen::Ref<const Eigen::VectorXd> _rhs,
+                        Eigen::Ref<Eigen::VectorXd> _result);
 
 public:
   Interpolator(std::size_t _codom_dim, std::size_t _num_intervals,
@@ -39,6 +87,70 @@ public:
   fill_interpolating_vector(const Eigen::Ref<const Eigen::MatrixXd> _waypoints);
   GSpline interpolate(const Eigen::Ref<const Eigen::VectorXd> _interval_lengths,
                       const Eigen::Ref<const Eigen::MatrixXd> _waypoints);
+  /**
+   * @brief Interpolates the waypoints and stores the result in an existing
+   * GSpline, which must have the same codomain dimension, number of
+   * intervals and basis as this interpolator. If the interval lengths match
+   * the current factorization, the matrix is not refactorized and the only
+   * heap allocation is the one of solve_factorized, once per call. A solve
+   * without any heap allocation is not provided.
+   */
+  void interpolate(const Eigen::Ref<const Eigen::VectorXd> _interval_lengths,
+                   const Eigen::Ref<const Eigen::MatrixXd> _waypoints,
+                   GSpline &_result);
+  /**
+   * @brief Interpolates several sets of waypoints sharing the same interval
+   * lengths. The interpolating matrix is factorized once and all the right
+   * hand sides are solved in a single multi-column solve.
+   *
+   * @param _interval_lengths interval lengths common to all the problems
+   * @param _waypoints_batch each element is a (num_intervals + 1) x codom_dim
+   * matrix of waypoints
+   * @return one GSpline per set of waypoints, in the same order
+   */
+  std::vector<GSpline> interpolate_batch(
+      const Eigen::Ref<const Eigen::VectorXd> _interval_lengths,
+      const std::vector<Eigen::MatrixXd> &_waypoints_batch);
+
+  const Eigen::Ref<const Eigen::MatrixXd> solve_interpolation_batch(
+      const Eigen::Ref<const Eigen::VectorXd> _interval_lengths,
+      const std::vector<Eigen::MatrixXd> &_waypoints_batch);
+  /**
+   * @brief Fills and factorizes the interpolating matrix. If the matrix was
+   * already factorized at the same interval lengths, nothing is done.
+   *
+   * @return true if the factorization is valid
+   */
+  bool factorize_interpolating_matrix(
+      const Eigen::Ref<const Eigen::VectorXd> _interval_lengths);
+  /**
+   * @brief Changes the length of a single interval of the last factorized
+   * interpolating matrix. Only the columns of the modified interval are
+   * re-assembled. The numeric factorization is then recomputed in full,
+   * reusing the symbolic analysis of the sparsity pattern: a low-rank
+   * correction of the previous factorization needs basis_dim * codom_dim
+   * extra solves and is slower, see BM_WoodburyUpdate in
+   * benchmarks/interpolator.cpp.
+   *
+   * @return true if the factorization is valid
+   */
+  bool update_interval_length(std::size_t _interval, double _interval_length);
+  /**
+   * @brief Interval lenghts of the current factorization, empty if the
+   * interpolating matrix has not been factorized.
+   */
+  const Eigen::VectorXd &get_factorized_interval_lengths() const {
+    return factorized_interval_lengths_;
+  }
+  /**
+   * @brief Accumulate the time spent in each phase of the interpolation in
+   * *_timings. Pass nullptr to stop timing.
+   */
+  void set_timings(InterpolationTimings *_timings) { timings_ = _timings; }
+  /// Interpolating matrix filled at the last interval lengths
+  const Eigen::SparseMatrix<double> &get_interpolating_matrix() const {
+    return interpolating_matrix_;
+  }
   void print_interpolating_matrix();
   void print_interpolating_vector();
 
@@ -55,6 +167,38 @@ public:
 
   void fill_buffers_deriv_wrt_tau(double s, double tau);
 
+  void fill_buffers_second_deriv_wrt_tau(double s, double tau);
+
+  /**
+   * @brief Fills the columns of _mat associated to the coefficients of the
+   * interval _interval, i.e., the rows of that interval and the continuity
+   * rows shared with its neighbours.
+   *
+   * @param _tau_deriv_order order of the derivative of these columns with
+   * respect to the length of the interval (0, 1 or 2).
+   */
+  void fill_interval_block(std::size_t _interval, double _interval_length,
+                           std::size_t _tau_deriv_order,
+                           Eigen::SparseMatrix<double> &_mat);
+
+  /**
+   * @brief Derivative of the interpolating matrix with respect to the length
+   * of the interval _tau_idx. Only the columns of that interval are non-zero.
+   *
+   * @param _order 1 or 2
+   */
+  const Eigen::SparseMatrix<double> &get_interpolating_matrix_derivative_wrt_tau(
+      Eigen::Ref<const Eigen::VectorXd> _interval_lengths, std::size_t _tau_idx,
+      std::size_t _order = 1);
+
+  /**
+   * @brief Solves the transposed interpolating system A(tau)^T x = _rhs, used
+   * to compute adjoint variables.
+   */
+  const Eigen::Ref<const Eigen::VectorXd>
+  solve_transposed(const Eigen::Ref<const Eigen::VectorXd> _interval_lengths,
+                   const Eigen::Ref<const Eigen::VectorXd> _rhs);
+
   Eigen::Ref<const Eigen::VectorXd> get_coeff_derivative_wrt_tau(
       Eigen::Ref<const Eigen::VectorXd> _coeff,
       Eigen::Ref<const Eigen::VectorXd> _interval_lengths,
@@ -63,12 +207,47 @@ public:
   const Eigen::Ref<const Eigen::VectorXd>
   solve_interpolation(const Eigen::Ref<const Eigen::VectorXd> _interval_lengths,
                       const Eigen::Ref<const Eigen::MatrixXd> _waypoints);
+  /**
+   * @brief Computes the coefficients of the interpolating GSpline and writes
+   * them into _result, of size matrix_size. If the interval lengths match
+   * the current factorization, the matrix is not refactorized and the only
+   * heap allocation is the one of solve_factorized, once per call. A solve
+   * without any heap allocation is not provided.
+   */
+  void solve_interpolation(
+      const Eigen::Ref<const Eigen::VectorXd> _interval_lengths,
+      const Eigen::Ref<const Eigen::MatrixXd> _waypoints,
+      Eigen::Ref<Eigen::VectorXd> _result);
 };
 
 GSpline interpolate(const Eigen::Ref<const Eigen::VectorXd> _interval_lengths,
                     const Eigen::Ref<const Eigen::MatrixXd> _waypoints,
                     const basis::Basis &_basis);
 
+std::vector<GSpline>
+interpolate_batch(const Eigen::Ref<const Eigen::VectorXd> _interval_lengths,
+                  const std::vector<Eigen::MatrixXd> &_waypoints_batch,
+                  const basis::Basis &_basis);
+
+/**
+ * @brief Solves independent interpolation problems concurrently.
+ *
+ * The problems are distributed over a pool of worker threads. Each worker
+ * owns a copy of the basis and its own Interpolator workspaces, so no mutable
+ * state is shared between threads.
+ *
+ * @param _interval_lengths interval lengths of each problem
+ * @param _waypoints waypoints of each problem
+ * @param _basis basis used for all the problems
+ * @param _num_threads number of worker threads. If zero, use the number of
+ * hardware threads
+ * @return the interpolating GSplines, in the same order as the problems
+ */
+std::vector<GSpline>
+interpolate_many(const std::vector<Eigen::VectorXd> &_interval_lengths,
+                 const std::vector<Eigen::MatrixXd> &_waypoints,
+                 const basis::Basis &_basis, std::size_t _num_threads = 0);
+
 GSpline pw_polynomial_interpolation(
     const Eigen::Ref<const Eigen::VectorXd> _interval_lengths,
     const Eigen::Ref<const Eigen::MatrixXd> _waypoints, std::size_t _nc);
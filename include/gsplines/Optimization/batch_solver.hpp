@@ -0,0 +1,83 @@
+#ifndef BATCH_SOLVER_H
+#define BATCH_SOLVER_H
+
+#include <eigen3/Eigen/Core>
+#include <gsplines/Basis/Basis.hpp>
+#include <gsplines/GSpline.hpp>
+#include <gsplines/Optimization/ipopt_solver.hpp>
+#include <cstddef>
+#include <optional>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace gsplines {
+
+namespace optimization {
+
+/// Outcome of one problem of a batch
+enum class BatchStatus {
+  SOLVED,      ///< The solver converged
+  NOT_SOLVED,  ///< The solver finished without converging
+  FAILED       ///< The problem threw an exception, see BatchResult::message
+};
+
+struct BatchOptions {
+  SolverBackend backend = SolverBackend::IPOPT;
+  /// Options of the IPOPT backend. Each worker uses its own copy
+  IpoptSolverOptions ipopt_options = IpoptSolverOptions::defaults();
+  /// Number of worker threads. If zero, use the number of hardware threads
+  std::size_t num_threads = 0;
+};
+
+struct BatchResult {
+  BatchStatus status = BatchStatus::FAILED;
+  std::optional<GSpline> solution;
+  /// Exception message if status is BatchStatus::FAILED
+  std::string message;
+  /// Wall-clock time spent on this problem [s]
+  double solve_time = 0.0;
+  /// Index of the worker which solved the problem
+  std::size_t worker = 0;
+};
+
+/**
+ * @brief Solves independent optimal_sobolev_norm problems concurrently.
+ *
+ * The problems are distributed over a pool of worker threads. Each worker
+ * owns a copy of the basis and of the solver options, and every problem
+ * builds its own solver, so no mutable state is shared between threads. An
+ * exception raised by a problem is reported in its result and does not stop
+ * the rest of the batch.
+ *
+ * With the IPOPT backend, several IPOPT solves run at the same time, which
+ * assumes that the linear solver of IPOPT is thread-safe. MUMPS, the
+ * default one, is when IPOPT serializes the calls to it (IPOPT >= 3.14) or
+ * when MUMPS itself was built thread-safe. Otherwise, set num_threads to one
+ * or use the NEWTON backend, which shares no state between threads.
+ *
+ * @param _waypoints waypoints of each problem
+ * @param _basis basis used for all the problems
+ * @param _weights weights of the Sobolev norm used for all the problems
+ * @param _exec_times execution time of each problem
+ * @param _options backend, solver options and number of threads
+ * @return one result per problem, in the same order as the problems
+ */
+std::vector<BatchResult> optimal_sobolev_norm_batch(
+    const std::vector<Eigen::MatrixXd>& _waypoints,
+    const basis::Basis& _basis,
+    const std::vector<std::pair<std::size_t, double>>& _weights,
+    const std::vector<double>& _exec_times,
+    const BatchOptions& _options = BatchOptions());
+
+/**
+ * @brief minimum_jerk_path of each waypoint matrix, solved concurrently. The
+ * solutions have unit execution time.
+ */
+std::vector<BatchResult>
+minimum_jerk_path_batch(const std::vector<Eigen::MatrixXd>& _waypoints,
+                        const BatchOptions& _options = BatchOptions());
+
+}  // namespace optimization
+}  // namespace gsplines
+#endif /* BATCH_SOLVER_H */
@@ -4,10 +4,15 @@
 #define IPOPT_INTERFACE_H
 #include <eigen3/Eigen/Core>
 #include <gsplines/FunctionalAnalysis/Sobolev.hpp>
+#include <gsplines/Optimization/kinematic_constraints.hpp>
 #include <ifopt/constraint_set.h>
 #include <ifopt/cost_term.h>
 #include <ifopt/variable_set.h>
 #include <cstddef>
+#include <memory>
+#include <optional>
+#include <string>
+#include <vector>
 
 namespace gsplines {
 namespace optimization {
@@ -20,9 +25,17 @@ class TimeSegmentLenghtsVar : public ifopt::VariableSet {
 
  public:
   TimeSegmentLenghtsVar(std::size_t _num_intervals, double _exec_time);
+  /**
+   * @brief Starts from the given interval lengths instead of the uniform
+   * ones.
+   */
+  TimeSegmentLenghtsVar(const Eigen::Ref<const Eigen::VectorXd>& _initial_values,
+                        double _exec_time);
   ~TimeSegmentLenghtsVar() override = default;
   void SetVariables(const Eigen::VectorXd& _vec) override;
   [[nodiscard]] Eigen::VectorXd GetValues() const override;
+  /// Interval lengths without copying them
+  [[nodiscard]] const Eigen::VectorXd& GetValuesRef() const { return values_; }
   [[nodiscard]] ifopt::Component::VecBound GetBounds() const override;
 };
 
@@ -38,9 +51,15 @@ class ExecTimeConstraint : public ifopt::ConstraintSet {
 
   ~ExecTimeConstraint() override = default;
 
+ protected:
+  void InitVariableDependedQuantities(const VariablesPtr& _variables) override;
+
  private:
   Eigen::VectorXd values_;
   ifopt::Component::VecBound bounds_;
+  std::shared_ptr<TimeSegmentLenghtsVar> time_var_;
+  /// The Jacobian is constant, a row of ones
+  Jacobian jacobian_;
 };
 
 class SobolevNorm : public ifopt::CostTerm {
@@ -52,16 +71,85 @@ class SobolevNorm : public ifopt::CostTerm {
 
   double GetCost() const override;
   void FillJacobianBlock(std::string var_set, Jacobian& jac) const override;
+  /**
+   * @brief Exact Hessian of the cost with respect to the interval lengths.
+   * The ifopt adapter of IPOPT only forwards first derivatives,
+   * optimal_sobolev_norm passes it to IPOPT when hessian_approximation is
+   * "exact".
+   */
+  void FillHessianBlock(std::string var_set,
+                        Eigen::Ref<Eigen::MatrixXd> hess) const;
+  /// Accumulate the time spent in the evaluations of the cost in *_timings
+  void set_timings(
+      ::gsplines::functional_analysis::SobolevNormTimings* _timings) {
+    sobol_norm_.set_timings(_timings);
+  }
   ~SobolevNorm() override = default;
 
+ protected:
+  void InitVariableDependedQuantities(const VariablesPtr& _variables) override;
+
  private:
   /* data */
   std::unique_ptr<gsplines::basis::Basis> basis_;
   std::vector<std::pair<std::size_t, double>> weights_;
   Eigen::MatrixXd waypoints_;
   mutable ::gsplines::functional_analysis::SobolevNorm sobol_norm_;
-  mutable Eigen::VectorXd buff_1_;
-  mutable Eigen::VectorXd buff_2_;
+  std::shared_ptr<TimeSegmentLenghtsVar> time_var_;
+  /// Dense row with its sparsity already built, only its values are written
+  mutable Jacobian jacobian_;
+};
+
+/**
+ * @brief Sampled velocity and acceleration bounds, -bound <= g(tau) <= bound,
+ * see KinematicConstraints.
+ */
+class KinematicConstraintSet : public ifopt::ConstraintSet {
+ public:
+  KinematicConstraintSet(
+      const Eigen::Ref<const Eigen::MatrixXd>& _waypoints,
+      const gsplines::basis::Basis& _basis, std::size_t _samples_per_interval,
+      const std::optional<std::vector<double>>& _velocity_bounds,
+      const std::optional<std::vector<double>>& _acceleration_bounds);
+
+  [[nodiscard]] Eigen::VectorXd GetValues() const override;
+  [[nodiscard]] ifopt::Component::VecBound GetBounds() const override;
+
+  void FillJacobianBlock(std::string _set_name,
+                         Jacobian& _jac_block) const override;
+
+  ~KinematicConstraintSet() override = default;
+
+ protected:
+  void InitVariableDependedQuantities(const VariablesPtr& _variables) override;
+
+ private:
+  mutable KinematicConstraints constraints_;
+  ifopt::Component::VecBound bounds_;
+  mutable Eigen::VectorXd values_;
+  mutable Eigen::MatrixXd dense_jacobian_;
+  std::shared_ptr<TimeSegmentLenghtsVar> time_var_;
+  /// Dense block with its sparsity already built, so that its structure does
+  /// not change between evaluations
+  mutable Jacobian jacobian_;
+};
+
+/// Execution time, sum of the interval lengths
+class ExecutionTimeCost : public ifopt::CostTerm {
+ public:
+  explicit ExecutionTimeCost(const std::string& _name);
+
+  double GetCost() const override;
+  void FillJacobianBlock(std::string var_set, Jacobian& jac) const override;
+  ~ExecutionTimeCost() override = default;
+
+ protected:
+  void InitVariableDependedQuantities(const VariablesPtr& _variables) override;
+
+ private:
+  std::shared_ptr<TimeSegmentLenghtsVar> time_var_;
+  /// The Jacobian is constant, a row of ones
+  Jacobian jacobian_;
 };
 
 }  // namespace optimization
@@ -5,21 +5,43 @@
 #include <gsplines/GSpline.hpp>
 #include <gsplines/Interpolator.hpp>
 #include <gsplines/Optimization/ipopt_interface.hpp>
+#include <gsplines/Optimization/newton_solver.hpp>
+#include <gsplines/Optimization/solver_statistics.hpp>
 #include <cstddef>
+#include <mutex>
 #include <optional>
+#include <string>
+#include <utility>
+#include <vector>
 
 namespace ifopt {
 class IpoptSolver;
 }
 
+namespace Ipopt {
+class IpoptApplication;
+}
+
 namespace gsplines {
 
 namespace optimization {
 
+/**
+ * @brief Options passed to IPOPT.
+ *
+ * IpoptSolverOptions objects are plain values: they can be copied, modified
+ * with set and passed to optimal_sobolev_norm per call, so concurrent solves
+ * may use different options. A default constructed object holds the library
+ * defaults.
+ *
+ * The static functions operate on the process-wide options used by the
+ * overloads of optimal_sobolev_norm that take no options. They are
+ * serialized by a mutex.
+ */
 class IpoptSolverOptions {
  private:
   static std::optional<IpoptSolverOptions> instance_;
-  IpoptSolverOptions();
+  static std::mutex instance_mutex_;
 
   std::vector<std::pair<std::string, std::string>> string_options_ = {
       {"linear_solver", "mumps"},
@@ -35,11 +57,41 @@ class IpoptSolverOptions {
   std::vector<std::pair<std::string, int>> int_options_ = {{"print_level", 0}};
 
   std::vector<std::pair<std::string, double>> double_options_ = {
-      {"tol", 1.0e-3}};
+      {"tol", 1.0e-3}, {"max_cpu_time", 40.0}};
 
  public:
+  IpoptSolverOptions();
+
+  /// Sets an option of this object, returns *this to chain calls
+  IpoptSolverOptions& set(const std::string& _option_name,
+                          const std::string& _option_value);
+
+  IpoptSolverOptions& set(const std::string& _option_name, int _option_value);
+
+  IpoptSolverOptions& set(const std::string& _option_name,
+                          double _option_value);
+
+  /// Sets the options of this object on the solver
+  void apply(ifopt::IpoptSolver& solver) const;
+
+  /// Sets the options of this object on an IPOPT application
+  void apply(Ipopt::IpoptApplication& _application) const;
+
+  /**
+   * @brief True if hessian_approximation is "exact". Then IPOPT evaluates
+   * the exact Hessian of the Sobolev norm in optimal_sobolev_norm.
+   */
+  [[nodiscard]] bool exact_hessian() const;
+
+  /**
+   * @brief Process-wide options. The reference is not synchronized, prefer
+   * defaults and set_option.
+   */
   static IpoptSolverOptions& instance();
 
+  /// Copy of the process-wide options
+  static IpoptSolverOptions defaults();
+
   static void set_option(const std::string& _option_name,
                          const std::string& _option_value);
 
@@ -50,27 +102,253 @@ class IpoptSolverOptions {
   static void set_options_on_interface(ifopt::IpoptSolver& solver);
 };
 
+/// Solver used to compute the optimal interval lengths
+enum class SolverBackend { IPOPT, NEWTON };
+
 std::optional<gsplines::GSpline> optimal_sobolev_norm(
     const Eigen::Ref<const Eigen::MatrixXd>& _waypoints,
     const gsplines::basis::Basis& _basis,
     const std::vector<std::pair<std::size_t, double>>& _weights,
     double _exec_time);
 
+/**
+ * @brief Same as optimal_sobolev_norm, solving the time allocation problem
+ * with the selected backend. SolverBackend::NEWTON does not build an
+ * ifopt/IPOPT problem, see newton_optimal_interval_lengths.
+ */
+std::optional<gsplines::GSpline> optimal_sobolev_norm(
+    const Eigen::Ref<const Eigen::MatrixXd>& _waypoints,
+    const gsplines::basis::Basis& _basis,
+    const std::vector<std::pair<std::size_t, double>>& _weights,
+    double _exec_time, SolverBackend _backend);
+
+/**
+ * @brief Warm-started optimal_sobolev_norm. The solver starts from
+ * _initial_interval_lengths, e.g. the interval lengths of a previous
+ * solution, which are scaled to sum _exec_time. Hence the interval lengths of
+ * a path returned by the minimum_*_path functions can be passed as they are.
+ *
+ * Only the primal point is warm-started. To warm-start the multipliers of
+ * IPOPT too, see the overload taking an IpoptWarmStart.
+ *
+ * If _statistics is not null, it is filled with the iterations, cost
+ * history, return status and timings of the solve.
+ *
+ * @throws std::invalid_argument if _initial_interval_lengths is not positive
+ * or does not have one entry per interval.
+ */
+std::optional<gsplines::GSpline> optimal_sobolev_norm(
+    const Eigen::Ref<const Eigen::MatrixXd>& _waypoints,
+    const gsplines::basis::Basis& _basis,
+    const std::vector<std::pair<std::size_t, double>>& _weights,
+    double _exec_time,
+    const Eigen::Ref<const Eigen::VectorXd>& _initial_interval_lengths,
+    SolverBackend _backend = SolverBackend::IPOPT,
+    SolverStatistics* _statistics = nullptr);
+
+/**
+ * @brief optimal_sobolev_norm solved by IPOPT with the given options
+ * instead of the process-wide ones.
+ */
+std::optional<gsplines::GSpline> optimal_sobolev_norm(
+    const Eigen::Ref<const Eigen::MatrixXd>& _waypoints,
+    const gsplines::basis::Basis& _basis,
+    const std::vector<std::pair<std::size_t, double>>& _weights,
+    double _exec_time, const IpoptSolverOptions& _options);
+
+/// Warm-started optimal_sobolev_norm solved by IPOPT with the given options
+std::optional<gsplines::GSpline> optimal_sobolev_norm(
+    const Eigen::Ref<const Eigen::MatrixXd>& _waypoints,
+    const gsplines::basis::Basis& _basis,
+    const std::vector<std::pair<std::size_t, double>>& _weights,
+    double _exec_time,
+    const Eigen::Ref<const Eigen::VectorXd>& _initial_interval_lengths,
+    const IpoptSolverOptions& _options,
+    SolverStatistics* _statistics = nullptr);
+
+/**
+ * @brief Primal-dual point of IPOPT for the time allocation problem, to
+ * warm-start the solve of a nearby problem, e.g. after a small displacement
+ * of the waypoints.
+ */
+struct IpoptWarmStart {
+  /// Interval lengths, scaled to sum the execution time of the problem
+  Eigen::VectorXd interval_lengths;
+  /// Multipliers of the lower and upper bounds of the interval lengths. If
+  /// they are empty, only the interval lengths are warm-started.
+  Eigen::VectorXd lower_bound_multipliers;
+  Eigen::VectorXd upper_bound_multipliers;
+  /// Multiplier of the execution time constraint
+  Eigen::VectorXd constraint_multipliers;
+
+  [[nodiscard]] bool has_multipliers() const {
+    return lower_bound_multipliers.size() > 0;
+  }
+};
+
+/**
+ * @brief optimal_sobolev_norm solved by IPOPT from a primal-dual point.
+ *
+ * If _warm_start has multipliers, they are passed to IPOPT as initial
+ * multipliers with warm_start_init_point = yes. Other warm start options,
+ * such as mu_init, are taken from _options. If _solution is not null and
+ * IPOPT converges, it receives the primal-dual solution, to warm-start the
+ * next solve.
+ *
+ * @throws std::invalid_argument if the interval lengths are not valid, see
+ * above, or the multipliers do not have one entry per interval and one per
+ * constraint
+ */
+std::optional<gsplines::GSpline> optimal_sobolev_norm(
+    const Eigen::Ref<const Eigen::MatrixXd>& _waypoints,
+    const gsplines::basis::Basis& _basis,
+    const std::vector<std::pair<std::size_t, double>>& _weights,
+    double _exec_time, const IpoptWarmStart& _warm_start,
+    const IpoptSolverOptions& _options, IpoptWarmStart* _solution = nullptr,
+    SolverStatistics* _statistics = nullptr);
+
+/// Result of optimal_sobolev_norm_anytime
+struct AnytimeSolution {
+  /// Interpolant at the best interval lengths found within the budget
+  gsplines::GSpline curve;
+  /// True if the solver converged within the budget
+  bool converged;
+  /// Norm of the gradient of the cost projected onto the hyperplane
+  /// sum(tau) = exec_time, relative to the norm of the gradient. Zero at a
+  /// stationary point.
+  double suboptimality;
+  /// Wall-clock time of the whole call, including the interpolation of the
+  /// result [s]
+  double elapsed_time;
+};
+
+/**
+ * @brief Anytime optimal_sobolev_norm: solves the problem within a
+ * wall-clock budget and returns the interpolant at the best interval lengths
+ * found so far, which are always positive and sum _exec_time.
+ *
+ * The best iterate is tracked while the solver runs, with the costs the
+ * solver computed, among the iterates whose interval lengths are positive
+ * and sum _exec_time up to a relative tolerance of 1e-6. IPOPT stops at the
+ * first iterate past the budget, which is also passed as max_cpu_time, and
+ * the Newton solver checks it as NewtonSolverOptions::max_wall_time. The
+ * budget is checked once per iteration, and the interpolation of the result
+ * and its suboptimality are computed after it, so the call may overrun it
+ * by one iteration and these two steps.
+ *
+ * @throws std::invalid_argument if _time_budget is not positive or the
+ * initial interval lengths are not valid
+ */
+AnytimeSolution optimal_sobolev_norm_anytime(
+    const Eigen::Ref<const Eigen::MatrixXd>& _waypoints,
+    const gsplines::basis::Basis& _basis,
+    const std::vector<std::pair<std::size_t, double>>& _weights,
+    double _exec_time, double _time_budget,
+    const Eigen::Ref<const Eigen::VectorXd>& _initial_interval_lengths,
+    SolverBackend _backend = SolverBackend::IPOPT);
+
+/// Anytime optimal_sobolev_norm starting from uniform interval lengths
+AnytimeSolution optimal_sobolev_norm_anytime(
+    const Eigen::Ref<const Eigen::MatrixXd>& _waypoints,
+    const gsplines::basis::Basis& _basis,
+    const std::vector<std::pair<std::size_t, double>>& _weights,
+    double _exec_time, double _time_budget,
+    SolverBackend _backend = SolverBackend::IPOPT);
+
+/**
+ * @brief Time-optimal interpolant under velocity and acceleration bounds.
+ *
+ * Minimizes the execution time sum(tau) over the interval lengths, subject
+ * to the bounds sampled at _samples_per_interval points of each interval
+ * (see KinematicConstraints). Unlike scaling the time of a fixed allocation,
+ * the intervals are resized independently. The solver starts from uniform
+ * interval lengths scaled to satisfy the bounds.
+ *
+ * @return the interpolant or std::nullopt if IPOPT did not converge
+ */
+std::optional<gsplines::GSpline> minimum_time_path(
+    const Eigen::Ref<const Eigen::MatrixXd>& _waypoints,
+    const gsplines::basis::Basis& _basis,
+    const std::optional<std::vector<double>>& _velocity_bounds,
+    const std::optional<std::vector<double>>& _acceleration_bounds,
+    std::size_t _samples_per_interval = 10,
+    const IpoptSolverOptions& _options = IpoptSolverOptions::defaults());
+
 std::optional<gsplines::GSpline> broken_lines_path(
     const Eigen::Ref<const Eigen::MatrixXd>& _waypoints);
 
+/// Warm-started broken_lines_path, see optimal_sobolev_norm
+std::optional<gsplines::GSpline> broken_lines_path(
+    const Eigen::Ref<const Eigen::MatrixXd>& _waypoints,
+    const Eigen::Ref<const Eigen::VectorXd>& _initial_interval_lengths);
+
+/// broken_lines_path warm-started from an IpoptWarmStart, see
+/// optimal_sobolev_norm. Its execution time, which is the one of the points
+/// in _solution, is the number of intervals.
+std::optional<gsplines::GSpline> broken_lines_path(
+    const Eigen::Ref<const Eigen::MatrixXd>& _waypoints,
+    const IpoptWarmStart& _warm_start, IpoptWarmStart* _solution = nullptr);
+
 std::optional<gsplines::GSpline> minimum_acceleration_path(
     const Eigen::Ref<const Eigen::MatrixXd>& _waypoints);
 
+/// Warm-started minimum_acceleration_path, see optimal_sobolev_norm
+std::optional<gsplines::GSpline> minimum_acceleration_path(
+    const Eigen::Ref<const Eigen::MatrixXd>& _waypoints,
+    const Eigen::Ref<const Eigen::VectorXd>& _initial_interval_lengths);
+
+/// minimum_acceleration_path warm-started from an IpoptWarmStart, see
+/// optimal_sobolev_norm. Its execution time, which is the one of the points
+/// in _solution, is the number of intervals.
+std::optional<gsplines::GSpline> minimum_acceleration_path(
+    const Eigen::Ref<const Eigen::MatrixXd>& _waypoints,
+    const IpoptWarmStart& _warm_start, IpoptWarmStart* _solution = nullptr);
+
 std::optional<gsplines::GSpline> minimum_jerk_path(
     const Eigen::Ref<const Eigen::MatrixXd>& _waypoints);
 
+/// Warm-started minimum_jerk_path, see optimal_sobolev_norm
+std::optional<gsplines::GSpline> minimum_jerk_path(
+    const Eigen::Ref<const Eigen::MatrixXd>& _waypoints,
+    const Eigen::Ref<const Eigen::VectorXd>& _initial_interval_lengths);
+
+/// minimum_jerk_path warm-started from an IpoptWarmStart, see
+/// optimal_sobolev_norm. Its execution time, which is the one of the points
+/// in _solution, is the number of intervals.
+std::optional<gsplines::GSpline> minimum_jerk_path(
+    const Eigen::Ref<const Eigen::MatrixXd>& _waypoints,
+    const IpoptWarmStart& _warm_start, IpoptWarmStart* _solution = nullptr);
+
 std::optional<gsplines::GSpline> minimum_snap_path(
     const Eigen::Ref<const Eigen::MatrixXd>& _waypoints);
 
+/// Warm-started minimum_snap_path, see optimal_sobolev_norm
+std::optional<gsplines::GSpline> minimum_snap_path(
+    const Eigen::Ref<const Eigen::MatrixXd>& _waypoints,
+    const Eigen::Ref<const Eigen::VectorXd>& _initial_interval_lengths);
+
+/// minimum_snap_path warm-started from an IpoptWarmStart, see
+/// optimal_sobolev_norm. Its execution time, which is the one of the points
+/// in _solution, is the number of intervals.
+std::optional<gsplines::GSpline> minimum_snap_path(
+    const Eigen::Ref<const Eigen::MatrixXd>& _waypoints,
+    const IpoptWarmStart& _warm_start, IpoptWarmStart* _solution = nullptr);
+
 std::optional<gsplines::GSpline> minimum_crackle_path(
     const Eigen::Ref<const Eigen::MatrixXd>& _waypoints);
 
+/// Warm-started minimum_crackle_path, see optimal_sobolev_norm
+std::optional<gsplines::GSpline> minimum_crackle_path(
+    const Eigen::Ref<const Eigen::MatrixXd>& _waypoints,
+    const Eigen::Ref<const Eigen::VectorXd>& _initial_interval_lengths);
+
+/// minimum_crackle_path warm-started from an IpoptWarmStart, see
+/// optimal_sobolev_norm. Its execution time, which is the one of the points
+/// in _solution, is the number of intervals.
+std::optional<gsplines::GSpline> minimum_crackle_path(
+    const Eigen::Ref<const Eigen::MatrixXd>& _waypoints,
+    const IpoptWarmStart& _warm_start, IpoptWarmStart* _solution = nullptr);
+
 std::optional<gsplines::GSpline> best_approximation(
     const functions::FunctionBase& _in, std::size_t _n_glp,
     std::size_t _n_inter);
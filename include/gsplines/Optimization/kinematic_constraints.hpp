@@ -0,0 +1,108 @@
+#ifndef KINEMATIC_CONSTRAINTS_H
+#define KINEMATIC_CONSTRAINTS_H
+
+#include <eigen3/Eigen/Core>
+#include <gsplines/Basis/Basis.hpp>
+#include <gsplines/Interpolator.hpp>
+#include <cstddef>
+#include <memory>
+#include <optional>
+#include <vector>
+
+namespace gsplines {
+namespace optimization {
+
+/**
+ * @brief Velocity and acceleration of the interpolating GSpline sampled at
+ * fixed window points of each interval, as functions of the interval
+ * lengths.
+ *
+ * The samples are taken at the same points s_k of the window [-1, 1] of each
+ * interval, so they move with the interval lengths and their values are
+ * smooth functions of tau. The constraints are |g_r(tau)| <= bound_r.
+ *
+ * Rows are ordered by interval, sample, derivative order (velocity first)
+ * and component.
+ */
+class KinematicConstraints {
+ private:
+  std::unique_ptr<basis::Basis> basis_;
+  std::size_t num_intervals_;
+  std::size_t codom_dim_;
+  Eigen::MatrixXd waypoints_;
+  Interpolator interpolator_;
+  Eigen::VectorXd samples_;
+  /// Derivative orders of the constraints (1 and/or 2) and their bounds
+  std::vector<unsigned int> orders_;
+  std::vector<Eigen::VectorXd> order_bounds_;
+  Eigen::VectorXd bounds_;
+
+  /// Coefficients of the interpolant and their derivatives wrt each interval
+  /// length (one per column), at memo_interval_lengths_
+  Eigen::VectorXd memo_interval_lengths_;
+  Eigen::VectorXd coefficients_;
+  Eigen::MatrixXd coeff_derivatives_;
+  bool coeff_derivatives_valid_ = false;
+
+  Eigen::MatrixXd basis_buffer_;
+  Eigen::MatrixXd basis_deriv_buffer_;
+
+  void update_coefficients(const Eigen::Ref<const Eigen::VectorXd> _tau);
+  /// Rows of basis_buffer_ (and of basis_deriv_buffer_ if _deriv_wrt_tau)
+  /// are the basis derivative of order _order at each sample
+  void eval_basis(double _tau, unsigned int _order, bool _deriv_wrt_tau);
+  std::size_t row(std::size_t _interval, std::size_t _sample,
+                  std::size_t _order_idx) const {
+    return ((_interval * samples_.size() + _sample) * orders_.size() +
+            _order_idx) *
+           codom_dim_;
+  }
+
+ public:
+  /**
+   * @param _waypoints waypoints of the interpolation problem
+   * @param _basis basis of the interpolant
+   * @param _samples_per_interval number of equispaced samples in each
+   * window, including its end points
+   * @param _velocity_bounds bound of the absolute velocity of each component
+   * @param _acceleration_bounds bound of the absolute acceleration of each
+   * component
+   * @throws std::invalid_argument if no bound is given, the bounds are not
+   * positive or do not have one entry per component, or there are less than
+   * two samples
+   */
+  KinematicConstraints(
+      const Eigen::Ref<const Eigen::MatrixXd> _waypoints,
+      const basis::Basis& _basis, std::size_t _samples_per_interval,
+      const std::optional<std::vector<double>>& _velocity_bounds,
+      const std::optional<std::vector<double>>& _acceleration_bounds);
+
+  std::size_t get_number_of_constraints() const { return bounds_.size(); }
+  std::size_t get_number_of_intervals() const { return num_intervals_; }
+
+  /// Bound of the absolute value of each constraint
+  const Eigen::VectorXd& get_bounds() const { return bounds_; }
+
+  /// Sampled velocities and accelerations at the interval lengths _tau
+  void values(const Eigen::Ref<const Eigen::VectorXd> _tau,
+              Eigen::Ref<Eigen::VectorXd> _result);
+
+  /**
+   * @brief Jacobian of the values wrt the interval lengths. The interpolant
+   * couples all the intervals, so it is dense: column j is
+   * B(tau) dy/dtau_j plus, in the rows of interval j, dB/dtau_j y.
+   */
+  void jacobian(const Eigen::Ref<const Eigen::VectorXd> _tau,
+                Eigen::Ref<Eigen::MatrixXd> _result);
+
+  /**
+   * @brief Smallest factor lambda such that the interval lengths
+   * lambda * _tau satisfy the constraints. Scaling the time by lambda
+   * divides the velocities by lambda and the accelerations by lambda^2.
+   */
+  double min_scaling_factor(const Eigen::Ref<const Eigen::VectorXd> _tau);
+};
+
+}  // namespace optimization
+}  // namespace gsplines
+#endif /* KINEMATIC_CONSTRAINTS_H */
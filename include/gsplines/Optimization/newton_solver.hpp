@@ -0,0 +1,66 @@
+#ifndef NEWTON_SOLVER_H
+#define NEWTON_SOLVER_H
+
+#include <eigen3/Eigen/Core>
+#include <gsplines/Basis/Basis.hpp>
+#include <gsplines/Optimization/solver_statistics.hpp>
+#include <cstddef>
+#include <limits>
+#include <optional>
+#include <utility>
+#include <vector>
+
+namespace gsplines {
+
+namespace optimization {
+
+struct NewtonSolverOptions {
+  /// Maximum number of Newton iterations
+  std::size_t max_iter = 100;
+  /// The solver stops when the decrease of the cost predicted by the Newton
+  /// step is smaller than tol times the cost
+  double tol = 1.0e-10;
+  /// Wall-clock budget [s]. The solver stops, without converging, when an
+  /// iteration starts after it is exhausted
+  double max_wall_time = std::numeric_limits<double>::infinity();
+};
+
+/**
+ * @brief Minimizes the Sobolev norm of the interpolating GSpline with respect
+ * to the interval lengths, subject to sum(tau) = _exec_time and tau > 0.
+ *
+ * Newton method on the simplex. The steps are computed with the analytic
+ * gradient and Hessian of the norm, projected onto the hyperplane
+ * sum(tau) = _exec_time, and are shortened to keep the interval lengths
+ * positive. If the basis does not provide second derivatives with respect to
+ * the interval lengths, the Hessian is replaced by a BFGS approximation.
+ *
+ * @param _statistics if not null, filled with the statistics of the solve
+ * @return the optimal interval lengths or std::nullopt if the solver did not
+ * converge, e.g. because the cost or its derivatives are not finite
+ */
+std::optional<Eigen::VectorXd> newton_optimal_interval_lengths(
+    const Eigen::Ref<const Eigen::MatrixXd>& _waypoints,
+    const basis::Basis& _basis,
+    const std::vector<std::pair<std::size_t, double>>& _weights,
+    double _exec_time,
+    const NewtonSolverOptions& _options = NewtonSolverOptions(),
+    SolverStatistics* _statistics = nullptr);
+
+/**
+ * @brief Same as above, starting from _initial_interval_lengths instead of
+ * the uniform interval lengths. The initial guess is scaled to sum
+ * _exec_time.
+ */
+std::optional<Eigen::VectorXd> newton_optimal_interval_lengths(
+    const Eigen::Ref<const Eigen::MatrixXd>& _waypoints,
+    const basis::Basis& _basis,
+    const std::vector<std::pair<std::size_t, double>>& _weights,
+    double _exec_time,
+    const Eigen::Ref<const Eigen::VectorXd>& _initial_interval_lengths,
+    const NewtonSolverOptions& _options = NewtonSolverOptions(),
+    SolverStatistics* _statistics = nullptr);
+
+}  // namespace optimization
+}  // namespace gsplines
+#endif /* NEWTON_SOLVER_H */
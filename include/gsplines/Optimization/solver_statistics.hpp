@@ -0,0 +1,87 @@
+#ifndef SOLVER_STATISTICS_H
+#define SOLVER_STATISTICS_H
+
+#include <eigen3/Eigen/Core>
+#include <gsplines/FunctionalAnalysis/Sobolev.hpp>
+#include <cstddef>
+#include <functional>
+#include <vector>
+
+namespace gsplines {
+
+namespace optimization {
+
+/// Return status of the solvers, same values as IPOPT's
+/// ApplicationReturnStatus
+enum class IpoptReturnStatus : int {
+  Solve_Succeeded = 0,
+  Solved_To_Acceptable_Level = 1,
+  Infeasible_Problem_Detected = 2,
+  Search_Direction_Becomes_Too_Small = 3,
+  Diverging_Iterates = 4,
+  User_Requested_Stop = 5,
+  Feasible_Point_Found = 6,
+
+  Maximum_Iterations_Exceeded = -1,
+  Restoration_Failed = -2,
+  Error_In_Step_Computation = -3,
+  Maximum_CpuTime_Exceeded = -4,
+  Not_Enough_Degrees_Of_Freedom = -10,
+  Invalid_Problem_Definition = -11,
+  Invalid_Option = -12,
+  Invalid_Number_Detected = -13,
+
+  Unrecoverable_Exception = -100,
+  NonIpopt_Exception_Thrown = -101,
+  Insufficient_Memory = -102,
+  Internal_Error = -199
+};
+
+/**
+ * @brief Statistics of one solve of the time allocation problem. The
+ * solvers fill it when a pointer to it is passed, and leave the callback
+ * untouched.
+ */
+struct SolverStatistics {
+  /**
+   * @brief Called with the iteration number, the interval lengths and the
+   * cost of each iterate, starting from the initial point, while the solver
+   * runs. With IPOPT, the cost is the one computed by IPOPT and the iterates
+   * of its restoration phase are skipped.
+   */
+  std::function<void(std::size_t, const Eigen::VectorXd &, double)> callback;
+
+  IpoptReturnStatus return_status = IpoptReturnStatus::Internal_Error;
+  /// Number of iterations (steps) of the solver
+  std::size_t iterations = 0;
+  /// Cost of each iterate, starting from the initial point
+  std::vector<double> cost_history;
+  /// Wall-clock time of the solve [s]
+  double total_time = 0.0;
+  /// Time spent by the solver itself, i.e. total_time minus the evaluations
+  /// of the cost and its derivatives [s]
+  double solver_time = 0.0;
+  /// Time spent in each phase of the evaluations of the cost
+  functional_analysis::SobolevNormTimings cost_timings;
+
+  /// Resets everything but the callback
+  void clear() {
+    return_status = IpoptReturnStatus::Internal_Error;
+    iterations = 0;
+    cost_history.clear();
+    total_time = 0.0;
+    solver_time = 0.0;
+    cost_timings = functional_analysis::SobolevNormTimings();
+  }
+
+  /// Time spent evaluating the cost and its derivatives [s]
+  double cost_time() const {
+    const InterpolationTimings &inter = cost_timings.interpolation;
+    return inter.assembly + inter.factorization + inter.solve +
+           cost_timings.gram + cost_timings.gradient + cost_timings.hessian;
+  }
+};
+
+}  // namespace optimization
+}  // namespace gsplines
+#endif /* SOLVER_STATISTICS_H */
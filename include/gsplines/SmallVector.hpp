@@ -0,0 +1,210 @@
+#ifndef GSPLINES_SMALL_VECTOR_H
+#define GSPLINES_SMALL_VECTOR_H
+
+#include <algorithm>
+#include <cstddef>
+#include <iterator>
+#include <memory>
+#include <new>
+#include <utility>
+
+namespace gsplines {
+namespace tools {
+
+/**
+ * @brief Contiguous sequence which stores up to N elements inside the object
+ * and moves to the heap when it grows beyond that.
+ *
+ * It provides the subset of the interface of std::vector used by the
+ * library. As in std::vector, inserting or erasing invalidates the
+ * iterators, and the ranges passed to insert must not point into the
+ * container itself.
+ */
+template <typename T, std::size_t N> class SmallVector {
+public:
+  typedef T value_type;
+  typedef std::size_t size_type;
+  typedef std::ptrdiff_t difference_type;
+  typedef T &reference;
+  typedef const T &const_reference;
+  typedef T *pointer;
+  typedef const T *const_pointer;
+  typedef T *iterator;
+  typedef const T *const_iterator;
+  typedef std::reverse_iterator<iterator> reverse_iterator;
+  typedef std::reverse_iterator<const_iterator> const_reverse_iterator;
+
+private:
+  alignas(T) unsigned char inline_storage_[N * sizeof(T)];
+  T *data_;
+  std::size_t size_;
+  std::size_t capacity_;
+
+  T *inline_data() { return reinterpret_cast<T *>(inline_storage_); }
+
+  void release() {
+    clear();
+    if (not is_inline()) {
+      ::operator delete(data_);
+    }
+    data_ = inline_data();
+    capacity_ = N;
+  }
+
+  /// Moves the elements of that, which is left empty
+  void steal(SmallVector &&that) {
+    if (that.is_inline()) {
+      reserve(that.size_);
+      std::uninitialized_copy(std::make_move_iterator(that.begin()),
+                              std::make_move_iterator(that.end()), data_);
+      size_ = that.size_;
+      that.clear();
+    } else {
+      data_ = that.data_;
+      size_ = that.size_;
+      capacity_ = that.capacity_;
+      that.data_ = that.inline_data();
+      that.size_ = 0;
+      that.capacity_ = N;
+    }
+  }
+
+public:
+  SmallVector() : data_(inline_data()), size_(0), capacity_(N) {}
+
+  SmallVector(const SmallVector &that) : SmallVector() {
+    reserve(that.size_);
+    std::uninitialized_copy(that.begin(), that.end(), data_);
+    size_ = that.size_;
+  }
+
+  SmallVector(SmallVector &&that) noexcept : SmallVector() {
+    steal(std::move(that));
+  }
+
+  SmallVector &operator=(const SmallVector &that) {
+    if (this != &that) {
+      clear();
+      reserve(that.size_);
+      std::uninitialized_copy(that.begin(), that.end(), data_);
+      size_ = that.size_;
+    }
+    return *this;
+  }
+
+  SmallVector &operator=(SmallVector &&that) noexcept {
+    if (this != &that) {
+      release();
+      steal(std::move(that));
+    }
+    return *this;
+  }
+
+  ~SmallVector() { release(); }
+
+  /// True if the elements are stored inside the object
+  bool is_inline() const {
+    return data_ == reinterpret_cast<const T *>(inline_storage_);
+  }
+
+  std::size_t size() const { return size_; }
+  std::size_t capacity() const { return capacity_; }
+  bool empty() const { return size_ == 0; }
+
+  T *data() { return data_; }
+  const T *data() const { return data_; }
+
+  iterator begin() { return data_; }
+  iterator end() { return data_ + size_; }
+  const_iterator begin() const { return data_; }
+  const_iterator end() const { return data_ + size_; }
+  const_iterator cbegin() const { return data_; }
+  const_iterator cend() const { return data_ + size_; }
+
+  reverse_iterator rbegin() { return reverse_iterator(end()); }
+  reverse_iterator rend() { return reverse_iterator(begin()); }
+  const_reverse_iterator rbegin() const {
+    return const_reverse_iterator(end());
+  }
+  const_reverse_iterator rend() const {
+    return const_reverse_iterator(begin());
+  }
+
+  T &operator[](std::size_t _i) { return data_[_i]; }
+  const T &operator[](std::size_t _i) const { return data_[_i]; }
+
+  T &front() { return data_[0]; }
+  const T &front() const { return data_[0]; }
+  T &back() { return data_[size_ - 1]; }
+  const T &back() const { return data_[size_ - 1]; }
+
+  void reserve(std::size_t _capacity) {
+    if (_capacity <= capacity_) {
+      return;
+    }
+    T *new_data = static_cast<T *>(::operator new(_capacity * sizeof(T)));
+    std::uninitialized_copy(std::make_move_iterator(begin()),
+                            std::make_move_iterator(end()), new_data);
+    const std::size_t size = size_;
+    release();
+    data_ = new_data;
+    size_ = size;
+    capacity_ = _capacity;
+  }
+
+  template <typename... Args> T &emplace_back(Args &&..._args) {
+    if (size_ == capacity_) {
+      reserve(2 * capacity_ + 1);
+    }
+    new (data_ + size_) T(std::forward<Args>(_args)...);
+    return data_[size_++];
+  }
+
+  void push_back(const T &_value) { emplace_back(_value); }
+  void push_back(T &&_value) { emplace_back(std::move(_value)); }
+
+  void pop_back() { data_[--size_].~T(); }
+
+  iterator insert(const_iterator _pos, T &&_value) {
+    const std::ptrdiff_t index = _pos - begin();
+    emplace_back(std::move(_value));
+    std::rotate(begin() + index, end() - 1, end());
+    return begin() + index;
+  }
+
+  iterator insert(const_iterator _pos, const T &_value) {
+    return insert(_pos, T(_value));
+  }
+
+  template <typename InputIt>
+  iterator insert(const_iterator _pos, InputIt _first, InputIt _last) {
+    const std::ptrdiff_t index = _pos - begin();
+    const std::size_t old_size = size_;
+    for (; _first != _last; ++_first) {
+      emplace_back(*_first);
+    }
+    std::rotate(begin() + index, begin() + old_size, end());
+    return begin() + index;
+  }
+
+  iterator erase(const_iterator _first, const_iterator _last) {
+    iterator first = begin() + (_first - begin());
+    iterator new_end = std::move(first + (_last - _first), end(), first);
+    while (end() != new_end) {
+      pop_back();
+    }
+    return first;
+  }
+
+  iterator erase(const_iterator _pos) { return erase(_pos, _pos + 1); }
+
+  void clear() {
+    while (size_ > 0) {
+      pop_back();
+    }
+  }
+};
+
+} // namespace tools
+} // namespace gsplines
+#endif
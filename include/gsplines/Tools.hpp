@@ -1,5 +1,10 @@
 
+#ifndef GSPLINES_TOOLS_H
+#define GSPLINES_TOOLS_H
 #include <Eigen/Core>
+#include <chrono>
+#include <cstddef>
+#include <functional>
 #include <gsplines/GSpline.hpp>
 namespace gsplines {
 namespace tools {
@@ -21,6 +26,53 @@ bool approx_zero(const Eigen::MatrixXd &_rhs, double _tol);
 
 bool approx_zero(const GSplineBase &_rhs, double _tol);
 
+/**
+ * @brief Adds the wall-clock time [s] elapsed during its lifetime to
+ * *_accumulator. Does nothing if _accumulator is null.
+ */
+class ScopedTimer {
+private:
+  double *accumulator_;
+  std::chrono::steady_clock::time_point start_;
+
+public:
+  explicit ScopedTimer(double *_accumulator) : accumulator_(_accumulator) {
+    if (accumulator_ != nullptr) {
+      start_ = std::chrono::steady_clock::now();
+    }
+  }
+  ScopedTimer(const ScopedTimer &) = delete;
+  ScopedTimer &operator=(const ScopedTimer &) = delete;
+  ~ScopedTimer() {
+    if (accumulator_ != nullptr) {
+      *accumulator_ += std::chrono::duration<double>(
+                           std::chrono::steady_clock::now() - start_)
+                           .count();
+    }
+  }
+};
+
+/**
+ * @brief Number of workers for _num_tasks tasks: _num_threads, or the number
+ * of hardware threads if it is zero, and at least one but not more than the
+ * number of tasks.
+ */
+std::size_t worker_count(std::size_t _num_threads, std::size_t _num_tasks);
+
+/**
+ * @brief Runs _task(worker, task) for each task in [0, _num_tasks) on
+ * _num_workers threads, the calling one being worker 0, and returns when all
+ * tasks are done. Tasks are handed out one at a time, so workers which get
+ * short tasks take more of them. _task must not throw.
+ *
+ * Per worker state, such as clones of a basis, is indexed by the worker and
+ * should be created before the call.
+ */
+void parallel_for(
+    std::size_t _num_tasks, std::size_t _num_workers,
+    const std::function<void(std::size_t, std::size_t)> &_task);
+
 } // namespace tools
 
 } // namespace gsplines
+#endif /* GSPLINES_TOOLS_H */
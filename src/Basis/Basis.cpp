@@ -12,6 +12,38 @@ namespace gsplines {
 
 namespace basis {
 
+void Basis::eval_second_derivative_wrt_tau_on_window(
+    double /*_s*/, double /*_tau*/, unsigned int /*_deg*/,
+    Eigen::Ref<Eigen::VectorXd, 0, Eigen::InnerStride<>> /*_buff*/) const {
+  throw std::logic_error("The second derivative wrt tau of the basis " +
+                         get_name() + " is not implemented");
+}
+
+void Basis::add_derivative_matrix_second_deriv_wrt_tau(
+    double /*tau*/, std::size_t /*_deg*/, Eigen::Ref<Eigen::MatrixXd> /*_mat*/) {
+  throw std::logic_error(
+      "The second derivative wrt tau of the derivative matrix of the basis " +
+      get_name() + " is not implemented");
+}
+
+void Basis::polynomial_second_derivative_wrt_tau_on_window(
+    double _s, double _tau, unsigned int _deg,
+    Eigen::Ref<Eigen::VectorXd, 0, Eigen::InnerStride<>> _buff) const {
+  eval_derivative_on_window(_s, _tau, _deg, _buff);
+  _buff *= _deg * (_deg + 1.0) / (_tau * _tau);
+}
+
+void Basis::add_polynomial_derivative_matrix_second_deriv_wrt_tau(
+    double tau, std::size_t _deg, const std::vector<Eigen::MatrixXd> &_blocks,
+    Eigen::Ref<Eigen::MatrixXd> _mat) const {
+  /// The block of degree zero is linear in tau
+  if (_deg == 0 or _deg >= get_dim() + 1) {
+    return;
+  }
+  double scale = 0.5 * _deg * (2.0 * _deg - 1.0) * pow(2.0 / tau, 2 * _deg + 1);
+  _mat.noalias() += _blocks[_deg] * scale;
+}
+
 std::shared_ptr<Basis> get_basis(const std::string& _basis_name,
                                  std::size_t _dim,
                                  const std::vector<double>& _params) {
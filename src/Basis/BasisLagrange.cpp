@@ -43,7 +43,8 @@ BasisLagrange::BasisLagrange(Eigen::Ref<const Eigen::VectorXd> _domain_points)
   Eigen::MatrixXd points_to_glp_matrix(change_interpolation_points(
       _domain_points, collocation::legendre_gauss_lobatto_points(get_dim())));
 
-  Eigen::MatrixXd l2normbase_matrix(get_dim(), get_dim());
+  Eigen::MatrixXd l2normbase_matrix(
+      Eigen::MatrixXd::Zero(get_dim(), get_dim()));
 
   l2normbase_matrix.diagonal() =
       collocation::legendre_gauss_lobatto_weights(get_dim());
@@ -167,6 +168,18 @@ void BasisLagrange::add_derivative_matrix_deriv_wrt_tau(
   }
 }
 
+void BasisLagrange::eval_second_derivative_wrt_tau_on_window(
+    double _s, double _tau, unsigned int _deg,
+    Eigen::Ref<Eigen::VectorXd, 0, Eigen::InnerStride<>> _buff) const {
+  polynomial_second_derivative_wrt_tau_on_window(_s, _tau, _deg, _buff);
+}
+
+void BasisLagrange::add_derivative_matrix_second_deriv_wrt_tau(
+    double tau, std::size_t _deg, Eigen::Ref<Eigen::MatrixXd> _mat) {
+  add_polynomial_derivative_matrix_second_deriv_wrt_tau(
+      tau, _deg, derivative_matrices_buffer_, _mat);
+}
+
 Eigen::VectorXd BasisLagrange::barycentric_weights(
     Eigen::Ref<const Eigen::VectorXd> _points) {
   /*  David A. Kopriva
@@ -150,6 +150,18 @@ void BasisLegendre::add_derivative_matrix_deriv_wrt_tau(
   }
 }
 
+void BasisLegendre::eval_second_derivative_wrt_tau_on_window(
+    double _s, double _tau, unsigned int _deg,
+    Eigen::Ref<Eigen::VectorXd, 0, Eigen::InnerStride<>> _buff) const {
+  polynomial_second_derivative_wrt_tau_on_window(_s, _tau, _deg, _buff);
+}
+
+void BasisLegendre::add_derivative_matrix_second_deriv_wrt_tau(
+    double tau, std::size_t _deg, Eigen::Ref<Eigen::MatrixXd> _mat) {
+  add_polynomial_derivative_matrix_second_deriv_wrt_tau(
+      tau, _deg, derivative_matrices_buffer_, _mat);
+}
+
 Eigen::MatrixXd BasisLegendre::derivative_matrix(std::size_t _dim) {
   Eigen::MatrixXd result(Eigen::MatrixXd::Zero(_dim, _dim));
 
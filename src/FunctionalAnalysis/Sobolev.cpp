@@ -3,6 +3,7 @@
 #include <gsplines/FunctionalAnalysis/Sobolev.hpp>
 #include <gsplines/Functions/ElementalFunctions.hpp>
 #include <gsplines/GSpline.hpp>
+#include <gsplines/Tools.hpp>
 #include <iostream>
 
 namespace gsplines {
@@ -13,16 +14,51 @@ SobolevNorm::SobolevNorm(const Eigen::Ref<const Eigen::MatrixXd> _waypoints,
     : basis_(_basis.clone()), num_intervals_(_waypoints.rows() - 1),
       codom_dim_(_waypoints.cols()),
       interpolator_(codom_dim_, num_intervals_, _basis), weights_(_weights),
-      waypoints_(_waypoints), matrix_(_basis.get_dim(), _basis.get_dim()),
+      waypoints_(_waypoints),
+      memo_gram_blocks_(num_intervals_,
+                        Eigen::MatrixXd(_basis.get_dim(), _basis.get_dim())),
+      memo_value_(0.0), memo_gradient_(num_intervals_),
+      memo_gradient_valid_(false), matrix_(_basis.get_dim(), _basis.get_dim()),
       matrix_2_(_basis.get_dim(), _basis.get_dim()) {}
 
-double SobolevNorm::operator()(
+void SobolevNorm::update_memo(
     const Eigen::Ref<const Eigen::VectorXd> _interval_lengths) {
 
-  const Eigen::Ref<const Eigen::VectorXd> coeff =
+  if (memo_interval_lengths_.size() == _interval_lengths.size() and
+      (memo_interval_lengths_.array() == _interval_lengths.array()).all()) {
+    return;
+  }
+  memo_interval_lengths_.resize(0);
+  memo_gradient_valid_ = false;
+
+  memo_coefficients_ =
       interpolator_.solve_interpolation(_interval_lengths, waypoints_);
 
-  return inner_prod(_interval_lengths, coeff, coeff);
+  tools::ScopedTimer timer(timings_ ? &timings_->gram : nullptr);
+  if (timings_) {
+    timings_->evaluations++;
+  }
+  for (std::size_t interval_coor = 0; interval_coor < num_intervals_;
+       interval_coor++) {
+    Eigen::MatrixXd &block = memo_gram_blocks_[interval_coor];
+    block.setZero();
+    for (std::pair<std::size_t, double> w : weights_) {
+      basis_->add_derivative_matrix(_interval_lengths(interval_coor), w.first,
+                                    block);
+      block *= w.second;
+    }
+  }
+
+  memo_value_ = inner_prod(memo_coefficients_, memo_coefficients_);
+  memo_interval_lengths_ = _interval_lengths;
+}
+
+double SobolevNorm::operator()(
+    const Eigen::Ref<const Eigen::VectorXd> _interval_lengths) {
+
+  update_memo(_interval_lengths);
+
+  return memo_value_;
 }
 
 void SobolevNorm::deriv_wrt_interval_len(
@@ -36,8 +72,17 @@ void SobolevNorm::deriv_wrt_interval_len(
   unsigned int interval_coor;
   unsigned int codom_coor;
   double tau;
-  const Eigen::Ref<const Eigen::VectorXd> coeff =
-      interpolator_.solve_interpolation(_interval_lengths, waypoints_);
+
+  update_memo(_interval_lengths);
+  if (memo_gradient_valid_) {
+    _buff = memo_gradient_;
+    return;
+  }
+  tools::ScopedTimer timer(timings_ ? &timings_->gradient : nullptr);
+  if (timings_) {
+    timings_->gradient_evaluations++;
+  }
+  const Eigen::Ref<const Eigen::VectorXd> coeff = memo_coefficients_;
 
   for (interval_coor = 0; interval_coor < num_intervals_; interval_coor++) {
     double result = 0.0;
@@ -60,34 +105,128 @@ void SobolevNorm::deriv_wrt_interval_len(
                                   interval_coor, codom_coor);
       result += v1.transpose() * matrix_ * v1;
     }
-    result += 2.0 * inner_prod(_interval_lengths, coeff, dy_dtau_i);
-    _buff[interval_coor] = result;
+    result += 2.0 * inner_prod(coeff, dy_dtau_i);
+    memo_gradient_(interval_coor) = result;
   }
+  memo_gradient_valid_ = true;
+  _buff = memo_gradient_;
 }
 
-double SobolevNorm::inner_prod(
+void SobolevNorm::hessian_wrt_interval_len(
     const Eigen::Ref<const Eigen::VectorXd> _interval_lengths,
-    const Eigen::Ref<const Eigen::VectorXd> _v1,
-    const Eigen::Ref<const Eigen::VectorXd> _v2) {
+    Eigen::Ref<Eigen::MatrixXd> _hess) {
+  /* y = coefficients, A(tau) y = b
+   * lambda = A^{-T} Q y (adjoint)
+   * mu_i = - dy_dtau_i = A^{-1} dAdtau_i y
+   * a_i = dQdtau_i y - dAdtau_i^T lambda
+   *
+   * returns H_ij = 2 mu_i^T Q mu_j - 2 (a_i^T mu_j + a_j^T mu_i)
+   *         + delta_ij (y^T d2Qdtau_i y - 2 lambda^T d2Adtau_i y) */
 
-  unsigned int interval_coor;
-  unsigned int codom_coor;
-  double tau;
-  double result = 0.0;
+  const std::size_t block_size = basis_->get_dim() * codom_dim_;
+  const std::size_t basis_dim = basis_->get_dim();
 
-  for (interval_coor = 0; interval_coor < num_intervals_; interval_coor++) {
+  update_memo(_interval_lengths);
+  const Eigen::Ref<const Eigen::VectorXd> coeff = memo_coefficients_;
+  tools::ScopedTimer timer(timings_ ? &timings_->hessian : nullptr);
+  if (timings_) {
+    timings_->hessian_evaluations++;
+  }
+
+  // 1. First order derivatives of the coefficients
+  coeff_derivatives_.resize(coeff.size(), num_intervals_);
+  gram_coeff_derivatives_.resize(coeff.size(), num_intervals_);
+  for (std::size_t i = 0; i < num_intervals_; i++) {
+    coeff_derivatives_.col(i) =
+        -interpolator_.get_coeff_derivative_wrt_tau(coeff, _interval_lengths, i);
+    gram_product(coeff_derivatives_.col(i), gram_coeff_derivatives_.col(i));
+  }
+  _hess.noalias() =
+      2.0 * coeff_derivatives_.transpose() * gram_coeff_derivatives_;
+
+  // 2. Adjoint variables
+  gram_coeff_.resize(coeff.size());
+  gram_product(coeff, gram_coeff_);
+  const Eigen::VectorXd lambda =
+      interpolator_.solve_transposed(_interval_lengths, gram_coeff_);
+
+  // 3. Terms involving the derivatives of A and Q wrt tau_i, which are only
+  // non-zero in the block of the interval i
+  Eigen::VectorXd a_i(block_size);
+  for (std::size_t i = 0; i < num_intervals_; i++) {
+    const double tau = _interval_lengths(i);
     matrix_.setZero();
-    tau = _interval_lengths(interval_coor);
+    matrix_2_.setZero();
     for (std::pair<std::size_t, double> w : weights_) {
-      basis_->add_derivative_matrix(tau, w.first, matrix_);
+      basis_->add_derivative_matrix_deriv_wrt_tau(tau, w.first, matrix_);
+      basis_->add_derivative_matrix_second_deriv_wrt_tau(tau, w.first,
+                                                         matrix_2_);
       matrix_ *= w.second;
+      matrix_2_ *= w.second;
+    }
+    const Eigen::SparseMatrix<double> &d_a =
+        interpolator_.get_interpolating_matrix_derivative_wrt_tau(
+            _interval_lengths, i, 1);
+    const Eigen::VectorXd adjoint_term = d_a.transpose() * lambda;
+    double diagonal = 0.0;
+    for (std::size_t codom_coor = 0; codom_coor < codom_dim_; codom_coor++) {
+      const Eigen::Ref<const Eigen::VectorXd> y = get_coefficient_segment(
+          coeff, *basis_, num_intervals_, codom_dim_, i, codom_coor);
+      const std::size_t offset = i * block_size + codom_coor * basis_dim;
+      a_i.segment(codom_coor * basis_dim, basis_dim).noalias() =
+          matrix_ * y - adjoint_term.segment(offset, basis_dim);
+      diagonal += y.transpose() * matrix_2_ * y;
+    }
+    const Eigen::SparseMatrix<double> &d2_a =
+        interpolator_.get_interpolating_matrix_derivative_wrt_tau(
+            _interval_lengths, i, 2);
+    diagonal -= 2.0 * lambda.dot(d2_a * coeff);
+
+    const Eigen::RowVectorXd a_mu =
+        a_i.transpose() * coeff_derivatives_.middleRows(i * block_size,
+                                                         block_size);
+    _hess.row(i) -= 2.0 * a_mu;
+    _hess.col(i) -= 2.0 * a_mu.transpose();
+    _hess(i, i) += diagonal;
+  }
+}
+
+void SobolevNorm::set_timings(SobolevNormTimings *_timings) {
+  timings_ = _timings;
+  interpolator_.set_timings(_timings ? &_timings->interpolation : nullptr);
+}
+
+void SobolevNorm::gram_product(const Eigen::Ref<const Eigen::VectorXd> _v,
+                               Eigen::Ref<Eigen::VectorXd> _result) const {
+  const std::size_t basis_dim = basis_->get_dim();
+  for (std::size_t interval_coor = 0; interval_coor < num_intervals_;
+       interval_coor++) {
+    const Eigen::MatrixXd &block = memo_gram_blocks_[interval_coor];
+    for (std::size_t codom_coor = 0; codom_coor < codom_dim_; codom_coor++) {
+      const std::size_t offset =
+          (interval_coor * codom_dim_ + codom_coor) * basis_dim;
+      _result.segment(offset, basis_dim).noalias() =
+          block * _v.segment(offset, basis_dim);
     }
+  }
+}
+
+double
+SobolevNorm::inner_prod(const Eigen::Ref<const Eigen::VectorXd> _v1,
+                        const Eigen::Ref<const Eigen::VectorXd> _v2) const {
+
+  unsigned int interval_coor;
+  unsigned int codom_coor;
+  double result = 0.0;
+
+  for (interval_coor = 0; interval_coor < num_intervals_; interval_coor++) {
+    const Eigen::MatrixXd &block = memo_gram_blocks_[interval_coor];
     for (codom_coor = 0; codom_coor < codom_dim_; codom_coor++) {
       const Eigen::Ref<const Eigen::VectorXd> v1 = get_coefficient_segment(
           _v1, *basis_, num_intervals_, codom_dim_, interval_coor, codom_coor);
       const Eigen::Ref<const Eigen::VectorXd> v2 = get_coefficient_segment(
           _v2, *basis_, num_intervals_, codom_dim_, interval_coor, codom_coor);
-      result += v1.transpose() * matrix_ * v2;
+      result += v1.transpose() * block * v2;
     }
   }
 
@@ -0,0 +1,323 @@
+#include <algorithm>
+#include <functional>
+#include <gsplines/Functions/CompiledExpression.hpp>
+#include <gsplines/Functions/ElementalFunctions.hpp>
+#include <map>
+#include <stdexcept>
+#include <tuple>
+#include <typeinfo>
+#include <unordered_map>
+
+namespace gsplines {
+namespace functions {
+
+CompiledExpression::CompiledExpression(const FunctionExpression &_expression)
+    : FunctionInheritanceHelper(_expression.get_domain(),
+                                _expression.get_codom_dim(),
+                                _expression.get_name()),
+      expression_(std::make_unique<FunctionExpression>(_expression)) {
+  compile();
+}
+
+CompiledExpression::CompiledExpression(FunctionExpression &&_expression)
+    : FunctionInheritanceHelper(_expression.get_domain(),
+                                _expression.get_codom_dim(),
+                                _expression.get_name()),
+      expression_(std::make_unique<FunctionExpression>(std::move(_expression))) {
+  compile();
+}
+
+CompiledExpression::CompiledExpression(const CompiledExpression &that)
+    : FunctionInheritanceHelper(that),
+      expression_(std::make_unique<FunctionExpression>(*that.expression_)) {
+  // The tape points to the nodes of the expression, so it is lowered again
+  // from the copy
+  compile();
+}
+
+CompiledExpression::CompiledExpression(CompiledExpression &&that)
+    : FunctionInheritanceHelper(that), expression_(std::move(that.expression_)),
+      tape_(std::move(that.tape_)),
+      register_cols_(std::move(that.register_cols_)),
+      output_register_(that.output_register_),
+      registers_(std::move(that.registers_)), capacity_(that.capacity_) {}
+
+struct CompiledExpression::LoweringState {
+  typedef std::tuple<OpCode, const FunctionBase *, std::vector<std::size_t>>
+      Key;
+
+  std::vector<Instruction> tape;
+  /// Number of columns of each value
+  std::vector<std::size_t> cols;
+  /// Value computed by each operation on its operands
+  std::map<Key, std::size_t> values;
+  /// Leaves which are not the same function as a previous one, by signature
+  std::unordered_multimap<std::size_t, const FunctionBase *> leaves;
+
+  /// First leaf lowered which is the same function as _function
+  const FunctionBase *canonical(const FunctionBase &_function) {
+    const std::size_t hash =
+        typeid(_function).hash_code() ^
+        (std::hash<double>()(_function.get_domain().first) << 1) ^
+        (std::hash<double>()(_function.get_domain().second) << 2) ^
+        (_function.get_codom_dim() << 3);
+    const auto range = leaves.equal_range(hash);
+    for (auto it = range.first; it != range.second; it++) {
+      if (it->second->is_same_function(_function)) {
+        return it->second;
+      }
+    }
+    leaves.emplace(hash, &_function);
+    return &_function;
+  }
+
+  /// Value of _op applied to _operands, emitting its instructions only the
+  /// first time
+  std::size_t emit(OpCode _op, const FunctionBase *_function,
+                   std::size_t _cols, std::vector<std::size_t> &&_operands) {
+    Key key(_op, _function, std::move(_operands));
+    const auto found = values.find(key);
+    if (found != values.end()) {
+      return found->second;
+    }
+    const std::vector<std::size_t> &operands = std::get<2>(key);
+    const std::size_t dest = cols.size();
+    cols.push_back(_cols);
+
+    switch (_op) {
+    case EVAL:
+      tape.push_back({EVAL, _function, dest, operands[0], input_register});
+      break;
+    case DOT:
+      tape.push_back({DOT, nullptr, dest, operands[0], operands[1]});
+      break;
+    case NEG:
+      tape.push_back({COPY, nullptr, dest, operands[0], input_register});
+      tape.push_back({NEG, nullptr, dest, input_register, input_register});
+      break;
+    default:
+      tape.push_back({COPY, nullptr, dest, operands[0], input_register});
+      for (std::size_t k = 1; k < operands.size(); k++) {
+        tape.push_back({_op, nullptr, dest, operands[k], input_register});
+      }
+    }
+    values.emplace(std::move(key), dest);
+    return dest;
+  }
+};
+
+void CompiledExpression::compile() {
+  LoweringState state;
+  const std::size_t output = lower(*expression_, input_register, state);
+  allocate_registers(state, output);
+
+  registers_.clear();
+  for (std::size_t cols : register_cols_) {
+    registers_.emplace_back(0, cols);
+  }
+  capacity_ = 0;
+}
+
+void CompiledExpression::allocate_registers(const LoweringState &_state,
+                                            std::size_t _output) {
+  const std::vector<Instruction> &code = _state.tape;
+
+  // Last instruction which reads or writes each value
+  std::vector<std::size_t> last_use(_state.cols.size(), 0);
+  for (std::size_t i = 0; i < code.size(); i++) {
+    for (std::size_t value : {code[i].dest, code[i].lhs, code[i].rhs}) {
+      if (value != input_register) {
+        last_use[value] = i;
+      }
+    }
+  }
+  last_use[_output] = code.size();
+
+  std::vector<std::size_t> physical(_state.cols.size(), input_register);
+  const auto to_physical = [&physical](std::size_t _value) {
+    return _value == input_register ? input_register : physical[_value];
+  };
+
+  tape_.clear();
+  register_cols_.clear();
+  free_registers_.clear();
+  for (std::size_t i = 0; i < code.size(); i++) {
+    const Instruction &instruction = code[i];
+    if (instruction.op == COPY and last_use[instruction.lhs] == i) {
+      // The copied value is not read anymore, so its register is taken over
+      physical[instruction.dest] = physical[instruction.lhs];
+      continue;
+    }
+    // The destination of an evaluation must not alias its operands, so it is
+    // defined before they are released
+    if (instruction.op == EVAL or instruction.op == COPY or
+        instruction.op == DOT) {
+      physical[instruction.dest] =
+          new_register(_state.cols[instruction.dest]);
+    }
+    tape_.push_back({instruction.op, instruction.function,
+                     physical[instruction.dest], to_physical(instruction.lhs),
+                     to_physical(instruction.rhs)});
+
+    if (instruction.lhs != input_register and last_use[instruction.lhs] == i) {
+      release_register(physical[instruction.lhs]);
+    }
+    if (instruction.rhs != input_register and instruction.rhs != instruction.lhs and
+        last_use[instruction.rhs] == i) {
+      release_register(physical[instruction.rhs]);
+    }
+  }
+  output_register_ = physical[_output];
+  free_registers_.clear();
+}
+
+std::size_t CompiledExpression::new_register(std::size_t _cols) {
+  std::vector<std::size_t>::iterator it =
+      std::find_if(free_registers_.begin(), free_registers_.end(),
+                   [this, _cols](std::size_t _register) {
+                     return register_cols_[_register] == _cols;
+                   });
+  if (it != free_registers_.end()) {
+    const std::size_t result = *it;
+    free_registers_.erase(it);
+    return result;
+  }
+  register_cols_.push_back(_cols);
+  return register_cols_.size() - 1;
+}
+
+void CompiledExpression::release_register(std::size_t _register) {
+  if (_register != input_register) {
+    free_registers_.push_back(_register);
+  }
+}
+
+std::size_t CompiledExpression::lower(const FunctionBase &_function,
+                                      std::size_t _points,
+                                      LoweringState &_state) {
+
+  const FunctionExpression *expression =
+      dynamic_cast<const FunctionExpression *>(&_function);
+  const DotProduct *dot_product = dynamic_cast<const DotProduct *>(&_function);
+
+  if (dot_product != nullptr) {
+    const std::size_t lhs = lower(dot_product->f1_, _points, _state);
+    const std::size_t rhs = lower(dot_product->f2_, _points, _state);
+    return _state.emit(DOT, nullptr, 1, {lhs, rhs});
+  }
+
+  if (expression == nullptr or
+      expression->get_type() == FunctionExpression::CONCATENATION) {
+    return _state.emit(EVAL, _state.canonical(_function),
+                       _function.get_codom_dim(), {_points});
+  }
+
+  const FunctionArray &children = expression->function_array_;
+  std::vector<std::size_t> operands;
+  std::size_t result = input_register;
+
+  switch (expression->get_type()) {
+  case FunctionExpression::UNIQUE:
+    return lower(*children.front(), _points, _state);
+
+  case FunctionExpression::NEGATIVE:
+    operands.push_back(lower(*children.front(), _points, _state));
+    return _state.emit(NEG, nullptr, expression->get_codom_dim(),
+                       std::move(operands));
+
+  case FunctionExpression::SUM:
+  case FunctionExpression::MULTIPLICATION:
+    for (const std::unique_ptr<FunctionBase> &f : children) {
+      operands.push_back(lower(*f, _points, _state));
+    }
+    // Operands are sorted so that reordered sums and products are shared.
+    // The first factor of a product has the largest codomain dimension and
+    // stays first.
+    if (expression->get_type() == FunctionExpression::SUM) {
+      std::sort(operands.begin(), operands.end());
+      return _state.emit(ADD, nullptr, expression->get_codom_dim(),
+                         std::move(operands));
+    }
+    std::sort(std::next(operands.begin()), operands.end());
+    return _state.emit(MUL, nullptr, expression->get_codom_dim(),
+                       std::move(operands));
+
+  case FunctionExpression::COMPOSITION:
+    // The first function is the innermost one
+    result = _points;
+    for (const std::unique_ptr<FunctionBase> &f : children) {
+      result = lower(*f, result, _state);
+    }
+    return result;
+
+  default:
+    throw std::invalid_argument("Function Expression Type not defined");
+  }
+}
+
+void CompiledExpression::reserve(std::size_t _num_points) const {
+  if (static_cast<long>(_num_points) <= capacity_) {
+    return;
+  }
+  capacity_ = static_cast<long>(_num_points);
+  for (std::size_t k = 0; k < registers_.size(); k++) {
+    registers_[k].resize(capacity_, static_cast<long>(register_cols_[k]));
+  }
+}
+
+void CompiledExpression::value_impl(
+    const Eigen::Ref<const Eigen::VectorXd> _domain_points,
+    Eigen::Ref<Eigen::MatrixXd> _result) const {
+
+  const long n = _domain_points.size();
+  reserve(n);
+
+  for (const Instruction &instruction : tape_) {
+    Eigen::Ref<Eigen::MatrixXd> dest =
+        registers_[instruction.dest].topRows(n);
+    switch (instruction.op) {
+    case EVAL:
+      if (instruction.lhs == input_register) {
+        instruction.function->value(_domain_points, dest);
+      } else {
+        instruction.function->value(
+            registers_[instruction.lhs].col(0).head(n), dest);
+      }
+      break;
+    case COPY:
+      dest = registers_[instruction.lhs].topRows(n);
+      break;
+    case ADD:
+      dest += registers_[instruction.lhs].topRows(n);
+      break;
+    case MUL:
+      dest.array().colwise() *=
+          registers_[instruction.lhs].col(0).head(n).array();
+      break;
+    case NEG:
+      dest *= -1.0;
+      break;
+    case DOT:
+      dest.col(0) = (registers_[instruction.lhs].topRows(n).array() *
+                     registers_[instruction.rhs].topRows(n).array())
+                        .rowwise()
+                        .sum();
+      break;
+    }
+  }
+  _result = registers_[output_register_].topRows(n);
+}
+
+FunctionExpression *CompiledExpression::deriv_impl(std::size_t _deg) const {
+  return expression_->deriv(_deg).release();
+}
+
+void CompiledExpression::print(std::size_t _indent) const {
+  FunctionBase::print(_indent);
+  printf("%*s %s  %zu instructions, %zu registers\n", 4 * (int)_indent, "",
+         "Compiled expression", tape_.size(), register_cols_.size());
+  expression_->print(_indent + 1);
+}
+
+} // namespace functions
+} // namespace gsplines
@@ -1,4 +1,5 @@
 #include <gsplines/Functions/ElementalFunctions.hpp>
+#include <gsplines/Functions/EvaluationWorkspace.hpp>
 #include <iostream>
 namespace gsplines {
 namespace functions {
@@ -27,6 +28,11 @@ void ConstFunction::value_impl(
             values_.transpose().array();
 }
 
+bool ConstFunction::is_same_function(const FunctionBase &_that) const {
+  return same_signature(_that) and
+         values_ == static_cast<const ConstFunction &>(_that).values_;
+}
+
 ConstFunction *ConstFunction::deriv_impl(std::size_t _deg) const {
   if (_deg == 0) {
     return new ConstFunction(*this);
@@ -42,6 +48,11 @@ DomainLinearDilation::DomainLinearDilation(std::pair<double, double> _domain,
 DomainLinearDilation::DomainLinearDilation(const DomainLinearDilation &that)
     : FunctionInheritanceHelper(that), dilation_factor_(that.dilation_factor_) {
 }
+bool DomainLinearDilation::is_same_function(const FunctionBase &_that) const {
+  return same_signature(_that) and
+         dilation_factor_ ==
+             static_cast<const DomainLinearDilation &>(_that).dilation_factor_;
+}
 void DomainLinearDilation::value_impl(
     const Eigen::Ref<const Eigen::VectorXd> _domain_points,
     Eigen::Ref<Eigen::MatrixXd> _result) const {
@@ -153,6 +164,16 @@ CanonicPolynomial::CanonicPolynomial(CanonicPolynomial &&that)
     : FunctionInheritanceHelper(std::move(that)),
       coefficients_(std::move(that.coefficients_)) {}
 
+bool CanonicPolynomial::is_same_function(const FunctionBase &_that) const {
+  if (not same_signature(_that)) {
+    return false;
+  }
+  const Eigen::VectorXd &coefficients =
+      static_cast<const CanonicPolynomial &>(_that).coefficients_;
+  return coefficients_.size() == coefficients.size() and
+         coefficients_ == coefficients;
+}
+
 void CanonicPolynomial::value_impl(
     const Eigen::Ref<const Eigen::VectorXd> _domain_points,
     Eigen::Ref<Eigen::MatrixXd> _result) const {
@@ -221,14 +242,27 @@ DotProduct::DotProduct(DotProduct &&_that)
     : FunctionInheritanceHelper(std::move(_that)), f1_(std::move(_that.f1_)),
       f2_(std::move(_that.f2_)) {}
 
+bool DotProduct::is_same_function(const FunctionBase &_that) const {
+  if (not same_signature(_that)) {
+    return false;
+  }
+  const DotProduct &that = static_cast<const DotProduct &>(_that);
+  return f1_.is_same_function(that.f1_) and f2_.is_same_function(that.f2_);
+}
+
 void DotProduct::value_impl(
     const Eigen::Ref<const Eigen::VectorXd> _domain_points,
     Eigen::Ref<Eigen::MatrixXd> _result) const {
 
-  Eigen::MatrixXd f1_res = f1_(_domain_points);
-  Eigen::MatrixXd f2_res = f2_(_domain_points);
+  EvaluationWorkspace &workspace = EvaluationWorkspace::thread_instance();
+  EvaluationWorkspace::Block f1_res(workspace, _domain_points.size(),
+                                    f1_.get_codom_dim());
+  EvaluationWorkspace::Block f2_res(workspace, _domain_points.size(),
+                                    f2_.get_codom_dim());
+  f1_.value(_domain_points, f1_res.matrix);
+  f2_.value(_domain_points, f2_res.matrix);
 
-  _result = (f1_res.array() * f2_res.array()).rowwise().sum();
+  _result = (f1_res.matrix.array() * f2_res.matrix.array()).rowwise().sum();
 }
 
 FunctionExpression *DotProduct::first_deriv_impl(std::size_t _deg) const {
@@ -0,0 +1,191 @@
+#include <cassert>
+#include <cstdio>
+#include <gsplines/Functions/EvaluationProfiler.hpp>
+#include <gsplines/Functions/EvaluationWorkspace.hpp>
+
+namespace gsplines {
+namespace functions {
+
+namespace {
+
+void add_to_summary(const EvaluationProfiler::Node &_node,
+                    std::map<std::string, EvaluationProfiler::Summary> &_result) {
+  EvaluationProfiler::Summary &summary = _result[_node.label];
+  summary.calls += _node.calls;
+  summary.points += _node.points;
+  summary.time += _node.get_self_time();
+  summary.bytes += _node.get_self_bytes();
+  for (const std::unique_ptr<EvaluationProfiler::Node> &child :
+       _node.children) {
+    add_to_summary(*child, _result);
+  }
+}
+
+void print_node(const EvaluationProfiler::Node &_node, std::size_t _indent) {
+  printf("%*s- %s calls = %zu points = %zu time = %.3lf ms self = %.3lf ms "
+         "bytes = %zu\n",
+         4 * (int)_indent, "", _node.label.c_str(), _node.calls, _node.points,
+         1.0e3 * _node.time, 1.0e3 * _node.get_self_time(), _node.bytes);
+  for (const std::unique_ptr<EvaluationProfiler::Node> &child :
+       _node.children) {
+    print_node(*child, _indent + 1);
+  }
+}
+
+void append_json_string(const std::string &_value, std::string &_result) {
+  _result += '"';
+  for (char c : _value) {
+    if (c == '"' or c == '\\') {
+      _result += '\\';
+      _result += c;
+    } else if (static_cast<unsigned char>(c) < 0x20) {
+      // Control characters are not allowed in JSON strings
+      char buffer[8];
+      snprintf(buffer, sizeof(buffer), "\\u%04x",
+               static_cast<unsigned int>(static_cast<unsigned char>(c)));
+      _result += buffer;
+    } else {
+      _result += c;
+    }
+  }
+  _result += '"';
+}
+
+void append_json_children(const EvaluationProfiler::Node &_node,
+                          std::string &_result);
+
+void append_json_node(const EvaluationProfiler::Node &_node,
+                      std::string &_result) {
+  char buffer[256];
+  _result += "{\"label\": ";
+  append_json_string(_node.label, _result);
+  snprintf(buffer, sizeof(buffer),
+           ", \"calls\": %zu, \"points\": %zu, \"time\": %.9g, "
+           "\"self_time\": %.9g, \"bytes\": %zu, \"children\": ",
+           _node.calls, _node.points, _node.time, _node.get_self_time(),
+           _node.bytes);
+  _result += buffer;
+  append_json_children(_node, _result);
+  _result += '}';
+}
+
+void append_json_children(const EvaluationProfiler::Node &_node,
+                          std::string &_result) {
+  _result += '[';
+  for (std::size_t k = 0; k < _node.children.size(); k++) {
+    if (k > 0) {
+      _result += ", ";
+    }
+    append_json_node(*_node.children[k], _result);
+  }
+  _result += ']';
+}
+
+} // namespace
+
+std::atomic<std::size_t> EvaluationProfiler::num_enabled_(0);
+
+double EvaluationProfiler::Node::get_self_time() const {
+  double result = time;
+  for (const std::unique_ptr<Node> &child : children) {
+    result -= child->time;
+  }
+  return result;
+}
+
+std::size_t EvaluationProfiler::Node::get_self_bytes() const {
+  std::size_t result = bytes;
+  for (const std::unique_ptr<Node> &child : children) {
+    result -= child->bytes;
+  }
+  return result;
+}
+
+EvaluationProfiler::Scope::Scope(EvaluationProfiler &_profiler,
+                                 const std::string &_label,
+                                 std::size_t _points)
+    : profiler_(_profiler), parent_(_profiler.current_),
+      workspace_size_(EvaluationWorkspace::thread_instance().get_size()) {
+
+  Node *node = nullptr;
+  for (const std::unique_ptr<Node> &child : parent_->children) {
+    if (child->label == _label) {
+      node = child.get();
+      break;
+    }
+  }
+  if (node == nullptr) {
+    parent_->children.push_back(std::make_unique<Node>());
+    node = parent_->children.back().get();
+    node->label = _label;
+  }
+  node->calls++;
+  node->points += _points;
+  profiler_.current_ = node;
+  start_ = std::chrono::steady_clock::now();
+}
+
+EvaluationProfiler::Scope::~Scope() {
+  Node *node = profiler_.current_;
+  node->time += std::chrono::duration<double>(
+                    std::chrono::steady_clock::now() - start_)
+                    .count();
+  const std::size_t workspace_size =
+      EvaluationWorkspace::thread_instance().get_size();
+  if (workspace_size > workspace_size_) {
+    node->bytes += (workspace_size - workspace_size_) * sizeof(double);
+  }
+  profiler_.current_ = parent_;
+}
+
+EvaluationProfiler::EvaluationProfiler() : current_(&root_) {}
+
+EvaluationProfiler::~EvaluationProfiler() { disable(); }
+
+EvaluationProfiler &EvaluationProfiler::thread_instance() {
+  thread_local EvaluationProfiler result;
+  return result;
+}
+
+void EvaluationProfiler::enable() {
+  if (not enabled_) {
+    enabled_ = true;
+    num_enabled_++;
+  }
+}
+
+void EvaluationProfiler::disable() {
+  if (enabled_) {
+    enabled_ = false;
+    num_enabled_--;
+  }
+}
+
+void EvaluationProfiler::clear() {
+  assert(current_ == &root_);
+  root_.children.clear();
+}
+
+std::map<std::string, EvaluationProfiler::Summary>
+EvaluationProfiler::get_summary() const {
+  std::map<std::string, Summary> result;
+  for (const std::unique_ptr<Node> &child : root_.children) {
+    add_to_summary(*child, result);
+  }
+  return result;
+}
+
+void EvaluationProfiler::print() const {
+  for (const std::unique_ptr<Node> &child : root_.children) {
+    print_node(*child, 0);
+  }
+}
+
+std::string EvaluationProfiler::to_json() const {
+  std::string result;
+  append_json_children(root_, result);
+  return result;
+}
+
+} // namespace functions
+} // namespace gsplines
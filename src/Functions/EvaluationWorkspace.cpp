@@ -0,0 +1,42 @@
+#include <cassert>
+#include <gsplines/Functions/EvaluationWorkspace.hpp>
+
+namespace gsplines {
+namespace functions {
+
+EvaluationWorkspace::Block::Block(EvaluationWorkspace &_workspace, long _rows,
+                                  long _cols)
+    : workspace_(_workspace), matrix(nullptr, _rows, _cols) {
+
+  if (workspace_.used_ == workspace_.buffers_.size()) {
+    workspace_.buffers_.emplace_back();
+  }
+  Eigen::VectorXd &buffer = workspace_.buffers_[workspace_.used_];
+  if (buffer.size() < _rows * _cols) {
+    buffer.resize(_rows * _cols);
+    workspace_.num_growths_++;
+  }
+  workspace_.used_++;
+  new (&matrix) Eigen::Map<Eigen::MatrixXd>(buffer.data(), _rows, _cols);
+}
+
+EvaluationWorkspace &EvaluationWorkspace::thread_instance() {
+  thread_local EvaluationWorkspace result;
+  return result;
+}
+
+std::size_t EvaluationWorkspace::get_size() const {
+  std::size_t result = 0;
+  for (const Eigen::VectorXd &buffer : buffers_) {
+    result += buffer.size();
+  }
+  return result;
+}
+
+void EvaluationWorkspace::clear() {
+  assert(used_ == 0);
+  buffers_.clear();
+}
+
+} // namespace functions
+} // namespace gsplines
@@ -4,6 +4,7 @@
 #include <gsplines/Functions/FunctionExpression.hpp>
 #include <gsplines/Tools.hpp>
 #include <stdexcept>
+#include <typeinfo>
 
 namespace gsplines {
 namespace functions {
@@ -24,6 +25,11 @@ FunctionBase::FunctionBase(const FunctionBase &that)
   assert(domain_.first <= domain_.second);
 }
 
+bool FunctionBase::same_signature(const FunctionBase &_that) const {
+  return typeid(*this) == typeid(_that) and domain_ == _that.domain_ and
+         codom_dim_ == _that.codom_dim_ and name_ == _that.name_;
+}
+
 bool FunctionBase::same_domain(const FunctionBase &_f1,
                                const FunctionBase &_f2) {
   bool err1 = abs(_f1.domain_.first - _f2.domain_.first) <
@@ -42,6 +48,23 @@ bool FunctionBase::is_point_in_domain(double _domain_point) const {
   return domain_.first <= _domain_point and _domain_point < domain_.second;
 }
 
+void FunctionBase::profiled_value(
+    const Eigen::Ref<const Eigen::VectorXd> _domain_points,
+    Eigen::Ref<Eigen::MatrixXd> _result) const {
+  EvaluationProfiler &profiler = EvaluationProfiler::thread_instance();
+  if (not profiler.is_enabled()) {
+    value_impl(_domain_points, _result);
+    return;
+  }
+  // Expressions are labelled by their type, other functions by their name
+  const FunctionExpression *expression =
+      dynamic_cast<const FunctionExpression *>(this);
+  EvaluationProfiler::Scope scope(
+      profiler, expression != nullptr ? expression->type_to_str() : name_,
+      static_cast<std::size_t>(_domain_points.size()));
+  value_impl(_domain_points, _result);
+}
+
 void FunctionBase::print(std::size_t _indent) const {
   printf("%*s- %s domain = [ %+11.3lf, %+11.3lf] codomain dim = %zu\n",
          4 * (int)_indent, "", name_.c_str(), domain_.first, domain_.second,
@@ -64,7 +87,7 @@ DotProduct FunctionBase::dot(FunctionBase &&_that) && {
 }
 
 FunctionExpression FunctionBase::to_expression() const & {
-  std::list<std::unique_ptr<FunctionBase>> result_array;
+  FunctionArray result_array;
   result_array.push_back(clone());
 
   return FunctionExpression(get_domain(), get_codom_dim(),
@@ -72,7 +95,7 @@ FunctionExpression FunctionBase::to_expression() const & {
                             std::move(result_array));
 }
 FunctionExpression FunctionBase::to_expression() && {
-  std::list<std::unique_ptr<FunctionBase>> result_array;
+  FunctionArray result_array;
   result_array.push_back(move_clone());
 
   return FunctionExpression(get_domain(), get_codom_dim(),
@@ -81,7 +104,7 @@ FunctionExpression FunctionBase::to_expression() && {
 }
 
 FunctionExpression FunctionBase::derivate(std::size_t _deg) const {
-  std::list<std::unique_ptr<FunctionBase>> result_array;
+  FunctionArray result_array;
   result_array.push_back(std::unique_ptr<FunctionBase>(deriv_impl(_deg)));
 
   return FunctionExpression(get_domain(), get_codom_dim(),
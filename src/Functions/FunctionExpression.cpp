@@ -1,4 +1,5 @@
 #include <algorithm>
+#include <gsplines/Functions/CompiledExpression.hpp>
 #include <gsplines/Functions/ElementalFunctions.hpp>
 #include <gsplines/Functions/Function.hpp>
 #include <gsplines/Functions/FunctionExpression.hpp>
@@ -18,11 +19,11 @@ std::size_t FunctionExpression::num_call_move_constructor_ = 0;
 
 FunctionExpression::FunctionExpression(
     std::pair<double, double> _domain, std::size_t _codom_dim, Type _type,
-    const std::list<std::unique_ptr<FunctionBase>> &_function_array,
-    const std::string &_name)
+    const FunctionArray &_function_array, const std::string &_name)
     : FunctionInheritanceHelper(_domain, _codom_dim, _name), type_(_type),
       function_array_(), eval_operation_(nullptr), deriv_operation_(nullptr) {
 
+  function_array_.reserve(_function_array.size());
   for (const std::unique_ptr<FunctionBase> &f : _function_array) {
     function_array_.push_back(f->clone());
   }
@@ -43,8 +44,7 @@ FunctionExpression::FunctionExpression(std::pair<double, double> _domain,
 
 FunctionExpression::FunctionExpression(
     std::pair<double, double> _domain, std::size_t _codom_dim, Type _type,
-    std::list<std::unique_ptr<FunctionBase>> &&_function_array,
-    const std::string &_name)
+    FunctionArray &&_function_array, const std::string &_name)
     : FunctionInheritanceHelper(_domain, _codom_dim, _name), type_(_type),
       eval_operation_(nullptr), deriv_operation_(nullptr),
       function_array_(std::move(_function_array)) {
@@ -59,10 +59,12 @@ FunctionExpression::FunctionExpression(
 FunctionExpression::FunctionExpression(const FunctionExpression &that)
     : FunctionInheritanceHelper(that), type_(that.type_),
       eval_operation_(that.eval_operation_),
-      deriv_operation_(that.deriv_operation_) {
+      deriv_operation_(that.deriv_operation_),
+      domain_break_points_(that.domain_break_points_) {
 
   assert(not(get_type() == UNIQUE and get_name() == ""));
   // printf("lllllllll\n");
+  function_array_.reserve(that.function_array_.size());
   for (const std::unique_ptr<FunctionBase> &f : that.function_array_) {
     function_array_.push_back(f->clone());
   }
@@ -73,7 +75,8 @@ FunctionExpression::FunctionExpression(FunctionExpression &&that)
     : FunctionInheritanceHelper(that), type_(that.type_),
       eval_operation_(that.eval_operation_),
       deriv_operation_(that.deriv_operation_),
-      function_array_(std::move(that.function_array_)) {
+      function_array_(std::move(that.function_array_)),
+      domain_break_points_(std::move(that.domain_break_points_)) {
 
   num_call_move_constructor_++;
 }
@@ -114,6 +117,42 @@ FunctionExpression::get_arg_domains() const {
   return result;
 }
 
+std::size_t FunctionExpression::get_number_of_nodes() const {
+  std::size_t result = 1;
+  for (const std::unique_ptr<FunctionBase> &f : function_array_) {
+    const FunctionExpression *expression =
+        dynamic_cast<const FunctionExpression *>(f.get());
+    result += (expression != nullptr) ? expression->get_number_of_nodes() : 1;
+  }
+  return result;
+}
+
+bool FunctionExpression::is_same_function(const FunctionBase &_that) const {
+  if (this == &_that) {
+    return true;
+  }
+  if (not same_signature(_that)) {
+    return false;
+  }
+  const FunctionExpression &that = static_cast<const FunctionExpression &>(_that);
+  return type_ == that.type_ and
+         function_array_.size() == that.function_array_.size() and
+         std::equal(function_array_.begin(), function_array_.end(),
+                    that.function_array_.begin(),
+                    [](const std::unique_ptr<FunctionBase> &_f1,
+                       const std::unique_ptr<FunctionBase> &_f2) {
+                      return _f1->is_same_function(*_f2);
+                    });
+}
+
+CompiledExpression FunctionExpression::compile() const & {
+  return CompiledExpression(*this);
+}
+
+CompiledExpression FunctionExpression::compile() && {
+  return CompiledExpression(std::move(*this));
+}
+
 void FunctionExpression::initialize() {
 
   switch (type_) {
@@ -133,8 +172,15 @@ void FunctionExpression::initialize() {
     break;
 
   case CONCATENATION:
-    eval_operation_ = eval_concat_functions;
+    // Evaluated by value_impl, which passes the break points
+    eval_operation_ = nullptr;
     deriv_operation_ = deriv_concat_functions;
+    domain_break_points_.resize(static_cast<long>(function_array_.size()) + 1);
+    domain_break_points_(0) = get_domain().first;
+    for (std::size_t k = 0; k < function_array_.size(); k++) {
+      domain_break_points_(static_cast<long>(k) + 1) =
+          function_array_[k]->get_domain().second;
+    }
     break;
 
   case UNIQUE:
@@ -187,13 +233,12 @@ void FunctionExpression::print(std::size_t _indent) const {
 }
 
 FunctionExpression *deriv_unique_functions(
-    const std::list<std::unique_ptr<FunctionBase>> &_function_array,
-    std::size_t _deg) {
+    const FunctionArray &_function_array, std::size_t _deg) {
 
   assert(_function_array.size() == 1);
   std::pair<double, double> domain = _function_array.front()->get_domain();
   std::size_t codom_dim = _function_array.front()->get_codom_dim();
-  std::list<std::unique_ptr<FunctionBase>> result_array;
+  FunctionArray result_array;
   result_array.push_back(_function_array.front()->deriv(_deg));
 
   return new FunctionExpression(domain, codom_dim,
@@ -202,7 +247,7 @@ FunctionExpression *deriv_unique_functions(
 }
 
 void eval_unique_functions(
-    const std::list<std::unique_ptr<FunctionBase>> &_function_array,
+    const FunctionArray &_function_array,
     const Eigen::Ref<const Eigen::VectorXd> _domain_points,
     Eigen::Ref<Eigen::MatrixXd> _result) {
   assert(_function_array.size() == 1);
@@ -213,13 +258,12 @@ void eval_unique_functions(
 }
 
 FunctionExpression *deriv_negative_functions(
-    const std::list<std::unique_ptr<FunctionBase>> &_function_array,
-    std::size_t _deg) {
+    const FunctionArray &_function_array, std::size_t _deg) {
 
   assert(_function_array.size() == 1);
   std::pair<double, double> domain = _function_array.front()->get_domain();
   std::size_t codom_dim = _function_array.front()->get_codom_dim();
-  std::list<std::unique_ptr<FunctionBase>> result_array;
+  FunctionArray result_array;
   result_array.push_back(_function_array.front()->deriv(_deg));
 
   return new FunctionExpression(domain, codom_dim,
@@ -228,7 +272,7 @@ FunctionExpression *deriv_negative_functions(
 }
 
 void eval_negative_functions(
-    const std::list<std::unique_ptr<FunctionBase>> &_function_array,
+    const FunctionArray &_function_array,
     const Eigen::Ref<const Eigen::VectorXd> _domain_points,
     Eigen::Ref<Eigen::MatrixXd> _result) {
   assert(_function_array.size() == 1);
@@ -1,134 +1,111 @@
-
+#include <algorithm>
 #include <gsplines/Functions/FunctionExpression.hpp>
+#include <iterator>
 
 namespace gsplines {
 namespace functions {
 
-std::list<std::unique_ptr<FunctionBase>>
-FunctionExpression::const_const_operation_handler(
-    const FunctionExpression &_first, const FunctionExpression &_second,
-    FunctionExpression::Type _opt_type) {
-  std::list<std::unique_ptr<FunctionBase>> result_array;
-  if (_first.get_type() == _opt_type or
-      _first.get_type() == FunctionExpression::UNIQUE) {
+void FunctionExpression::append_operand(const FunctionExpression &_operand,
+                                        FunctionExpression::Type _opt_type,
+                                        FunctionArray &_result) {
+  if (_operand.get_type() == _opt_type or
+      _operand.get_type() == FunctionExpression::UNIQUE) {
 
-    std::transform(_first.function_array_.begin(), _first.function_array_.end(),
-                   std::back_inserter(result_array),
+    std::transform(_operand.function_array_.begin(),
+                   _operand.function_array_.end(), std::back_inserter(_result),
                    [](const std::unique_ptr<FunctionBase> &element) {
                      return element->clone();
                    });
   } else {
 
-    result_array.push_back(_first.clone());
+    _result.push_back(_operand.clone());
   }
+}
 
-  if (_second.get_type() == _opt_type or
-      _second.get_type() == FunctionExpression::UNIQUE) {
-    std::transform(_second.function_array_.begin(),
-                   _second.function_array_.end(),
-                   std::back_inserter(result_array),
-                   [](const std::unique_ptr<FunctionBase> &element) {
-                     return element->clone();
-                   });
-
+void FunctionExpression::append_operand(FunctionExpression &&_operand,
+                                        FunctionExpression::Type _opt_type,
+                                        FunctionArray &_result) {
+  if (_operand.get_type() == _opt_type or
+      _operand.get_type() == FunctionExpression::UNIQUE) {
+
+    if (_result.empty()) {
+      _result = std::move(_operand.function_array_);
+      return;
+    }
+    std::move(_operand.function_array_.begin(),
+              _operand.function_array_.end(), std::back_inserter(_result));
   } else {
 
-    result_array.push_back(_second.clone());
+    _result.push_back(_operand.move_clone());
   }
+}
 
-  return std::move(result_array);
+FunctionArray
+FunctionExpression::const_const_operation_handler(
+    const FunctionExpression &_first, const FunctionExpression &_second,
+    FunctionExpression::Type _opt_type) {
+  FunctionArray result_array;
+  append_operand(_first, _opt_type, result_array);
+  append_operand(_second, _opt_type, result_array);
+  return result_array;
 }
 
-std::list<std::unique_ptr<FunctionBase>>
+FunctionArray
 FunctionExpression::const_nonconst_operation_handler(
     const FunctionExpression &_first, FunctionExpression &&_second,
     FunctionExpression::Type _opt_type) {
-
-  std::list<std::unique_ptr<FunctionBase>> result_array;
-  if (_first.get_type() == _opt_type or
-      _first.get_type() == FunctionExpression::UNIQUE) {
-
-    std::transform(_first.function_array_.begin(), _first.function_array_.end(),
-                   std::back_inserter(result_array),
-                   [](const std::unique_ptr<FunctionBase> &element) {
-                     return element->clone();
-                   });
-  } else {
-
-    result_array.push_back(_first.clone());
-  }
-
-  if (_second.get_type() == _opt_type or
-      _second.get_type() == FunctionExpression::UNIQUE) {
-
-    std::move(_second.function_array_.begin(), _second.function_array_.end(),
-              std::back_inserter(result_array));
-  } else {
-
-    result_array.push_back(_second.move_clone());
-  }
-
-  return std::move(result_array);
+  FunctionArray result_array;
+  append_operand(_first, _opt_type, result_array);
+  append_operand(std::move(_second), _opt_type, result_array);
+  return result_array;
 }
 
-std::list<std::unique_ptr<FunctionBase>>
+FunctionArray
 FunctionExpression::nonconst_const_operation_handler(
     FunctionExpression &&_first, const FunctionExpression &_second,
     FunctionExpression::Type _opt_type) {
-
-  std::list<std::unique_ptr<FunctionBase>> result_array;
-  if (_first.get_type() == _opt_type or
-      _first.get_type() == FunctionExpression::UNIQUE) {
-
-    std::move(_first.function_array_.begin(), _first.function_array_.end(),
-              std::back_inserter(result_array));
-  } else {
-
-    result_array.push_back(_first.move_clone());
-  }
-  if (_second.get_type() == _opt_type or
-      _second.get_type() == FunctionExpression::UNIQUE) {
-
-    std::transform(_second.function_array_.begin(),
-                   _second.function_array_.end(),
-                   std::back_inserter(result_array),
-                   [](const std::unique_ptr<FunctionBase> &element) {
-                     return element->clone();
-                   });
-  } else {
-
-    result_array.push_back(_second.clone());
-  }
-
-  return std::move(result_array);
+  FunctionArray result_array;
+  append_operand(std::move(_first), _opt_type, result_array);
+  append_operand(_second, _opt_type, result_array);
+  return result_array;
 }
 
-std::list<std::unique_ptr<FunctionBase>>
+FunctionArray
 FunctionExpression::nonconst_nonconst_operation_handler(
     FunctionExpression &&_first, FunctionExpression &&_second,
     FunctionExpression::Type _opt_type) {
+  FunctionArray result_array;
+  append_operand(std::move(_first), _opt_type, result_array);
+  append_operand(std::move(_second), _opt_type, result_array);
+  return result_array;
+}
 
-  std::list<std::unique_ptr<FunctionBase>> result_array;
-  if (_first.get_type() == _opt_type or
-      _first.get_type() == FunctionExpression::UNIQUE) {
-
-    std::move(_first.function_array_.begin(), _first.function_array_.end(),
-              std::back_inserter(result_array));
-  } else {
-
-    result_array.push_back(_first.move_clone());
+void FunctionExpression::append_in_place(const FunctionExpression &_that,
+                                         Type _type) {
+  if (&_that == this) {
+    append_in_place(FunctionExpression(_that), _type);
+    return;
   }
-  if (_second.get_type() == _opt_type or
-      _second.get_type() == FunctionExpression::UNIQUE) {
-
-    std::move(_second.function_array_.begin(), _second.function_array_.end(),
-              std::back_inserter(result_array));
-  } else {
-
-    result_array.push_back(_second.move_clone());
+  if (type_ != _type) {
+    FunctionArray operands;
+    append_operand(std::move(*this), _type, operands);
+    function_array_ = std::move(operands);
+    type_ = _type;
+    initialize();
   }
+  append_operand(_that, _type, function_array_);
+}
 
-  return std::move(result_array);
+void FunctionExpression::append_in_place(FunctionExpression &&_that,
+                                         Type _type) {
+  if (type_ != _type) {
+    FunctionArray operands;
+    append_operand(std::move(*this), _type, operands);
+    function_array_ = std::move(operands);
+    type_ = _type;
+    initialize();
+  }
+  append_operand(std::move(_that), _type, function_array_);
 }
 
 } // namespace functions
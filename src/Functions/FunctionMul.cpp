@@ -1,5 +1,6 @@
 
 #include <gsplines/Functions/ElementalFunctions.hpp>
+#include <gsplines/Functions/EvaluationWorkspace.hpp>
 #include <gsplines/Functions/FunctionExpression.hpp>
 #include <iostream>
 namespace gsplines {
@@ -58,7 +59,7 @@ FunctionExpression::operator*(const FunctionExpression &_that) const & {
   const FunctionExpression &f_scalar =
       return_second_or_mim_codom_dim(*this, _that);
 
-  std::list<std::unique_ptr<FunctionBase>> result_array =
+  FunctionArray result_array =
       const_const_operation_handler(f_vector, f_scalar,
                                     FunctionExpression::Type::MULTIPLICATION);
 
@@ -78,7 +79,7 @@ FunctionExpression::operator*(FunctionExpression &&_that) const & {
   std::pair<double, double> domain = get_domain();
   std::size_t codom_dim = f_vector.get_codom_dim();
 
-  std::list<std::unique_ptr<FunctionBase>> result_array =
+  FunctionArray result_array =
       (get_codom_dim() >= _that.get_codom_dim())
           ? const_nonconst_operation_handler(
                 *this, std::move(_that),
@@ -102,7 +103,7 @@ FunctionExpression::operator*(const FunctionExpression &_that) && {
   std::pair<double, double> domain = get_domain();
   std::size_t codom_dim = f_vector.get_codom_dim();
 
-  std::list<std::unique_ptr<FunctionBase>> result_array =
+  FunctionArray result_array =
       (get_codom_dim() >= _that.get_codom_dim())
           ? nonconst_const_operation_handler(
                 std::move(*this), _that,
@@ -126,7 +127,7 @@ FunctionExpression::operator*(FunctionExpression &&_that) && {
   std::pair<double, double> domain = get_domain();
   std::size_t codom_dim = f_vector.get_codom_dim();
 
-  std::list<std::unique_ptr<FunctionBase>> result_array =
+  FunctionArray result_array =
       (get_codom_dim() >= _that.get_codom_dim())
           ? nonconst_nonconst_operation_handler(
                 std::move(*this), std::move(_that),
@@ -141,16 +142,34 @@ FunctionExpression::operator*(FunctionExpression &&_that) && {
 }
 FunctionExpression FunctionExpression::operator-() const & {
 
+  // A negation evaluates a single function, so only the child of a UNIQUE
+  // expression can be taken directly
+  if (get_type() == UNIQUE) {
+    return FunctionExpression(get_domain(), get_codom_dim(),
+                              FunctionExpression::Type::NEGATIVE,
+                              function_array_);
+  }
+  FunctionArray result_array;
+  result_array.push_back(this->clone());
   return FunctionExpression(get_domain(), get_codom_dim(),
                             FunctionExpression::Type::NEGATIVE,
-                            function_array_);
+                            std::move(result_array));
 }
 
 FunctionExpression FunctionExpression::operator-() && {
 
-  return FunctionExpression(get_domain(), get_codom_dim(),
+  if (get_type() == UNIQUE) {
+    return FunctionExpression(get_domain(), get_codom_dim(),
+                              FunctionExpression::Type::NEGATIVE,
+                              std::move(function_array_));
+  }
+  std::pair<double, double> domain = get_domain();
+  std::size_t codom_dim = get_codom_dim();
+  FunctionArray result_array;
+  result_array.push_back(this->move_clone());
+  return FunctionExpression(domain, codom_dim,
                             FunctionExpression::Type::NEGATIVE,
-                            std::move(function_array_));
+                            std::move(result_array));
 }
 
 FunctionExpression operator*(double _value, const FunctionExpression &_that) {
@@ -162,55 +181,44 @@ FunctionExpression operator*(double _value, FunctionExpression &&_that) {
   return ConstFunction(_that.get_domain(), 1, _value) * std::move(_that);
 }
 
-void FunctionExpression::operator*=(FunctionExpression &&that) {
-  Type initial_type = get_type();
-  if (initial_type == UNIQUE) {
-    type_ = MULTIPLICATION;
-    initialize();
-  } else if (initial_type != MULTIPLICATION) {
-    FunctionExpression aux = FunctionExpression(std::move(*this));
-    function_array_.clear();
-    type_ = MULTIPLICATION;
-    initialize();
-    function_array_.push_back(aux.move_clone());
+void compatibility_mul_in_place(const FunctionExpression &_f1,
+                                const FunctionExpression &_f2) {
+  compatibility_mul(_f1, _f2);
+  if (_f2.get_codom_dim() > _f1.get_codom_dim()) {
+    throw std::invalid_argument(
+        "The vectorial factor must be the left hand side of *=");
   }
-  function_array_.push_back(that.move_clone());
 }
 
-void FunctionExpression::operator*=(const FunctionExpression &that) {
+void FunctionExpression::operator*=(FunctionExpression &&that) {
+  compatibility_mul_in_place(*this, that);
+  append_in_place(std::move(that), MULTIPLICATION);
+}
 
-  Type initial_type = get_type();
-  if (initial_type == UNIQUE) {
-    type_ = MULTIPLICATION;
-    initialize();
-  } else if (initial_type != MULTIPLICATION) {
-    FunctionExpression aux = FunctionExpression(std::move(*this));
-    function_array_.clear();
-    type_ = MULTIPLICATION;
-    initialize();
-    function_array_.push_back(aux.move_clone());
-  }
-  function_array_.push_back(that.clone());
+void FunctionExpression::operator*=(const FunctionExpression &that) {
+  compatibility_mul_in_place(*this, that);
+  append_in_place(that, MULTIPLICATION);
 }
 /* -----
  *  FunctionExpression Evaluation
  * -----*/
 
 void eval_mul_functions(
-    const std::list<std::unique_ptr<FunctionBase>> &_function_array,
+    const FunctionArray &_function_array,
     const Eigen::Ref<const Eigen::VectorXd> _domain_points,
     Eigen::Ref<Eigen::MatrixXd> _result) {
   // NOTE: the first element of _function_array has larger codomain dimension
 
-  Eigen::MatrixXd temp(_domain_points.size(), 1);
+  EvaluationWorkspace::Block temp(EvaluationWorkspace::thread_instance(),
+                                  _domain_points.size(), 1);
 
   _function_array.front()->value(_domain_points, _result);
 
-  std::list<std::unique_ptr<FunctionBase>>::const_iterator it;
+  FunctionArray::const_iterator it;
   for (it = std::next(_function_array.begin(), 1); it != _function_array.end();
        it++) {
-    (*it)->value(_domain_points, temp);
-    _result.array().colwise() *= temp.col(0).array();
+    (*it)->value(_domain_points, temp.matrix);
+    _result.array().colwise() *= temp.matrix.col(0).array();
   }
 }
 
@@ -218,16 +226,16 @@ void eval_mul_functions(
 // scholar.rose-hulman.edu/cgi/viewcontent.cgi?article=1352&context=rhumj
 
 FunctionExpression *first_deriv_mul_functions(
-    const std::list<std::unique_ptr<FunctionBase>> &_function_array) {
+    const FunctionArray &_function_array) {
 
-  std::list<std::unique_ptr<FunctionBase>> result_array;
+  FunctionArray result_array;
   std::size_t codom_dim = _function_array.front()->get_codom_dim();
   std::pair<double, double> domain = _function_array.front()->get_domain();
-  std::list<std::unique_ptr<FunctionBase>>::const_iterator it_1 =
+  FunctionArray::const_iterator it_1 =
       _function_array.begin();
-  std::list<std::unique_ptr<FunctionBase>>::const_iterator it_2;
+  FunctionArray::const_iterator it_2;
 
-  std::list<std::unique_ptr<FunctionBase>> elem_array_1;
+  FunctionArray elem_array_1;
 
   elem_array_1.push_back((*it_1)->deriv());
 
@@ -243,7 +251,7 @@ FunctionExpression *first_deriv_mul_functions(
   for (it_1 = std::next(_function_array.begin(), 1);
        it_1 != _function_array.end(); it_1++) {
 
-    std::list<std::unique_ptr<FunctionBase>> elem_array;
+    FunctionArray elem_array;
 
     for (it_2 = _function_array.begin(); it_2 != _function_array.end();
          it_2++) {
@@ -266,8 +274,7 @@ FunctionExpression *first_deriv_mul_functions(
 }
 
 FunctionExpression *deriv_mul_functions(
-    const std::list<std::unique_ptr<FunctionBase>> &_function_array,
-    std::size_t _deg) {
+    const FunctionArray &_function_array, std::size_t _deg) {
 
   std::size_t codom_dim = _function_array.front()->get_codom_dim();
   std::pair<double, double> domain = _function_array.front()->get_domain();
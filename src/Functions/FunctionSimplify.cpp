@@ -0,0 +1,321 @@
+#include <algorithm>
+#include <gsplines/Functions/ElementalFunctions.hpp>
+#include <gsplines/Functions/FunctionExpression.hpp>
+#include <gsplines/GSpline.hpp>
+#include <memory>
+#include <stdexcept>
+#include <utility>
+
+namespace gsplines {
+namespace functions {
+
+namespace {
+
+typedef std::unique_ptr<FunctionBase> Node;
+
+Node simplify_node(const FunctionBase &_function);
+
+FunctionExpression *as_expression(FunctionBase *_function,
+                                  FunctionExpression::Type _type) {
+  FunctionExpression *result = dynamic_cast<FunctionExpression *>(_function);
+  return (result != nullptr and result->get_type() == _type) ? result
+                                                             : nullptr;
+}
+
+Node make_constant(std::pair<double, double> _domain,
+                   const Eigen::VectorXd &_values) {
+  Eigen::VectorXd values = _values;
+  return std::make_unique<ConstFunction>(_domain, values);
+}
+
+Node make_expression(std::pair<double, double> _domain, std::size_t _codom_dim,
+                     FunctionExpression::Type _type, FunctionArray &&_array) {
+  return std::make_unique<FunctionExpression>(_domain, _codom_dim, _type,
+                                              std::move(_array));
+}
+
+bool is_zero(const Eigen::VectorXd &_values) {
+  return (_values.array() == 0.0).all();
+}
+
+GSpline *as_polynomial_gspline(const Node &_function) {
+  GSpline *result = dynamic_cast<GSpline *>(_function.get());
+  return (result != nullptr and result->has_polynomial_basis()) ? result
+                                                                : nullptr;
+}
+
+/// Appends the simplified children of _expression to _result, replacing the
+/// children of type _type by their own children
+void simplify_and_flatten(const FunctionExpression &_expression,
+                          FunctionExpression::Type _type,
+                          FunctionArray &_result) {
+  for (const std::unique_ptr<FunctionBase> &child :
+       _expression.function_array_) {
+    Node node = simplify_node(*child);
+    FunctionExpression *same_type = as_expression(node.get(), _type);
+    if (same_type == nullptr) {
+      _result.push_back(std::move(node));
+      continue;
+    }
+    for (Node &grandchild : same_type->function_array_) {
+      _result.push_back(std::move(grandchild));
+    }
+  }
+}
+
+/// Negation of _function, cancelling double negations and negating
+/// constants and GSplines in place
+Node negate(Node &&_function) {
+  if (FunctionExpression *negative =
+          as_expression(_function.get(), FunctionExpression::NEGATIVE)) {
+    return std::move(negative->function_array_.front());
+  }
+  if (const ConstFunction *constant =
+          dynamic_cast<const ConstFunction *>(_function.get())) {
+    return make_constant(constant->get_domain(), -constant->get_values());
+  }
+  if (GSpline *gspline = dynamic_cast<GSpline *>(_function.get())) {
+    return std::make_unique<GSpline>(-std::move(*gspline));
+  }
+  const std::pair<double, double> domain = _function->get_domain();
+  const std::size_t codom_dim = _function->get_codom_dim();
+  FunctionArray array;
+  array.push_back(std::move(_function));
+  return make_expression(domain, codom_dim, FunctionExpression::NEGATIVE,
+                         std::move(array));
+}
+
+Node simplify_sum(const FunctionExpression &_sum) {
+  const std::pair<double, double> &domain = _sum.get_domain();
+  const std::size_t codom_dim = _sum.get_codom_dim();
+
+  FunctionArray terms;
+  simplify_and_flatten(_sum, FunctionExpression::SUM, terms);
+
+  Eigen::VectorXd constant = Eigen::VectorXd::Zero(codom_dim);
+  FunctionArray result;
+  for (Node &term : terms) {
+    if (const ConstFunction *constant_term =
+            dynamic_cast<const ConstFunction *>(term.get())) {
+      constant += constant_term->get_values();
+      continue;
+    }
+    if (const GSpline *gspline = dynamic_cast<const GSpline *>(term.get())) {
+      FunctionArray::iterator it =
+          std::find_if(result.begin(), result.end(), [gspline](Node &_other) {
+            const GSpline *other = dynamic_cast<const GSpline *>(_other.get());
+            return other != nullptr and other->same_vector_space(*gspline) and
+                   FunctionBase::same_domain(*other, *gspline);
+          });
+      if (it != result.end()) {
+        static_cast<GSpline &>(**it) += *gspline;
+        continue;
+      }
+    }
+    result.push_back(std::move(term));
+  }
+
+  // GSplines which cancelled out
+  result.erase(std::remove_if(result.begin(), result.end(),
+                              [](const Node &_term) {
+                                const GSpline *gspline =
+                                    dynamic_cast<const GSpline *>(_term.get());
+                                return gspline != nullptr and
+                                       is_zero(gspline->get_coefficients());
+                              }),
+               result.end());
+
+  if (not is_zero(constant)) {
+    result.push_back(make_constant(domain, constant));
+  }
+  if (result.empty()) {
+    return make_constant(domain, constant);
+  }
+  if (result.size() == 1) {
+    return std::move(result.front());
+  }
+  return make_expression(domain, codom_dim, FunctionExpression::SUM,
+                         std::move(result));
+}
+
+Node simplify_mul(const FunctionExpression &_mul) {
+  const std::pair<double, double> &domain = _mul.get_domain();
+  const std::size_t codom_dim = _mul.get_codom_dim();
+
+  FunctionArray factors;
+  simplify_and_flatten(_mul, FunctionExpression::MULTIPLICATION, factors);
+
+  // NOTE: the first factor has the largest codomain dimension, and at most
+  // one factor is vector valued.
+  double scale = 1.0;
+  Eigen::VectorXd vector_constant;
+  FunctionArray result;
+  for (Node &factor : factors) {
+    if (FunctionExpression *negative =
+            as_expression(factor.get(), FunctionExpression::NEGATIVE)) {
+      scale = -scale;
+      factor = std::move(negative->function_array_.front());
+    }
+    if (const ConstFunction *constant =
+            dynamic_cast<const ConstFunction *>(factor.get())) {
+      if (constant->get_codom_dim() == 1) {
+        scale *= constant->get_values()(0);
+      } else {
+        vector_constant = constant->get_values();
+      }
+      continue;
+    }
+    result.push_back(std::move(factor));
+  }
+
+  if (scale == 0.0 or
+      (vector_constant.size() > 0 and is_zero(vector_constant))) {
+    return make_constant(domain, Eigen::VectorXd::Zero(codom_dim));
+  }
+
+  if (vector_constant.size() > 0) {
+    vector_constant *= scale;
+    scale = 1.0;
+    if (result.empty()) {
+      return make_constant(domain, vector_constant);
+    }
+    result.insert(result.begin(), make_constant(domain, vector_constant));
+  }
+
+  // GSplines of polynomial bases are multiplied into the first of them
+  long first_gspline = -1;
+  for (std::size_t k = 0; k < result.size();) {
+    const GSpline *gspline = as_polynomial_gspline(result[k]);
+    if (gspline == nullptr) {
+      k++;
+    } else if (first_gspline < 0) {
+      first_gspline = static_cast<long>(k++);
+    } else {
+      Node &first = result[static_cast<std::size_t>(first_gspline)];
+      first = std::make_unique<GSpline>(
+          gspline_product(*as_polynomial_gspline(first), *gspline));
+      result.erase(result.begin() + k);
+    }
+  }
+
+  if (scale != 1.0) {
+    // A GSpline absorbs the scalar factor
+    for (Node &factor : result) {
+      if (GSpline *gspline = dynamic_cast<GSpline *>(factor.get())) {
+        factor = std::make_unique<GSpline>(scale * std::move(*gspline));
+        scale = 1.0;
+        break;
+      }
+    }
+  }
+
+  if (result.empty()) {
+    return make_constant(domain, Eigen::VectorXd::Constant(codom_dim, scale));
+  }
+
+  const bool negative = scale == -1.0;
+  if (scale != 1.0 and not negative) {
+    result.push_back(
+        make_constant(domain, Eigen::VectorXd::Constant(1, scale)));
+  }
+
+  Node product = result.size() == 1
+                     ? std::move(result.front())
+                     : make_expression(domain, codom_dim,
+                                       FunctionExpression::MULTIPLICATION,
+                                       std::move(result));
+  return negative ? negate(std::move(product)) : std::move(product);
+}
+
+Node simplify_composition(const FunctionExpression &_composition) {
+  const std::pair<double, double> &domain = _composition.get_domain();
+  const std::size_t codom_dim = _composition.get_codom_dim();
+
+  // The first function is the innermost one
+  FunctionArray functions;
+  simplify_and_flatten(_composition, FunctionExpression::COMPOSITION,
+                       functions);
+
+  if (const ConstFunction *outer =
+          dynamic_cast<const ConstFunction *>(functions.back().get())) {
+    return make_constant(domain, outer->get_values());
+  }
+
+  // Compositions of GSplines of polynomial bases become one GSpline
+  for (std::size_t k = 1; k < functions.size();) {
+    const GSpline *inner = as_polynomial_gspline(functions[k - 1]);
+    const GSpline *outer = as_polynomial_gspline(functions[k]);
+    if (inner == nullptr or outer == nullptr or inner->get_codom_dim() != 1) {
+      k++;
+      continue;
+    }
+    try {
+      functions[k] =
+          std::make_unique<GSpline>(gspline_composition(*outer, *inner));
+    } catch (const std::invalid_argument &) {
+      // The range of the inner GSpline leaves the domain of the outer one
+      k++;
+      continue;
+    }
+    functions.erase(functions.begin() + static_cast<long>(k) - 1);
+  }
+
+  if (functions.size() == 1) {
+    return std::move(functions.front());
+  }
+  return make_expression(domain, codom_dim, FunctionExpression::COMPOSITION,
+                         std::move(functions));
+}
+
+Node simplify_node(const FunctionBase &_function) {
+  const FunctionExpression *expression =
+      dynamic_cast<const FunctionExpression *>(&_function);
+  if (expression == nullptr) {
+    return _function.clone();
+  }
+
+  FunctionArray array;
+  switch (expression->get_type()) {
+  case FunctionExpression::UNIQUE:
+    return simplify_node(*expression->function_array_.front());
+  case FunctionExpression::NEGATIVE:
+    return negate(simplify_node(*expression->function_array_.front()));
+  case FunctionExpression::SUM:
+    return simplify_sum(*expression);
+  case FunctionExpression::MULTIPLICATION:
+    return simplify_mul(*expression);
+  case FunctionExpression::COMPOSITION:
+    return simplify_composition(*expression);
+  case FunctionExpression::CONCATENATION:
+    for (const std::unique_ptr<FunctionBase> &f : expression->function_array_) {
+      array.push_back(simplify_node(*f));
+    }
+    {
+      FunctionExpression result = FunctionExpression::concatenation(
+          expression->get_domain(), expression->get_codom_dim(),
+          std::move(array));
+      if (result.get_type() == FunctionExpression::UNIQUE) {
+        return std::move(result.function_array_.front());
+      }
+      return std::make_unique<FunctionExpression>(std::move(result));
+    }
+  default:
+    return _function.clone();
+  }
+}
+} // namespace
+
+FunctionExpression FunctionExpression::simplify() const {
+  Node result = simplify_node(*this);
+  if (FunctionExpression *expression =
+          dynamic_cast<FunctionExpression *>(result.get())) {
+    return std::move(*expression);
+  }
+  FunctionArray array;
+  array.push_back(std::move(result));
+  return FunctionExpression(get_domain(), get_codom_dim(), UNIQUE,
+                            std::move(array));
+}
+
+} // namespace functions
+} // namespace gsplines
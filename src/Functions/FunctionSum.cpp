@@ -1,5 +1,6 @@
 
 #include <gsplines/Functions/ElementalFunctions.hpp>
+#include <gsplines/Functions/EvaluationWorkspace.hpp>
 #include <gsplines/Functions/FunctionExpression.hpp>
 #include <iostream>
 namespace gsplines {
@@ -20,7 +21,7 @@ FunctionExpression::operator+(const FunctionExpression &_that) const & {
 
   sum_throw(*this, _that);
 
-  std::list<std::unique_ptr<FunctionBase>> result_array =
+  FunctionArray result_array =
       const_const_operation_handler(*this, _that,
                                     FunctionExpression::Type::SUM);
   return FunctionExpression(get_domain(), get_codom_dim(),
@@ -33,7 +34,7 @@ FunctionExpression::operator+(FunctionExpression &&_that) const & {
 
   sum_throw(*this, _that);
 
-  std::list<std::unique_ptr<FunctionBase>> result_array =
+  FunctionArray result_array =
       const_nonconst_operation_handler(*this, std::move(_that),
                                        FunctionExpression::Type::SUM);
 
@@ -47,7 +48,7 @@ FunctionExpression::operator+(const FunctionExpression &_that) && {
 
   sum_throw(*this, _that);
 
-  std::list<std::unique_ptr<FunctionBase>> result_array =
+  FunctionArray result_array =
       nonconst_const_operation_handler(std::move(*this), _that,
                                        FunctionExpression::Type::SUM);
 
@@ -61,7 +62,7 @@ FunctionExpression::operator+(FunctionExpression &&_that) && {
 
   sum_throw(*this, _that);
 
-  std::list<std::unique_ptr<FunctionBase>> result_array =
+  FunctionArray result_array =
       nonconst_nonconst_operation_handler(std::move(*this), std::move(_that),
                                           FunctionExpression::Type::SUM);
 
@@ -103,15 +104,16 @@ FunctionExpression::operator-(FunctionExpression &&_that) && {
  *  FunctionExpression Evaluation
  * -----*/
 void eval_sum_functions(
-    const std::list<std::unique_ptr<FunctionBase>> &_function_array,
+    const FunctionArray &_function_array,
     const Eigen::Ref<const Eigen::VectorXd> _domain_points,
     Eigen::Ref<Eigen::MatrixXd> _result) {
-  Eigen::MatrixXd temp(_domain_points.size(),
-                       _function_array.front()->get_codom_dim());
+  EvaluationWorkspace::Block temp(EvaluationWorkspace::thread_instance(),
+                                  _domain_points.size(),
+                                  _function_array.front()->get_codom_dim());
   _result.setZero();
   for (const std::unique_ptr<FunctionBase> &f : _function_array) {
-    f->value(_domain_points, temp);
-    _result += temp;
+    f->value(_domain_points, temp.matrix);
+    _result += temp.matrix;
     // std::cout << "result \n " << _result << "\n ---\n";
     // printf("kkk\n");
   }
@@ -121,9 +123,8 @@ void eval_sum_functions(
  *  FunctionExpression Derivation
  * -----*/
 FunctionExpression *deriv_sum_functions(
-    const std::list<std::unique_ptr<FunctionBase>> &_function_array,
-    std::size_t _deg) {
-  std::list<std::unique_ptr<FunctionBase>> result_array;
+    const FunctionArray &_function_array, std::size_t _deg) {
+  FunctionArray result_array;
   for (const std::unique_ptr<FunctionBase> &f : _function_array) {
     // printf("func name = %s \n", f->get_name().c_str());
     result_array.push_back(f->deriv(_deg));
@@ -137,34 +138,13 @@ FunctionExpression *deriv_sum_functions(
 }
 
 void FunctionExpression::operator+=(FunctionExpression &&that) {
-  Type initial_type = get_type();
-  if (initial_type == UNIQUE) {
-    type_ = SUM;
-    initialize();
-  } else if (initial_type != SUM) {
-    FunctionExpression aux = FunctionExpression(std::move(*this));
-    function_array_.clear();
-    type_ = SUM;
-    initialize();
-    function_array_.push_back(aux.move_clone());
-  }
-  function_array_.push_back(that.move_clone());
+  sum_throw(*this, that);
+  append_in_place(std::move(that), SUM);
 }
 
 void FunctionExpression::operator+=(const FunctionExpression &that) {
-
-  Type initial_type = get_type();
-  if (initial_type == UNIQUE) {
-    type_ = SUM;
-    initialize();
-  } else if (initial_type != SUM) {
-    FunctionExpression aux = FunctionExpression(std::move(*this));
-    function_array_.clear();
-    type_ = SUM;
-    initialize();
-    function_array_.push_back(aux.move_clone());
-  }
-  function_array_.push_back(that.clone());
+  sum_throw(*this, that);
+  append_in_place(that, SUM);
 }
 } // namespace functions
 } // namespace gsplines
@@ -1,7 +1,9 @@
 
 
+#include <gsplines/Functions/EvaluationWorkspace.hpp>
 #include <gsplines/Functions/FunctionExpression.hpp>
 #include <iostream>
+#include <utility>
 namespace gsplines {
 namespace functions {
 
@@ -23,7 +25,7 @@ FunctionExpression::compose(const FunctionExpression &_that) const & {
 
   comp_throw(*this, _that);
 
-  std::list<std::unique_ptr<FunctionBase>> result_array;
+  FunctionArray result_array;
 
   if (get_type() == COMPOSITION) {
     std::transform(function_array_.begin(), function_array_.end(),
@@ -36,13 +38,13 @@ FunctionExpression::compose(const FunctionExpression &_that) const & {
   }
 
   if (_that.get_type() == COMPOSITION) {
-    std::transform(_that.function_array_.rbegin(), _that.function_array_.rend(),
-                   std::front_inserter(result_array),
+    std::transform(_that.function_array_.begin(), _that.function_array_.end(),
+                   std::inserter(result_array, result_array.begin()),
                    [](const std::unique_ptr<FunctionBase> &element) {
                      return element->clone();
                    });
   } else {
-    result_array.push_front(_that.clone());
+    result_array.insert(result_array.begin(), _that.clone());
   }
 
   return FunctionExpression(_that.get_domain(), get_codom_dim(),
@@ -55,7 +57,7 @@ FunctionExpression::compose(FunctionExpression &&_that) const & {
 
   comp_throw(*this, _that);
 
-  std::list<std::unique_ptr<FunctionBase>> result_array;
+  FunctionArray result_array;
 
   if (get_type() == COMPOSITION) {
     std::transform(function_array_.begin(), function_array_.end(),
@@ -68,10 +70,11 @@ FunctionExpression::compose(FunctionExpression &&_that) const & {
   }
 
   if (_that.get_type() == COMPOSITION) {
-    std::move(_that.function_array_.rbegin(), _that.function_array_.rend(),
-              std::front_inserter(result_array));
+    result_array.insert(result_array.begin(),
+                        std::make_move_iterator(_that.function_array_.begin()),
+                        std::make_move_iterator(_that.function_array_.end()));
   } else {
-    result_array.push_front(_that.move_clone());
+    result_array.insert(result_array.begin(), _that.move_clone());
   }
 
   return FunctionExpression(_that.get_domain(), get_codom_dim(),
@@ -86,32 +89,32 @@ FunctionExpression::compose(const FunctionExpression &_that) && {
 
   if (get_type() == COMPOSITION) {
     if (_that.get_type() == COMPOSITION) {
-      std::transform(_that.function_array_.rbegin(),
-                     _that.function_array_.rend(),
-                     std::front_inserter(function_array_),
+      std::transform(_that.function_array_.begin(),
+                     _that.function_array_.end(),
+                     std::inserter(function_array_, function_array_.begin()),
                      [](const std::unique_ptr<FunctionBase> &element) {
                        return element->clone();
                      });
 
     } else {
-      function_array_.push_front(_that.clone());
+      function_array_.insert(function_array_.begin(), _that.clone());
     }
     return std::move(*this);
   }
 
-  std::list<std::unique_ptr<FunctionBase>> result_array;
+  FunctionArray result_array;
 
   result_array.push_back(this->move_clone());
 
   if (_that.get_type() == COMPOSITION) {
 
-    std::transform(_that.function_array_.rbegin(), _that.function_array_.rend(),
-                   std::front_inserter(result_array),
+    std::transform(_that.function_array_.begin(), _that.function_array_.end(),
+                   std::inserter(result_array, result_array.begin()),
                    [](const std::unique_ptr<FunctionBase> &element) {
                      return element->clone();
                    });
   } else {
-    result_array.push_front(_that.clone());
+    result_array.insert(result_array.begin(), _that.clone());
   }
 
   return FunctionExpression(_that.get_domain(), get_codom_dim(),
@@ -125,17 +128,19 @@ FunctionExpression FunctionExpression::compose(FunctionExpression &&_that) && {
 
   if (get_type() == COMPOSITION) {
     if (_that.get_type() == COMPOSITION) {
-      std::move(_that.function_array_.rbegin(), _that.function_array_.rend(),
-                std::front_inserter(function_array_));
+      function_array_.insert(
+          function_array_.begin(),
+          std::make_move_iterator(_that.function_array_.begin()),
+          std::make_move_iterator(_that.function_array_.end()));
 
     } else {
-      function_array_.push_front(_that.move_clone());
+      function_array_.insert(function_array_.begin(), _that.move_clone());
     }
     set_domain(_that.get_domain().first, _that.get_domain().second);
     return std::move(*this);
   }
 
-  std::list<std::unique_ptr<FunctionBase>> result_array;
+  FunctionArray result_array;
 
   result_array.push_back(this->move_clone());
 
@@ -144,11 +149,12 @@ FunctionExpression FunctionExpression::compose(FunctionExpression &&_that) && {
 
   if (_that.get_type() == COMPOSITION) {
 
-    std::move(_that.function_array_.rbegin(), _that.function_array_.rend(),
-              std::front_inserter(result_array));
+    result_array.insert(result_array.begin(),
+                        std::make_move_iterator(_that.function_array_.begin()),
+                        std::make_move_iterator(_that.function_array_.end()));
 
   } else {
-    result_array.push_front(_that.move_clone());
+    result_array.insert(result_array.begin(), _that.move_clone());
   }
 
   return FunctionExpression(domain, codom_dim,
@@ -160,44 +166,49 @@ FunctionExpression FunctionExpression::compose(FunctionExpression &&_that) && {
  *  Evaluation method
  * -----*/
 void eval_compose_functions(
-    const std::list<std::unique_ptr<FunctionBase>> &_function_array,
+    const FunctionArray &_function_array,
     const Eigen::Ref<const Eigen::VectorXd> _domain_points,
     Eigen::Ref<Eigen::MatrixXd> _result) {
 
-  Eigen::VectorXd domain_points_copy(_domain_points);
-  Eigen::VectorXd temp(_domain_points.size());
+  if (_function_array.size() == 1) {
+    _function_array.front()->value(_domain_points, _result);
+    return;
+  }
 
-  std::list<std::unique_ptr<FunctionBase>>::const_iterator it;
+  // The inner functions are evaluated alternating between two temporaries,
+  // the points of each function are the values of the previous one.
+  EvaluationWorkspace &workspace = EvaluationWorkspace::thread_instance();
+  EvaluationWorkspace::Block buffer_1(workspace, _domain_points.size(), 1);
+  EvaluationWorkspace::Block buffer_2(workspace, _domain_points.size(), 1);
+  Eigen::Map<Eigen::MatrixXd> *points = &buffer_1.matrix;
+  Eigen::Map<Eigen::MatrixXd> *values = &buffer_2.matrix;
 
-  // std::cout << "++ Function Composition t0 \n" << _domain_points <<
-  // "\n----\n";
-  // std::cout << _m_test << "\n----\n";
-  std::list<std::unique_ptr<FunctionBase>>::const_iterator it_limit =
+  FunctionArray::const_iterator it;
+  FunctionArray::const_iterator it_limit =
       std::next(_function_array.end(), -1);
 
-  for (it = _function_array.begin(); it != it_limit; it++) {
-    (*it)->value(domain_points_copy, temp);
-    domain_points_copy = temp;
-    // std::cout << "++ Function Composition actual t \n"
-    //          << domain_points_copy << "\n----\n";
+  _function_array.front()->value(_domain_points, *points);
+  for (it = std::next(_function_array.begin()); it != it_limit; it++) {
+    (*it)->value(points->col(0), *values);
+    std::swap(points, values);
   }
 
-  _function_array.back()->value(domain_points_copy, _result);
+  _function_array.back()->value(points->col(0), _result);
 }
 
 /* -----
  *  FunctionExpression Derivation
  * -----*/
 FunctionExpression *first_deriv_compose_functions(
-    const std::list<std::unique_ptr<FunctionBase>> &_function_array) {
+    const FunctionArray &_function_array) {
 
-  std::list<std::unique_ptr<FunctionBase>> result_array;
+  FunctionArray result_array;
 
   result_array.push_back(_function_array.front()->deriv());
 
   std::pair<double, double> domain = _function_array.front()->get_domain();
 
-  std::list<std::unique_ptr<FunctionBase>>::const_iterator it;
+  FunctionArray::const_iterator it;
   //
   // oritiginal compisition
   // +-----+-----+-----+-----+-----+
@@ -230,8 +241,8 @@ FunctionExpression *first_deriv_compose_functions(
   for (it = std::next(_function_array.begin(), 1); it != _function_array.end();
        it++) {
 
-    std::list<std::unique_ptr<FunctionBase>> elem_array;
-    std::list<std::unique_ptr<FunctionBase>>::const_iterator it_elem;
+    FunctionArray elem_array;
+    FunctionArray::const_iterator it_elem;
 
     for (it_elem = _function_array.begin(); it_elem != it; it_elem++) {
       elem_array.push_back((*it_elem)->clone());
@@ -241,9 +252,11 @@ FunctionExpression *first_deriv_compose_functions(
 
     std::size_t codom_dim = (*it)->get_codom_dim();
 
-    result_array.push_front(std::make_unique<FunctionExpression>(
-        domain, codom_dim, FunctionExpression::Type::COMPOSITION,
-        std::move(elem_array)));
+    result_array.insert(result_array.begin(),
+                        std::make_unique<FunctionExpression>(
+                            domain, codom_dim,
+                            FunctionExpression::Type::COMPOSITION,
+                            std::move(elem_array)));
   }
 
   std::size_t codom_dim = _function_array.back()->get_codom_dim();
@@ -258,8 +271,7 @@ FunctionExpression *first_deriv_compose_functions(
 }
 
 FunctionExpression *deriv_compose_functions(
-    const std::list<std::unique_ptr<FunctionBase>> &_function_array,
-    std::size_t _deg) {
+    const FunctionArray &_function_array, std::size_t _deg) {
 
   if (_deg == 0) {
     std::size_t codom_dim = _function_array.back()->get_codom_dim();
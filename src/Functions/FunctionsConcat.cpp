@@ -1,9 +1,45 @@
 
 #include <algorithm>
+#include <cassert>
+#include <gsplines/Functions/EvaluationWorkspace.hpp>
 #include <gsplines/Functions/FunctionExpression.hpp>
+#include <gsplines/GSpline.hpp>
+#include <memory>
 namespace gsplines {
 namespace functions {
 
+FunctionExpression
+FunctionExpression::concatenation(std::pair<double, double> _domain,
+                                  std::size_t _codom_dim,
+                                  FunctionArray &&_function_array) {
+
+  // Consecutive GSplines with the same basis are appended in place to the
+  // first one, which the array owns. Stitching N pieces with chained calls
+  // of concat on rvalues is then linear in N.
+  std::size_t last = 0;
+  for (std::size_t k = 1; k < _function_array.size(); k++) {
+    GSpline *first = dynamic_cast<GSpline *>(_function_array[last].get());
+    const GSpline *second =
+        dynamic_cast<const GSpline *>(_function_array[k].get());
+    if (first != nullptr and second != nullptr and
+        first->get_basis() == second->get_basis() and
+        first->get_codom_dim() == second->get_codom_dim()) {
+      first->append(*second);
+    } else {
+      last++;
+      _function_array[last] = std::move(_function_array[k]);
+    }
+  }
+  if (not _function_array.empty()) {
+    _function_array.erase(_function_array.begin() + last + 1,
+                          _function_array.end());
+  }
+
+  const Type type = _function_array.size() == 1 ? UNIQUE : CONCATENATION;
+  return FunctionExpression(_domain, _codom_dim, type,
+                            std::move(_function_array));
+}
+
 void concat_throw(const FunctionExpression &_f1,
                   const FunctionExpression &_f2) {
 
@@ -21,9 +57,9 @@ FunctionExpression::concat(const FunctionExpression &_that) const & {
 
   concat_throw(*this, _that);
 
-  std::list<std::unique_ptr<FunctionBase>> result_array;
+  FunctionArray result_array;
 
-  if (get_type() == CONCATENATION) {
+  if (get_type() == CONCATENATION or get_type() == UNIQUE) {
     std::transform(function_array_.begin(), function_array_.end(),
                    std::back_inserter(result_array),
                    [](const std::unique_ptr<FunctionBase> &element) {
@@ -33,7 +69,7 @@ FunctionExpression::concat(const FunctionExpression &_that) const & {
     result_array.push_back(this->clone());
   }
 
-  if (_that.get_type() == CONCATENATION) {
+  if (_that.get_type() == CONCATENATION or _that.get_type() == UNIQUE) {
     std::transform(_that.function_array_.begin(), _that.function_array_.end(),
                    std::back_inserter(result_array),
                    [](const std::unique_ptr<FunctionBase> &element) {
@@ -42,9 +78,8 @@ FunctionExpression::concat(const FunctionExpression &_that) const & {
   } else {
     result_array.push_back(_that.clone());
   }
-  return FunctionExpression(
-      {get_domain().first, _that.get_domain().second}, get_codom_dim(),
-      FunctionExpression::Type::CONCATENATION, std::move(result_array));
+  return concatenation({get_domain().first, _that.get_domain().second},
+                       get_codom_dim(), std::move(result_array));
 }
 
 FunctionExpression
@@ -52,9 +87,9 @@ FunctionExpression::concat(FunctionExpression &&_that) const & {
 
   concat_throw(*this, _that);
 
-  std::list<std::unique_ptr<FunctionBase>> result_array;
+  FunctionArray result_array;
 
-  if (get_type() == CONCATENATION) {
+  if (get_type() == CONCATENATION or get_type() == UNIQUE) {
     std::transform(function_array_.begin(), function_array_.end(),
                    std::back_inserter(result_array),
                    [](const std::unique_ptr<FunctionBase> &element) {
@@ -64,16 +99,15 @@ FunctionExpression::concat(FunctionExpression &&_that) const & {
     result_array.push_back(this->clone());
   }
 
-  if (_that.get_type() == CONCATENATION) {
+  if (_that.get_type() == CONCATENATION or _that.get_type() == UNIQUE) {
 
     std::move(_that.function_array_.begin(), _that.function_array_.end(),
               std::back_inserter(result_array));
   } else {
     result_array.push_back(_that.move_clone());
   }
-  return FunctionExpression(
-      {get_domain().first, _that.get_domain().second}, get_codom_dim(),
-      FunctionExpression::Type::CONCATENATION, std::move(result_array));
+  return concatenation({get_domain().first, _that.get_domain().second},
+                       get_codom_dim(), std::move(result_array));
 }
 
 FunctionExpression
@@ -81,12 +115,12 @@ FunctionExpression::concat(const FunctionExpression &_that) && {
 
   concat_throw(*this, _that);
 
-  std::list<std::unique_ptr<FunctionBase>> result_array;
+  FunctionArray result_array;
 
-  std::list<std::unique_ptr<FunctionBase>> &target_array =
+  FunctionArray &target_array =
       (get_type() == CONCATENATION) ? function_array_ : result_array;
 
-  if (_that.get_type() == CONCATENATION) {
+  if (_that.get_type() == CONCATENATION or _that.get_type() == UNIQUE) {
 
     std::transform(_that.function_array_.begin(), _that.function_array_.end(),
                    std::back_inserter(target_array),
@@ -97,26 +131,32 @@ FunctionExpression::concat(const FunctionExpression &_that) && {
     target_array.push_back(_that.clone());
   }
 
-  if (get_type() == CONCATENATION)
-    return std::move(*this);
+  if (get_type() == CONCATENATION) {
+    return concatenation({get_domain().first, _that.get_domain().second},
+                         get_codom_dim(), std::move(function_array_));
+  }
 
-  target_array.push_front(this->move_clone());
+  if (get_type() == UNIQUE) {
+    target_array.insert(target_array.begin(),
+                        std::move(function_array_.front()));
+  } else {
+    target_array.insert(target_array.begin(), this->move_clone());
+  }
 
-  return FunctionExpression(
-      {get_domain().first, _that.get_domain().second}, get_codom_dim(),
-      FunctionExpression::Type::CONCATENATION, std::move(target_array));
+  return concatenation({get_domain().first, _that.get_domain().second},
+                       get_codom_dim(), std::move(target_array));
 }
 
 FunctionExpression FunctionExpression::concat(FunctionExpression &&_that) && {
 
   concat_throw(*this, _that);
 
-  std::list<std::unique_ptr<FunctionBase>> result_array;
+  FunctionArray result_array;
 
-  std::list<std::unique_ptr<FunctionBase>> &target_array =
+  FunctionArray &target_array =
       (get_type() == CONCATENATION) ? function_array_ : result_array;
 
-  if (_that.get_type() == CONCATENATION) {
+  if (_that.get_type() == CONCATENATION or _that.get_type() == UNIQUE) {
 
     std::move(_that.function_array_.begin(), _that.function_array_.end(),
               std::back_inserter(target_array));
@@ -124,43 +164,31 @@ FunctionExpression FunctionExpression::concat(FunctionExpression &&_that) && {
     target_array.push_back(_that.move_clone());
   }
 
-  if (get_type() == CONCATENATION)
-    return std::move(*this);
+  if (get_type() == CONCATENATION) {
+    return concatenation({get_domain().first, _that.get_domain().second},
+                         get_codom_dim(), std::move(function_array_));
+  }
 
-  target_array.push_front(this->move_clone());
-  return FunctionExpression(
-      {get_domain().first, _that.get_domain().second}, get_codom_dim(),
-      FunctionExpression::Type::CONCATENATION, std::move(target_array));
+  if (get_type() == UNIQUE) {
+    target_array.insert(target_array.begin(),
+                        std::move(function_array_.front()));
+  } else {
+    target_array.insert(target_array.begin(), this->move_clone());
+  }
+  return concatenation({get_domain().first, _that.get_domain().second},
+                       get_codom_dim(), std::move(target_array));
 }
 
 //  -----------------------------
 //  FunctionExpression Evaluation
 //  -----------------------------
 
-std::list<std::unique_ptr<FunctionBase>>::const_iterator get_interval_function(
-    double _domain_point,
-    const std::list<std::unique_ptr<FunctionBase>> &_function_array) {
-
-  std::list<std::unique_ptr<FunctionBase>>::const_iterator result =
-      std::find_if(
-          _function_array.begin(), _function_array.end(),
-          [&_domain_point](const std::unique_ptr<FunctionBase> &element) {
-            // printf("function is %s\n", element->get_name().c_str());
-            // printf("domain is %lf, %lf\n", element->get_domain().first,
-            //       element->get_domain().second);
-            return element->is_point_in_domain(_domain_point);
-          });
-
-  return result;
-}
-
 FunctionExpression *deriv_concat_functions(
-    const std::list<std::unique_ptr<FunctionBase>> &_function_array,
-    std::size_t _deg) {
+    const FunctionArray &_function_array, std::size_t _deg) {
 
   // printf("---------- deriv concat function ---------------\n");
 
-  std::list<std::unique_ptr<FunctionBase>> result_array;
+  FunctionArray result_array;
 
   for (const std::unique_ptr<FunctionBase> &f : _function_array) {
     result_array.push_back(f->deriv(_deg));
@@ -181,43 +209,37 @@ FunctionExpression *deriv_concat_functions(
 }
 
 void eval_concat_functions(
-    const std::list<std::unique_ptr<FunctionBase>> &_function_array,
+    const FunctionArray &_function_array, const Eigen::VectorXd &_break_points,
     const Eigen::Ref<const Eigen::VectorXd> _domain_points,
     Eigen::Ref<Eigen::MatrixXd> _result) {
 
-  Eigen::VectorXd vector_one(1);
-
-  Eigen::MatrixXd temp(1, _function_array.front()->get_codom_dim());
-
-  for (std::size_t i = 0; i < _domain_points.size(); i++) {
-
-    std::list<std::unique_ptr<FunctionBase>>::const_iterator f =
-        get_interval_function(_domain_points[i], _function_array);
-    std::size_t idx = std::distance(_function_array.begin(), f);
-    /*printf("++ ----- ++\n");
-    printf("++  idx = %zu ++\n", idx);
-    printf("++ ----- ++\n");*/
-
-    if (f != _function_array.end()) {
-      (*f)->value(_domain_points.segment(i, 1), temp);
-    } else if (_domain_points[i] <=
-               _function_array.front()->get_domain().first) {
-      _function_array.front()->value(
-          Eigen::VectorXd::Constant(
-              1, _function_array.front()->get_domain().first),
-          temp);
-    } else if (_domain_points[i] >=
-               _function_array.back()->get_domain().second) {
-
-      _function_array.back()->value(
-          Eigen::VectorXd::Constant(
-              1, _function_array.back()->get_domain().second),
-          temp);
-    } else {
-      throw std::invalid_argument(
-          "The functions is not defined for this value");
+  assert(_break_points.size() ==
+         static_cast<long>(_function_array.size()) + 1);
+  const long n = _domain_points.size();
+  const long last_function = static_cast<long>(_function_array.size()) - 1;
+
+  EvaluationWorkspace &workspace = EvaluationWorkspace::thread_instance();
+  EvaluationWorkspace::Block points(workspace, n, 1);
+  points.matrix.col(0) =
+      _domain_points.cwiseMax(_break_points(0))
+          .cwiseMin(_break_points(_break_points.size() - 1));
+
+  // The domain of the k-th function is [t_k, t_{k+1}), the last one is
+  // closed. It is found among the inner break points.
+  const double *first = _break_points.data() + 1;
+  const double *last = first + last_function;
+
+  long i = 0;
+  while (i < n) {
+    const long k = std::upper_bound(first, last, points.matrix(i, 0)) - first;
+    long j = i + 1;
+    while (j < n and (k == 0 or points.matrix(j, 0) >= _break_points(k)) and
+           (k == last_function or points.matrix(j, 0) < _break_points(k + 1))) {
+      j++;
     }
-    _result.row(i) = temp.row(0);
+    _function_array[static_cast<std::size_t>(k)]->value(
+        points.matrix.col(0).segment(i, j - i), _result.middleRows(i, j - i));
+    i = j;
   }
 }
 } // namespace functions
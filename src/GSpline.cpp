@@ -1,14 +1,21 @@
+#include <eigen3/Eigen/Eigenvalues>
+#include <eigen3/Eigen/LU>
+#include <gsplines/Basis/BasisLagrange.hpp>
 #include <gsplines/Basis/BasisLegendre.hpp>
+#include <gsplines/Collocation/GaussLobattoPointsWeights.hpp>
 #include <gsplines/Functions/FunctionInheritanceHelper.hpp>
 #include <gsplines/GSpline.hpp>
 #include <gsplines/Interpolator.hpp>
 #include <gsplines/Tools.hpp>
+#include <algorithm>
+#include <cmath>
 #include <iostream>
 #include <memory>
 #include <random>
 #include <stdexcept>
 #include <string>
 #include <utility>
+#include <vector>
 
 namespace gsplines {
 
@@ -91,23 +98,32 @@ GSplineBase::GSplineBase(std::pair<double, double> _domain,
 void GSplineBase::value_impl(
     const Eigen::Ref<const Eigen::VectorXd> _domain_points,
     Eigen::Ref<Eigen::MatrixXd> _result) const {
-  const std::size_t result_cols(_domain_points.size());
-  std::size_t current_interval = 0;
-  double s = 0.0;
-  double tau = 0.0;
-
-  std::size_t i = 0;
-  std::size_t j = 0;
-
-  for (i = 0; i < result_cols; i++) {
-    current_interval = get_interval(_domain_points(static_cast<long>(i)));
-    s = interval_to_window(_domain_points(static_cast<long>(i)),
-                           current_interval);
-    tau = domain_interval_lengths_(static_cast<long>(current_interval));
-    basis_->eval_on_window(s, tau, basis_buffer_);
-    for (j = 0; j < get_codom_dim(); j++) {
-      _result(static_cast<long>(i), static_cast<long>(j)) =
-          coefficient_segment(current_interval, j).adjoint() * basis_buffer_;
+  const long number_of_intervals =
+      static_cast<long>(get_number_of_intervals());
+
+  // The interval of each point is searched from the interval of the previous
+  // one, so that sorted points, the common case, are located in a single
+  // pass. The intervals are (t_i, t_{i+1}], as in get_interval.
+  long current_interval = 0;
+  double left_breakpoint = get_domain().first;
+  for (long i = 0; i < _domain_points.size(); i++) {
+    const double t = _domain_points(i);
+    if (t <= left_breakpoint) {
+      current_interval = 0;
+      left_breakpoint = get_domain().first;
+    }
+    while (current_interval + 1 < number_of_intervals and
+           t > left_breakpoint + domain_interval_lengths_(current_interval)) {
+      left_breakpoint += domain_interval_lengths_(current_interval);
+      current_interval++;
+    }
+    const double tau = domain_interval_lengths_(current_interval);
+    basis_->eval_on_window(2.0 * (t - left_breakpoint) / tau - 1.0, tau,
+                           basis_buffer_);
+    for (std::size_t j = 0; j < get_codom_dim(); j++) {
+      _result(i, static_cast<long>(j)) =
+          coefficient_segment(static_cast<std::size_t>(current_interval), j)
+              .dot(basis_buffer_);
     }
   }
 }
@@ -165,6 +181,18 @@ bool GSplineBase::operator!=(const GSplineBase& _that) const {
   return not(*this == _that);
 }
 
+bool GSplineBase::is_same_function(const FunctionBase& _that) const {
+  if (not same_signature(_that)) {
+    return false;
+  }
+  const GSplineBase& that = static_cast<const GSplineBase&>(_that);
+  return get_basis() == that.get_basis() and
+         get_interval_lengths().size() == that.get_interval_lengths().size() and
+         get_interval_lengths() == that.get_interval_lengths() and
+         get_coefficients().size() == that.get_coefficients().size() and
+         get_coefficients() == that.get_coefficients();
+}
+
 Eigen::Ref<const Eigen::VectorXd> get_coefficient_segment(
     Eigen::Ref<const Eigen::VectorXd> _coefficients, basis::Basis& _basis,
     std::size_t _num_interval, std::size_t _codom_dim, std::size_t _interval,
@@ -193,6 +221,239 @@ Eigen::MatrixXd GSplineBase::get_waypoints() const {
   return result;
 }
 
+namespace {
+/// Matrix M such that M y are the monomial coefficients, in increasing
+/// degree, of the polynomial sum_k y_k B_k(s) on the window. It interpolates
+/// the basis at Chebyshev-Lobatto points, which is exact for a polynomial
+/// basis and keeps the Vandermonde matrix well conditioned.
+Eigen::MatrixXd monomial_coefficients_matrix(const basis::Basis& _basis) {
+  const long dim = static_cast<long>(_basis.get_dim());
+  Eigen::MatrixXd basis_values(dim, dim);
+  Eigen::MatrixXd vandermonde(dim, dim);
+  Eigen::VectorXd buffer(dim);
+  for (long m = 0; m < dim; m++) {
+    const double s =
+        dim == 1 ? 0.0 : -std::cos(M_PI * static_cast<double>(m) /
+                                   static_cast<double>(dim - 1));
+    _basis.eval_on_window(s, 2.0, buffer);
+    basis_values.row(m) = buffer.transpose();
+    double power = 1.0;
+    for (long j = 0; j < dim; j++) {
+      vandermonde(m, j) = power;
+      power *= s;
+    }
+  }
+  return vandermonde.fullPivLu().solve(basis_values);
+}
+
+/// Coefficients of the derivative of the polynomial with monomial
+/// coefficients _coeff
+Eigen::VectorXd monomial_derivative(const Eigen::VectorXd& _coeff) {
+  if (_coeff.size() <= 1) {
+    return Eigen::VectorXd::Zero(1);
+  }
+  Eigen::VectorXd result(_coeff.size() - 1);
+  for (long j = 0; j < result.size(); j++) {
+    result(j) = static_cast<double>(j + 1) * _coeff(j + 1);
+  }
+  return result;
+}
+
+double monomial_value(const Eigen::VectorXd& _coeff, double _s) {
+  double result = 0.0;
+  for (long j = _coeff.size() - 1; j >= 0; j--) {
+    result = result * _s + _coeff(j);
+  }
+  return result;
+}
+
+/// Roots of the polynomial with monomial coefficients _coeff, as the
+/// eigenvalues of its companion matrix. Negligible leading coefficients are
+/// dropped so that the companion matrix is well defined.
+Eigen::VectorXcd monomial_roots(const Eigen::VectorXd& _coeff) {
+  const double scale = _coeff.cwiseAbs().maxCoeff();
+  long degree = _coeff.size() - 1;
+  while (degree > 0 and std::abs(_coeff(degree)) <= 1.0e-13 * scale) {
+    degree--;
+  }
+  if (degree < 1) {
+    return Eigen::VectorXcd(0);
+  }
+  Eigen::MatrixXd companion = Eigen::MatrixXd::Zero(degree, degree);
+  companion.diagonal(-1).setOnes();
+  companion.col(degree - 1) = -_coeff.head(degree) / _coeff(degree);
+  return Eigen::EigenSolver<Eigen::MatrixXd>(companion, false).eigenvalues();
+}
+
+/// Maximum of |p(s)| on [-1, 1]
+double max_abs_on_window(const Eigen::VectorXd& _coeff) {
+  double result =
+      std::max(std::abs(monomial_value(_coeff, -1.0)),
+               std::abs(monomial_value(_coeff, 1.0)));
+
+  // Interior extrema are real roots of p'. Evaluating at the clipped real
+  // part of every root, real or not, only adds candidates and makes the
+  // result robust to roots which are real up to round-off.
+  const Eigen::VectorXcd roots = monomial_roots(monomial_derivative(_coeff));
+  for (long k = 0; k < roots.size(); k++) {
+    const double s = std::min(1.0, std::max(-1.0, roots(k).real()));
+    result = std::max(result, std::abs(monomial_value(_coeff, s)));
+  }
+  return result;
+}
+
+/// Index of the interval of _breakpoints which contains _t, the first and
+/// last intervals extended to infinity
+std::size_t interval_of(const Eigen::VectorXd& _breakpoints, double _t) {
+  const double* first = _breakpoints.data() + 1;
+  const double* last = _breakpoints.data() + _breakpoints.size() - 1;
+  return static_cast<std::size_t>(std::upper_bound(first, last, _t) - first);
+}
+
+/// Values at _points of the polynomial of the interval _interval of
+/// _gspline, which is evaluated also outside of the interval
+Eigen::MatrixXd interval_values(const GSplineBase& _gspline,
+                                const Eigen::VectorXd& _breakpoints,
+                                std::size_t _interval,
+                                const Eigen::VectorXd& _points) {
+  const basis::Basis& basis = _gspline.get_basis();
+  const long dim = static_cast<long>(basis.get_dim());
+  const long codom_dim = static_cast<long>(_gspline.get_codom_dim());
+  const long interval = static_cast<long>(_interval);
+  const double tau = _gspline.get_interval_lengths()(interval);
+
+  Eigen::VectorXd buffer(dim);
+  Eigen::MatrixXd result(_points.size(), codom_dim);
+  for (long k = 0; k < _points.size(); k++) {
+    const double s = 2.0 * (_points(k) - _breakpoints(interval)) / tau - 1.0;
+    basis.eval_on_window(s, tau, buffer);
+    for (long j = 0; j < codom_dim; j++) {
+      result(k, j) = _gspline.get_coefficients()
+                         .segment(interval * dim * codom_dim + dim * j, dim)
+                         .dot(buffer);
+    }
+  }
+  return result;
+}
+
+/// Polynomial basis of dimension _dim of the same family as _basis
+std::unique_ptr<basis::Basis> polynomial_basis(const basis::Basis& _basis,
+                                               std::size_t _dim) {
+  if (dynamic_cast<const basis::BasisLegendre*>(&_basis) != nullptr) {
+    return std::make_unique<basis::BasisLegendre>(_dim);
+  }
+  return std::make_unique<basis::BasisLagrangeGaussLobatto>(_dim);
+}
+
+/// Sorted breakpoints without the ones closer than _tol to the previous one
+std::vector<double> merge_breakpoints(std::vector<double>&& _breakpoints,
+                                      double _tol) {
+  std::sort(_breakpoints.begin(), _breakpoints.end());
+  _breakpoints.erase(
+      std::unique(_breakpoints.begin(), _breakpoints.end(),
+                  [_tol](double _t0, double _t1) { return _t1 - _t0 <= _tol; }),
+      _breakpoints.end());
+  return std::move(_breakpoints);
+}
+
+/// GSpline which interpolates on each interval between _breakpoints the
+/// polynomial returned by _values(points), at as many Gauss-Lobatto points as
+/// the dimension of _basis. It is exact if the polynomials have at most the
+/// degree of the basis.
+template <typename Values>
+GSpline interpolate_intervals(std::pair<double, double> _domain,
+                              std::size_t _codom_dim,
+                              const basis::Basis& _basis,
+                              std::vector<double> _breakpoints,
+                              const Values& _values, const std::string& _name) {
+  _breakpoints.front() = _domain.first;
+  _breakpoints.back() = _domain.second;
+
+  const long dim = static_cast<long>(_basis.get_dim());
+  const long codom_dim = static_cast<long>(_codom_dim);
+  const long number_of_intervals = static_cast<long>(_breakpoints.size()) - 1;
+  const Eigen::VectorXd nodes =
+      collocation::legendre_gauss_lobatto_points(_basis.get_dim());
+
+  Eigen::MatrixXd basis_values(dim, dim);
+  Eigen::VectorXd buffer(dim);
+  for (long k = 0; k < dim; k++) {
+    _basis.eval_on_window(nodes(k), 2.0, buffer);
+    basis_values.row(k) = buffer.transpose();
+  }
+  const Eigen::PartialPivLU<Eigen::MatrixXd> solver(basis_values);
+
+  Eigen::VectorXd coefficients(number_of_intervals * dim * codom_dim);
+  Eigen::VectorXd interval_lengths(number_of_intervals);
+  for (long i = 0; i < number_of_intervals; i++) {
+    const double t0 = _breakpoints[static_cast<std::size_t>(i)];
+    interval_lengths(i) = _breakpoints[static_cast<std::size_t>(i) + 1] - t0;
+    const Eigen::VectorXd points =
+        t0 + (nodes.array() + 1.0) * interval_lengths(i) / 2.0;
+    // The coefficients of each component are contiguous
+    Eigen::Map<Eigen::MatrixXd>(coefficients.data() + i * dim * codom_dim, dim,
+                                codom_dim) =
+        solver.solve(_values(points));
+  }
+  return GSpline(_domain, _codom_dim,
+                 static_cast<std::size_t>(number_of_intervals), _basis,
+                 std::move(coefficients), std::move(interval_lengths), _name);
+}
+
+/// Throws if _second cannot follow _first in a single GSpline
+void concatenation_throw(const GSplineBase& _first,
+                         const GSplineBase& _second) {
+  if (_first.get_basis() != _second.get_basis() or
+      _first.get_codom_dim() != _second.get_codom_dim()) {
+    throw std::invalid_argument(
+        "Cannot concatenate GSplines of different bases or codomains");
+  }
+  if (std::abs(_first.get_domain().second - _second.get_domain().first) >
+      functions::FunctionBase::dom_tollerance_) {
+    throw std::invalid_argument("GSplines are not next each other");
+  }
+}
+}  // namespace
+
+Eigen::VectorXd GSplineBase::max_abs_derivative(std::size_t _deg,
+                                                double _dt) const {
+  Eigen::VectorXd result = Eigen::VectorXd::Zero(get_codom_dim());
+
+  if (has_polynomial_basis()) {
+    const Eigen::MatrixXd to_monomial = monomial_coefficients_matrix(*basis_);
+    for (std::size_t i = 0; i < get_number_of_intervals(); i++) {
+      const double scale = std::pow(
+          2.0 / domain_interval_lengths_(static_cast<long>(i)), _deg);
+      for (std::size_t j = 0; j < get_codom_dim(); j++) {
+        Eigen::VectorXd coeff = to_monomial * coefficient_segment(i, j);
+        for (std::size_t d = 0; d < _deg; d++) {
+          coeff = monomial_derivative(coeff);
+        }
+        result(static_cast<long>(j)) =
+            std::max(result(static_cast<long>(j)),
+                     scale * max_abs_on_window(coeff));
+      }
+    }
+    return result;
+  }
+
+  if (_dt < 1.0e-8) {
+    throw std::invalid_argument("dt cannot be negative or too small");
+  }
+  const std::size_t number_of_segments =
+      static_cast<std::size_t>(get_domain_length() / _dt);
+  const Eigen::VectorXd time_spam =
+      Eigen::VectorXd::LinSpaced(static_cast<long>(number_of_segments) + 1,
+                                 get_domain().first, get_domain().second);
+  const Eigen::MatrixXd evaluated = (*deriv(_deg))(time_spam);
+  return evaluated.array().abs().colwise().maxCoeff().transpose();
+}
+
+bool GSplineBase::has_polynomial_basis() const {
+  return dynamic_cast<const basis::BasisLegendre*>(basis_.get()) != nullptr or
+         dynamic_cast<const basis::BasisLagrange*>(basis_.get()) != nullptr;
+}
+
 bool GSplineBase::same_vector_space(const GSplineBase& _that) const {
   return get_basis() == _that.get_basis() and
          get_codom_dim() == _that.get_codom_dim() and
@@ -221,6 +482,159 @@ GSpline operator-(GSpline&& _that) {
   return std::move(_that);
 }
 
+GSpline gspline_product(const GSplineBase& _lhs, const GSplineBase& _rhs) {
+  if (not _lhs.has_polynomial_basis() or not _rhs.has_polynomial_basis()) {
+    throw std::invalid_argument(
+        "The product of GSplines requires polynomial bases");
+  }
+  const double tol = 1.0e-10 * _lhs.get_domain_length();
+  if (std::abs(_lhs.get_domain().first - _rhs.get_domain().first) > tol or
+      std::abs(_lhs.get_domain().second - _rhs.get_domain().second) > tol) {
+    throw std::invalid_argument("Cannot multiply GSplines of different domains");
+  }
+  if (_lhs.get_codom_dim() != 1 and _rhs.get_codom_dim() != 1) {
+    throw std::invalid_argument("At most one factor can be vector valued");
+  }
+
+  const Eigen::VectorXd lhs_breakpoints = _lhs.get_domain_breakpoints();
+  const Eigen::VectorXd rhs_breakpoints = _rhs.get_domain_breakpoints();
+  std::vector<double> breakpoints(
+      lhs_breakpoints.data(), lhs_breakpoints.data() + lhs_breakpoints.size());
+  breakpoints.insert(breakpoints.end(), rhs_breakpoints.data(),
+                     rhs_breakpoints.data() + rhs_breakpoints.size());
+
+  const auto values = [&](const Eigen::VectorXd& _points) {
+    const double middle = 0.5 * (_points(0) + _points(_points.size() - 1));
+    Eigen::MatrixXd lhs =
+        interval_values(_lhs, lhs_breakpoints,
+                        interval_of(lhs_breakpoints, middle), _points);
+    Eigen::MatrixXd rhs =
+        interval_values(_rhs, rhs_breakpoints,
+                        interval_of(rhs_breakpoints, middle), _points);
+    if (lhs.cols() == 1) {
+      rhs.array().colwise() *= lhs.col(0).array();
+      return rhs;
+    }
+    lhs.array().colwise() *= rhs.col(0).array();
+    return lhs;
+  };
+  const std::unique_ptr<basis::Basis> basis = polynomial_basis(
+      _lhs.get_basis(),
+      _lhs.get_basis().get_dim() + _rhs.get_basis().get_dim() - 1);
+  return interpolate_intervals(
+      _lhs.get_domain(), std::max(_lhs.get_codom_dim(), _rhs.get_codom_dim()),
+      *basis, merge_breakpoints(std::move(breakpoints), tol), values,
+      _lhs.get_name());
+}
+
+GSpline gspline_composition(const GSplineBase& _outer,
+                            const GSplineBase& _inner) {
+  if (not _outer.has_polynomial_basis() or not _inner.has_polynomial_basis()) {
+    throw std::invalid_argument(
+        "The composition of GSplines requires polynomial bases");
+  }
+  if (_inner.get_codom_dim() != 1) {
+    throw std::invalid_argument("The inner GSpline must be scalar");
+  }
+
+  const Eigen::VectorXd inner_breakpoints = _inner.get_domain_breakpoints();
+  const Eigen::VectorXd outer_breakpoints = _outer.get_domain_breakpoints();
+  std::vector<double> breakpoints(
+      inner_breakpoints.data(),
+      inner_breakpoints.data() + inner_breakpoints.size());
+
+  // Points where the inner GSpline crosses a breakpoint of the outer one,
+  // its domain bounds included
+  const Eigen::MatrixXd to_monomial =
+      monomial_coefficients_matrix(_inner.get_basis());
+  const long dim = static_cast<long>(_inner.get_basis().get_dim());
+  for (long i = 0; i < static_cast<long>(_inner.get_number_of_intervals());
+       i++) {
+    Eigen::VectorXd coeff =
+        to_monomial * _inner.get_coefficients().segment(i * dim, dim);
+    for (long k = 0; k < outer_breakpoints.size(); k++) {
+      coeff(0) -= outer_breakpoints(k);
+      const Eigen::VectorXcd roots = monomial_roots(coeff);
+      coeff(0) += outer_breakpoints(k);
+      for (long r = 0; r < roots.size(); r++) {
+        const double s = roots(r).real();
+        if (std::abs(roots(r).imag()) <= 1.0e-8 and std::abs(s) < 1.0) {
+          breakpoints.push_back(inner_breakpoints(i) +
+                                (s + 1.0) * _inner.get_interval_lengths()(i) /
+                                    2.0);
+        }
+      }
+    }
+  }
+
+  const double outer_tol = 1.0e-8 * _outer.get_domain_length();
+  const auto values = [&](const Eigen::VectorXd& _points) {
+    Eigen::VectorXd middle(1);
+    middle(0) = 0.5 * (_points(0) + _points(_points.size() - 1));
+    const std::size_t inner_interval = interval_of(inner_breakpoints, middle(0));
+    const double inner_middle =
+        interval_values(_inner, inner_breakpoints, inner_interval, middle)(0);
+    if (inner_middle < _outer.get_domain().first - outer_tol or
+        inner_middle > _outer.get_domain().second + outer_tol) {
+      throw std::invalid_argument(
+          "The range of the inner GSpline is not in the domain of the outer "
+          "one");
+    }
+    const Eigen::VectorXd inner =
+        interval_values(_inner, inner_breakpoints, inner_interval, _points);
+    return interval_values(_outer, outer_breakpoints,
+                           interval_of(outer_breakpoints, inner_middle), inner);
+  };
+  const std::unique_ptr<basis::Basis> basis = polynomial_basis(
+      _outer.get_basis(), (_outer.get_basis().get_dim() - 1) *
+                                  (_inner.get_basis().get_dim() - 1) +
+                              1);
+  return interpolate_intervals(
+      _inner.get_domain(), _outer.get_codom_dim(), *basis,
+      merge_breakpoints(std::move(breakpoints),
+                        1.0e-10 * _inner.get_domain_length()),
+      values, _outer.get_name());
+}
+
+void GSplineBase::append(const GSplineBase& _that) {
+  concatenation_throw(*this, _that);
+
+  const long num_coefficients = coefficients_.size();
+  const long num_intervals = domain_interval_lengths_.size();
+  coefficients_.conservativeResize(num_coefficients +
+                                   _that.coefficients_.size());
+  coefficients_.tail(_that.coefficients_.size()) = _that.coefficients_;
+  domain_interval_lengths_.conservativeResize(
+      num_intervals + _that.domain_interval_lengths_.size());
+  domain_interval_lengths_.tail(_that.domain_interval_lengths_.size()) =
+      _that.domain_interval_lengths_;
+  set_domain(get_domain().first, _that.get_domain().second);
+}
+
+GSpline gspline_concatenation(const GSplineBase& _first,
+                              const GSplineBase& _second) {
+  concatenation_throw(_first, _second);
+
+  const Eigen::VectorXd& first_coefficients = _first.get_coefficients();
+  const Eigen::VectorXd& second_coefficients = _second.get_coefficients();
+  Eigen::VectorXd coefficients(first_coefficients.size() +
+                               second_coefficients.size());
+  coefficients << first_coefficients, second_coefficients;
+
+  const Eigen::VectorXd& first_lengths = _first.get_interval_lengths();
+  const Eigen::VectorXd& second_lengths = _second.get_interval_lengths();
+  Eigen::VectorXd interval_lengths(first_lengths.size() +
+                                   second_lengths.size());
+  interval_lengths << first_lengths, second_lengths;
+
+  return GSpline({_first.get_domain().first, _second.get_domain().second},
+                 _first.get_codom_dim(),
+                 _first.get_number_of_intervals() +
+                     _second.get_number_of_intervals(),
+                 _first.get_basis(), std::move(coefficients),
+                 std::move(interval_lengths), _first.get_name());
+}
+
 GSpline random_gspline(std::pair<double, double> _domain,
                        std::size_t _codom_dim) {
   return random_gspline(_domain, _codom_dim, basis::BasisLegendre(6));
@@ -1,8 +1,12 @@
-#include <eigen3/Eigen/SparseLU>
 #include <gsplines/Basis/BasisLegendre.hpp>
 #include <gsplines/Interpolator.hpp>
+#include <gsplines/Tools.hpp>
+#include <exception>
 #include <iostream>
+#include <map>
+#include <optional>
 #include <stdexcept>
+#include <utility>
 
 namespace gsplines {
 
@@ -11,7 +15,8 @@ Interpolator::Interpolator(std::size_t _codom_dim, std::size_t _num_intervals,
     : basis_(_basis.clone()), codom_dim_(_codom_dim),
       num_intervals_(_num_intervals),
       matrix_size_(_basis.get_dim() * _codom_dim * _num_intervals),
-      boundary_buffer_tranposed_(_basis.get_dim(), _basis.get_dim() / 2) {
+      boundary_buffer_tranposed_(_basis.get_dim(), _basis.get_dim() / 2),
+      pattern_analyzed_(false), transposed_pattern_analyzed_(false) {
 
   if (basis_->get_dim() % 2 != 0) {
     throw std::invalid_argument(
@@ -21,6 +26,8 @@ Interpolator::Interpolator(std::size_t _codom_dim, std::size_t _num_intervals,
   interpolating_vector_.resize(matrix_size_);
   interpolating_vector_.setZero();
   coefficients_vector_.resize(matrix_size_);
+  sol_buffer_.resize(matrix_size_);
+  solve_buffer_.resize(matrix_size_);
 
   derivative_buffer_tranposed_.resize(basis_->get_dim(), basis_->get_dim() - 2);
 
@@ -111,17 +118,23 @@ void Interpolator::fill_interpolating_matrix(
 }
 void Interpolator::fill_interpolating_vector(
     const Eigen::Ref<const Eigen::MatrixXd> _waypoints) {
+  fill_interpolating_vector(_waypoints, interpolating_vector_);
+}
+
+void Interpolator::fill_interpolating_vector(
+    const Eigen::Ref<const Eigen::MatrixXd> _waypoints,
+    Eigen::Ref<Eigen::VectorXd> _vector) const {
 
   unsigned int interval_coor = 0;
   unsigned int codom_coor = 0;
   unsigned int vector_coor = 0;
   for (codom_coor = 0; codom_coor < codom_dim_; codom_coor++) {
-    interpolating_vector_(vector_coor) = _waypoints(0, codom_coor);
+    _vector(vector_coor) = _waypoints(0, codom_coor);
     vector_coor++;
   }
   vector_coor += codom_dim_ * (basis_->get_dim() / 2 - 1);
   for (codom_coor = 0; codom_coor < codom_dim_; codom_coor++) {
-    interpolating_vector_(vector_coor) = _waypoints(1, codom_coor);
+    _vector(vector_coor) = _waypoints(1, codom_coor);
     vector_coor++;
   }
   if (num_intervals_ == 1) {
@@ -130,25 +143,22 @@ void Interpolator::fill_interpolating_vector(
   vector_coor += codom_dim_ * (basis_->get_dim() - 2);
   for (interval_coor = 1; interval_coor < num_intervals_ - 1; interval_coor++) {
     for (codom_coor = 0; codom_coor < codom_dim_; codom_coor++) {
-      interpolating_vector_(vector_coor) =
-          _waypoints(interval_coor, codom_coor);
+      _vector(vector_coor) = _waypoints(interval_coor, codom_coor);
       vector_coor++;
     }
     for (codom_coor = 0; codom_coor < codom_dim_; codom_coor++) {
-      interpolating_vector_(vector_coor) =
-          _waypoints(interval_coor + 1, codom_coor);
+      _vector(vector_coor) = _waypoints(interval_coor + 1, codom_coor);
       vector_coor++;
     }
     vector_coor += codom_dim_ * (basis_->get_dim() - 2);
   }
   for (codom_coor = 0; codom_coor < codom_dim_; codom_coor++) {
-    interpolating_vector_(vector_coor) =
-        _waypoints(num_intervals_ - 1, codom_coor);
+    _vector(vector_coor) = _waypoints(num_intervals_ - 1, codom_coor);
     vector_coor++;
   }
   vector_coor += codom_dim_ * (basis_->get_dim() / 2 - 1);
   for (codom_coor = 0; codom_coor < codom_dim_; codom_coor++) {
-    interpolating_vector_(vector_coor) = _waypoints(num_intervals_, codom_coor);
+    _vector(vector_coor) = _waypoints(num_intervals_, codom_coor);
     vector_coor++;
   }
 }
@@ -164,6 +174,55 @@ GSpline Interpolator::interpolate(
                  *basis_, vector_resut, _interval_lengths);
 }
 
+std::vector<GSpline> Interpolator::interpolate_batch(
+    const Eigen::Ref<const Eigen::VectorXd> _interval_lengths,
+    const std::vector<Eigen::MatrixXd> &_waypoints_batch) {
+
+  const Eigen::Ref<const Eigen::MatrixXd> solutions =
+      solve_interpolation_batch(_interval_lengths, _waypoints_batch);
+
+  std::vector<GSpline> result;
+  result.reserve(_waypoints_batch.size());
+  for (long k = 0; k < solutions.cols(); k++) {
+    result.emplace_back(std::pair<double, double>{0.0, _interval_lengths.sum()},
+                        codom_dim_, num_intervals_, *basis_, solutions.col(k),
+                        _interval_lengths);
+  }
+  return result;
+}
+
+const Eigen::Ref<const Eigen::MatrixXd> Interpolator::solve_interpolation_batch(
+    const Eigen::Ref<const Eigen::VectorXd> _interval_lengths,
+    const std::vector<Eigen::MatrixXd> &_waypoints_batch) {
+
+  if ((_interval_lengths.array() < 1.0e-6).any()) {
+    throw std::invalid_argument(" Interval lenghts cannot be negative !");
+  }
+  for (const Eigen::MatrixXd &waypoints : _waypoints_batch) {
+    if (waypoints.rows() != (long)num_intervals_ + 1 or
+        waypoints.cols() != (long)codom_dim_) {
+      throw std::invalid_argument(
+          "solve_interpolation_batch: waypoints do not have the required "
+          "dimensions");
+    }
+  }
+  // 1. fill and factorize the interpolating matrix
+  if (not factorize_interpolating_matrix(_interval_lengths)) {
+    throw std::runtime_error(
+        "solve_interpolation_batch: cannot factorize the interpolating "
+        "matrix: " +
+        solver_.lastErrorMessage());
+  }
+  // 2. fill one right hand side per set of waypoints
+  batch_rhs_buffer_.setZero(matrix_size_, _waypoints_batch.size());
+  for (std::size_t k = 0; k < _waypoints_batch.size(); k++) {
+    fill_interpolating_vector(_waypoints_batch[k], batch_rhs_buffer_.col(k));
+  }
+  // 3. Solve all the interpolation problems at once
+  batch_sol_buffer_ = solver_.solve(batch_rhs_buffer_);
+  return batch_sol_buffer_;
+}
+
 void Interpolator::print_interpolating_matrix() {
   Eigen::IOFormat CleanFmt(4, 0, ", ", "\n", "[", "],");
   std::cout << Eigen::MatrixXd(interpolating_matrix_).format(CleanFmt) << '\n';
@@ -252,121 +311,329 @@ void Interpolator::fill_buffers_deriv_wrt_tau(double s, double tau) {
   }
 }
 
-Eigen::Ref<const Eigen::VectorXd> Interpolator::get_coeff_derivative_wrt_tau(
-    Eigen::Ref<const Eigen::VectorXd> _coeff,
-    Eigen::Ref<const Eigen::VectorXd> _interval_lengths, std::size_t _tau_idx) {
+void Interpolator::fill_buffers_second_deriv_wrt_tau(double s, double tau) {
 
-  if ((_interval_lengths.array() < 1.0e-6).any()) {
-    throw std::invalid_argument(
-        "get_coeff_derivative_wrt_tau: Interval lenghts cannot be negative !");
-  }
-  if (_interval_lengths.size() != (long)num_intervals_ or _tau_idx < 0 or
-      _tau_idx >= num_intervals_) {
-    fprintf(stderr, "Cannot compute derivative of coefficients wrt tau ");
-    return coefficients_vector_;
+  basis_->eval_second_derivative_wrt_tau_on_window(s, tau, 0,
+                                                   position_buffer_);
+
+  for (unsigned int der = 0; der < basis_->get_dim() - 2; der++) {
+    basis_->eval_second_derivative_wrt_tau_on_window(
+        s, tau, der + 1, derivative_buffer_tranposed_.col(der));
   }
+}
+
+void Interpolator::fill_interval_block(std::size_t _interval,
+                                       double _interval_length,
+                                       std::size_t _tau_deriv_order,
+                                       Eigen::SparseMatrix<double> &_mat) {
 
-  Eigen::SparseMatrix<double> &mat = interpolation_matrix_ders_[_tau_idx];
+  auto fill = [this, _interval_length, _tau_deriv_order](double _s) {
+    switch (_tau_deriv_order) {
+    case 0:
+      fill_buffers(_s, _interval_length);
+      break;
+    case 1:
+      fill_buffers_deriv_wrt_tau(_s, _interval_length);
+      break;
+    case 2:
+      fill_buffers_second_deriv_wrt_tau(_s, _interval_length);
+      break;
+    default:
+      throw std::invalid_argument(
+          "fill_interval_block: derivative order not supported");
+    }
+  };
   unsigned int i0 = 0;
   unsigned int j0 = 0;
-  if (_tau_idx == 0) {
+  if (_interval == 0) {
+    fill(-1.0);
 
-    fill_buffers_deriv_wrt_tau(-1.0, _interval_lengths(0));
-
-    fill_position_block(i0, j0, mat);
+    fill_position_block(i0, j0, _mat);
     i0 += codom_dim_;
 
-    fill_boundary_derivative_block(i0, j0, mat);
+    fill_boundary_derivative_block(i0, j0, _mat);
     i0 += codom_dim_ * (basis_->get_dim() / 2 - 1);
 
-    fill_buffers_deriv_wrt_tau(1.0, _interval_lengths(0));
+    fill(1.0);
 
-    fill_position_block(i0, j0, mat);
+    fill_position_block(i0, j0, _mat);
     i0 += codom_dim_;
 
     if (num_intervals_ == 1) {
-      fill_boundary_derivative_block(i0, j0, mat);
+      fill_boundary_derivative_block(i0, j0, _mat);
     } else {
-      fill_continuity_derivative_block(i0, j0, false, mat);
+      fill_continuity_derivative_block(i0, j0, false, _mat);
     }
-  } else if (0 < _tau_idx and _tau_idx < num_intervals_ - 1) {
+  } else if (0 < _interval and _interval < num_intervals_ - 1) {
 
     // rows added in the first interval
     i0 = 2 * codom_dim_ + codom_dim_ * (basis_->get_dim() / 2 - 1);
 
     i0 += (codom_dim_ * (basis_->get_dim() - 2) + 2 * codom_dim_) *
-          (_tau_idx - 1);
+          (_interval - 1);
 
-    j0 = _tau_idx * basis_->get_dim() * codom_dim_;
+    j0 = _interval * basis_->get_dim() * codom_dim_;
 
-    fill_buffers_deriv_wrt_tau(-1.0, _interval_lengths(_tau_idx));
+    fill(-1.0);
 
-    fill_continuity_derivative_block(i0, j0, true, mat);
+    fill_continuity_derivative_block(i0, j0, true, _mat);
     i0 += codom_dim_ * (basis_->get_dim() - 2);
 
-    fill_position_block(i0, j0, mat);
+    fill_position_block(i0, j0, _mat);
     i0 += codom_dim_;
 
-    fill_buffers_deriv_wrt_tau(1.0, _interval_lengths(_tau_idx));
+    fill(1.0);
 
-    fill_position_block(i0, j0, mat);
+    fill_position_block(i0, j0, _mat);
     i0 += codom_dim_;
 
-    fill_continuity_derivative_block(i0, j0, false, mat);
+    fill_continuity_derivative_block(i0, j0, false, _mat);
 
-  } else if (_tau_idx == num_intervals_ - 1) {
+  } else if (_interval == num_intervals_ - 1) {
 
     i0 = (basis_->get_dim() / 2 + 1) * codom_dim_ +
-         basis_->get_dim() * codom_dim_ * (_tau_idx - 1);
+         basis_->get_dim() * codom_dim_ * (_interval - 1);
 
-    j0 = _tau_idx * basis_->get_dim() * codom_dim_;
+    j0 = _interval * basis_->get_dim() * codom_dim_;
 
-    fill_buffers_deriv_wrt_tau(-1.0, _interval_lengths(num_intervals_ - 1));
+    fill(-1.0);
 
-    fill_continuity_derivative_block(i0, j0, true, mat);
+    fill_continuity_derivative_block(i0, j0, true, _mat);
     i0 += codom_dim_ * (basis_->get_dim() - 2);
 
-    fill_position_block(i0, j0, mat);
+    fill_position_block(i0, j0, _mat);
     i0 += codom_dim_;
 
-    fill_buffers_deriv_wrt_tau(1.0, _interval_lengths(num_intervals_ - 1));
-    fill_boundary_derivative_block(i0, j0, mat);
+    fill(1.0);
+    fill_boundary_derivative_block(i0, j0, _mat);
     i0 += codom_dim_ * (basis_->get_dim() / 2 - 1);
 
-    fill_position_block(i0, j0, mat);
+    fill_position_block(i0, j0, _mat);
+  }
+}
+
+const Eigen::SparseMatrix<double> &
+Interpolator::get_interpolating_matrix_derivative_wrt_tau(
+    Eigen::Ref<const Eigen::VectorXd> _interval_lengths, std::size_t _tau_idx,
+    std::size_t _order) {
+
+  if (_interval_lengths.size() != (long)num_intervals_ or
+      _tau_idx >= num_intervals_) {
+    throw std::invalid_argument("get_interpolating_matrix_derivative_wrt_tau: "
+                                "Wrong interval index or number of intervals");
   }
+  if (_order != 1 and _order != 2) {
+    throw std::invalid_argument("get_interpolating_matrix_derivative_wrt_tau: "
+                                "only first and second derivatives");
+  }
+  if (_order == 2 and interpolation_matrix_second_ders_.empty()) {
+    interpolation_matrix_second_ders_ = interpolation_matrix_ders_;
+  }
+  Eigen::SparseMatrix<double> &mat =
+      _order == 1 ? interpolation_matrix_ders_[_tau_idx]
+                  : interpolation_matrix_second_ders_[_tau_idx];
+  fill_interval_block(_tau_idx, _interval_lengths(_tau_idx), _order, mat);
   mat.makeCompressed();
-  coefficients_vector_.noalias() = mat * _coeff;
-  fill_interpolating_matrix(_interval_lengths);
-  Eigen::SparseLU<Eigen::SparseMatrix<double>> solver;
-  solver.compute(interpolating_matrix_);
-  coefficients_vector_ = -solver.solve(coefficients_vector_);
+  return mat;
+}
+
+Eigen::Ref<const Eigen::VectorXd> Interpolator::get_coeff_derivative_wrt_tau(
+    Eigen::Ref<const Eigen::VectorXd> _coeff,
+    Eigen::Ref<const Eigen::VectorXd> _interval_lengths, std::size_t _tau_idx) {
+
+  if ((_interval_lengths.array() < 1.0e-6).any()) {
+    throw std::invalid_argument(
+        "get_coeff_derivative_wrt_tau: Interval lenghts cannot be negative !");
+  }
+  if (_interval_lengths.size() != (long)num_intervals_ or _tau_idx < 0 or
+      _tau_idx >= num_intervals_) {
+    fprintf(stderr, "Cannot compute derivative of coefficients wrt tau ");
+    return coefficients_vector_;
+  }
+
+  coefficients_vector_.noalias() =
+      get_interpolating_matrix_derivative_wrt_tau(_interval_lengths, _tau_idx,
+                                                  1) *
+      _coeff;
+  factorize_interpolating_matrix(_interval_lengths);
+  solve_factorized(coefficients_vector_, coefficients_vector_);
+  coefficients_vector_ *= -1.0;
   return coefficients_vector_;
 }
+
+const Eigen::Ref<const Eigen::VectorXd> Interpolator::solve_transposed(
+    const Eigen::Ref<const Eigen::VectorXd> _interval_lengths,
+    const Eigen::Ref<const Eigen::VectorXd> _rhs) {
+
+  if (not factorize_interpolating_matrix(_interval_lengths)) {
+    throw std::runtime_error(
+        "solve_transposed: cannot factorize the interpolating matrix: " +
+        solver_.lastErrorMessage());
+  }
+  if (transposed_factorized_interval_lengths_.size() !=
+          _interval_lengths.size() or
+      (transposed_factorized_interval_lengths_.array() !=
+       _interval_lengths.array())
+          .any()) {
+    transposed_factorized_interval_lengths_.resize(0);
+    transposed_matrix_ = interpolating_matrix_.transpose();
+    transposed_matrix_.makeCompressed();
+    if (not transposed_pattern_analyzed_) {
+      transposed_solver_.analyzePattern(transposed_matrix_);
+      transposed_pattern_analyzed_ = true;
+    }
+    transposed_solver_.factorize(transposed_matrix_);
+    if (transposed_solver_.info() != Eigen::ComputationInfo::Success) {
+      throw std::runtime_error("solve_transposed: cannot factorize the "
+                               "transposed interpolating matrix: " +
+                               transposed_solver_.lastErrorMessage());
+    }
+    transposed_factorized_interval_lengths_ = _interval_lengths;
+  }
+  transposed_sol_buffer_ = transposed_solver_.solve(_rhs);
+  return transposed_sol_buffer_;
+}
+
+bool Interpolator::factorize_interpolating_matrix(
+    const Eigen::Ref<const Eigen::VectorXd> _interval_lengths) {
+
+  if (factorized_interval_lengths_.size() == _interval_lengths.size() and
+      (factorized_interval_lengths_.array() == _interval_lengths.array())
+          .all()) {
+    return true;
+  }
+  factorized_interval_lengths_.resize(0);
+
+  {
+    tools::ScopedTimer timer(timings_ ? &timings_->assembly : nullptr);
+    fill_interpolating_matrix(_interval_lengths);
+    interpolating_matrix_.makeCompressed();
+  }
+  {
+    tools::ScopedTimer timer(timings_ ? &timings_->factorization : nullptr);
+    if (not pattern_analyzed_) {
+      solver_.analyzePattern(interpolating_matrix_);
+      pattern_analyzed_ = true;
+    }
+    solver_.factorize(interpolating_matrix_);
+  }
+  if (timings_) {
+    timings_->factorizations++;
+  }
+  if (solver_.info() != Eigen::ComputationInfo::Success) {
+    return false;
+  }
+  factorized_interval_lengths_ = _interval_lengths;
+  return true;
+}
+
+bool Interpolator::update_interval_length(std::size_t _interval,
+                                          double _interval_length) {
+
+  if (_interval >= num_intervals_) {
+    throw std::invalid_argument(
+        "update_interval_length: Interval index out of range");
+  }
+  if (_interval_length < 1.0e-6) {
+    throw std::invalid_argument(
+        "update_interval_length: Interval lenghts cannot be negative !");
+  }
+  if (factorized_interval_lengths_.size() != (long)num_intervals_) {
+    throw std::logic_error("update_interval_length: the interpolating matrix "
+                           "has not been factorized");
+  }
+  if (factorized_interval_lengths_(_interval) == _interval_length) {
+    return true;
+  }
+  // The columns of the other intervals do not depend on this length, and
+  // the sparsity pattern does not change.
+  Eigen::VectorXd interval_lengths = std::move(factorized_interval_lengths_);
+  factorized_interval_lengths_.resize(0);
+  interval_lengths(_interval) = _interval_length;
+
+  {
+    tools::ScopedTimer timer(timings_ ? &timings_->assembly : nullptr);
+    fill_interval_block(_interval, _interval_length, 0, interpolating_matrix_);
+  }
+  {
+    tools::ScopedTimer timer(timings_ ? &timings_->factorization : nullptr);
+    solver_.factorize(interpolating_matrix_);
+  }
+  if (timings_) {
+    timings_->factorizations++;
+  }
+  if (solver_.info() != Eigen::ComputationInfo::Success) {
+    return false;
+  }
+  factorized_interval_lengths_ = std::move(interval_lengths);
+  return true;
+}
+
 const Eigen::Ref<const Eigen::VectorXd> Interpolator::solve_interpolation(
     const Eigen::Ref<const Eigen::VectorXd> _interval_lengths,
     const Eigen::Ref<const Eigen::MatrixXd> _waypoints) {
 
+  solve_interpolation(_interval_lengths, _waypoints, sol_buffer_);
+  return sol_buffer_;
+}
+
+void Interpolator::solve_interpolation(
+    const Eigen::Ref<const Eigen::VectorXd> _interval_lengths,
+    const Eigen::Ref<const Eigen::MatrixXd> _waypoints,
+    Eigen::Ref<Eigen::VectorXd> _result) {
+
   if ((_interval_lengths.array() < 1.0e-6).any()) {
     throw std::invalid_argument(" Interval lenghts cannot be negative !");
   }
-  // 1. fill the interpolating matrix
-  fill_interpolating_matrix(_interval_lengths);
+  if (_result.size() != (long)matrix_size_) {
+    throw std::invalid_argument(
+        "solve_interpolation: the result vector does not have the required "
+        "dimension");
+  }
+  // 1. fill and factorize the interpolating matrix
+  const bool factorized = factorize_interpolating_matrix(_interval_lengths);
+  tools::ScopedTimer timer(timings_ ? &timings_->solve : nullptr);
   // 2. fill the interpolating vector
   fill_interpolating_vector(_waypoints);
   // 3. Solve the interpolation problem
-  Eigen::SparseLU<Eigen::SparseMatrix<double>> solver;
-  solver.compute(interpolating_matrix_);
-  if (solver.info() != Eigen::ComputationInfo::Success) {
-    std::cerr << solver.lastErrorMessage() << "\n";
+  if (not factorized) {
+    std::cerr << solver_.lastErrorMessage() << "\n";
     print_info();
     std::cout << "interval lengths:\n" << _interval_lengths.transpose() << "\n";
     print_interpolating_matrix();
-    return sol_buffer_;
+    return;
   }
-  sol_buffer_ = solver.solve(interpolating_vector_);
-  // 4. Return the interpolating function
-  return sol_buffer_;
+  solve_factorized(interpolating_vector_, _result);
+}
+
+void Interpolator::interpolate(
+    const Eigen::Ref<const Eigen::VectorXd> _interval_lengths,
+    const Eigen::Ref<const Eigen::MatrixXd> _waypoints, GSpline &_result) {
+
+  GSplineBase &result = _result;
+  if (result.get_codom_dim() != codom_dim_ or
+      result.get_number_of_intervals() != num_intervals_ or
+      result.get_basis_dim() != basis_->get_dim() or
+      result.get_basis_name() != basis_->get_name()) {
+    throw std::invalid_argument(
+        "interpolate: the GSpline does not have the shape of the "
+        "interpolation problem");
+  }
+  solve_interpolation(_interval_lengths, _waypoints, result.coefficients_);
+  result.domain_interval_lengths_ = _interval_lengths;
+  result.set_domain(0.0, _interval_lengths.sum());
+}
+
+void Interpolator::solve_factorized(
+    const Eigen::Ref<const Eigen::VectorXd> _rhs,
+    Eigen::Ref<Eigen::VectorXd> _result) {
+  // Same steps as SparseLU::solve, on a buffer kept between calls instead
+  // of a new vector. The permutations are not applied in place because
+  // _result may alias _rhs.
+  solve_buffer_.noalias() = solver_.rowsPermutation() * _rhs;
+  solver_.matrixL().solveInPlace(solve_buffer_);
+  solver_.matrixU().solveInPlace(solve_buffer_);
+  _result.noalias() = solver_.colsPermutation().inverse() * solve_buffer_;
 }
 
 GSpline interpolate(const Eigen::Ref<const Eigen::VectorXd> _interval_lengths,
@@ -376,6 +643,77 @@ GSpline interpolate(const Eigen::Ref<const Eigen::VectorXd> _interval_lengths,
       .interpolate(_interval_lengths, _waypoints);
 }
 
+std::vector<GSpline>
+interpolate_batch(const Eigen::Ref<const Eigen::VectorXd> _interval_lengths,
+                  const std::vector<Eigen::MatrixXd> &_waypoints_batch,
+                  const basis::Basis &_basis) {
+  if (_waypoints_batch.empty()) {
+    return {};
+  }
+  return Interpolator(_waypoints_batch.front().cols(),
+                      _waypoints_batch.front().rows() - 1, _basis)
+      .interpolate_batch(_interval_lengths, _waypoints_batch);
+}
+
+std::vector<GSpline>
+interpolate_many(const std::vector<Eigen::VectorXd> &_interval_lengths,
+                 const std::vector<Eigen::MatrixXd> &_waypoints,
+                 const basis::Basis &_basis, std::size_t _num_threads) {
+
+  if (_interval_lengths.size() != _waypoints.size()) {
+    throw std::invalid_argument(
+        "interpolate_many: the number of interval lengths vectors and "
+        "waypoints matrices must be the same");
+  }
+  const std::size_t num_problems = _waypoints.size();
+
+  const std::size_t num_workers =
+      tools::worker_count(_num_threads, num_problems);
+
+  std::vector<std::optional<GSpline>> solutions(num_problems);
+  std::vector<std::exception_ptr> errors(num_problems);
+
+  // Each worker gets its own copy of the basis, cloned here before any thread
+  // starts, so that the basis caches are never shared, and its own
+  // Interpolator workspaces, one per problem shape (codomain dimension,
+  // number of intervals).
+  std::vector<std::unique_ptr<basis::Basis>> worker_basis;
+  for (std::size_t k = 0; k < num_workers; k++) {
+    worker_basis.push_back(_basis.clone());
+  }
+  std::vector<std::map<std::pair<std::size_t, std::size_t>,
+                       std::unique_ptr<Interpolator>>>
+      workspaces(num_workers);
+
+  tools::parallel_for(
+      num_problems, num_workers, [&](std::size_t _worker, std::size_t _idx) {
+        try {
+          const Eigen::MatrixXd &wp = _waypoints[_idx];
+          const std::pair<std::size_t, std::size_t> shape(wp.cols(),
+                                                          wp.rows() - 1);
+          std::unique_ptr<Interpolator> &inter = workspaces[_worker][shape];
+          if (not inter) {
+            inter = std::make_unique<Interpolator>(shape.first, shape.second,
+                                                   *worker_basis[_worker]);
+          }
+          solutions[_idx].emplace(
+              inter->interpolate(_interval_lengths[_idx], wp));
+        } catch (...) {
+          errors[_idx] = std::current_exception();
+        }
+      });
+
+  std::vector<GSpline> result;
+  result.reserve(num_problems);
+  for (std::size_t idx = 0; idx < num_problems; idx++) {
+    if (errors[idx]) {
+      std::rethrow_exception(errors[idx]);
+    }
+    result.push_back(std::move(solutions[idx].value()));
+  }
+  return result;
+}
+
 GSpline pw_polynomial_interpolation(
     const Eigen::Ref<const Eigen::VectorXd> _interval_lengths,
     const Eigen::Ref<const Eigen::MatrixXd> _waypoints, std::size_t _nc) {
@@ -0,0 +1,103 @@
+#include <gsplines/Basis/BasisLegendre.hpp>
+#include <gsplines/Optimization/batch_solver.hpp>
+#include <gsplines/Tools.hpp>
+#include <chrono>
+#include <exception>
+#include <memory>
+#include <stdexcept>
+
+namespace gsplines {
+namespace optimization {
+
+namespace {
+std::vector<BatchResult>
+solve_batch(const std::vector<Eigen::MatrixXd>& _waypoints,
+            const basis::Basis& _basis,
+            const std::vector<std::pair<std::size_t, double>>& _weights,
+            const std::vector<double>& _exec_times,
+            const BatchOptions& _options, bool _unit_exec_time) {
+
+  if (_waypoints.size() != _exec_times.size()) {
+    throw std::invalid_argument(
+        "optimal_sobolev_norm_batch: the number of waypoints matrices and "
+        "execution times must be the same");
+  }
+  const std::size_t num_problems = _waypoints.size();
+
+  const std::size_t num_workers =
+      tools::worker_count(_options.num_threads, num_problems);
+
+  std::vector<BatchResult> results(num_problems);
+
+  // Per worker copies of the basis and of the solver options, made before
+  // any thread starts.
+  std::vector<std::unique_ptr<basis::Basis>> worker_basis;
+  std::vector<IpoptSolverOptions> worker_options(num_workers,
+                                                 _options.ipopt_options);
+  for (std::size_t k = 0; k < num_workers; k++) {
+    worker_basis.push_back(_basis.clone());
+  }
+
+  tools::parallel_for(
+      num_problems, num_workers, [&](std::size_t _worker, std::size_t _idx) {
+        const basis::Basis& basis = *worker_basis[_worker];
+        const IpoptSolverOptions& ipopt_options = worker_options[_worker];
+        BatchResult& result = results[_idx];
+        result.worker = _worker;
+        const auto start = std::chrono::steady_clock::now();
+        try {
+          const Eigen::MatrixXd& wp = _waypoints[_idx];
+          const std::optional<GSpline> solution =
+              _options.backend == SolverBackend::IPOPT
+                  ? optimal_sobolev_norm(wp, basis, _weights,
+                                         _exec_times[_idx], ipopt_options)
+                  : optimal_sobolev_norm(wp, basis, _weights,
+                                         _exec_times[_idx], _options.backend);
+          if (not solution.has_value()) {
+            result.status = BatchStatus::NOT_SOLVED;
+          } else if (_unit_exec_time) {
+            result.solution.emplace(
+                solution->linear_scaling_new_execution_time(1.0));
+            result.status = BatchStatus::SOLVED;
+          } else {
+            result.solution.emplace(solution.value());
+            result.status = BatchStatus::SOLVED;
+          }
+        } catch (const std::exception& e) {
+          result.status = BatchStatus::FAILED;
+          result.message = e.what();
+        } catch (...) {
+          result.status = BatchStatus::FAILED;
+          result.message = "unknown exception";
+        }
+        result.solve_time = std::chrono::duration<double>(
+                                std::chrono::steady_clock::now() - start)
+                                .count();
+      });
+  return results;
+}
+}  // namespace
+
+std::vector<BatchResult> optimal_sobolev_norm_batch(
+    const std::vector<Eigen::MatrixXd>& _waypoints,
+    const basis::Basis& _basis,
+    const std::vector<std::pair<std::size_t, double>>& _weights,
+    const std::vector<double>& _exec_times, const BatchOptions& _options) {
+  return solve_batch(_waypoints, _basis, _weights, _exec_times, _options,
+                     false);
+}
+
+std::vector<BatchResult>
+minimum_jerk_path_batch(const std::vector<Eigen::MatrixXd>& _waypoints,
+                        const BatchOptions& _options) {
+  std::vector<double> exec_times;
+  exec_times.reserve(_waypoints.size());
+  for (const Eigen::MatrixXd& wp : _waypoints) {
+    exec_times.push_back(static_cast<double>(wp.rows() - 1));
+  }
+  return solve_batch(_waypoints, basis::BasisLegendre(6), {{3, 1.0}},
+                     exec_times, _options, true);
+}
+
+}  // namespace optimization
+}  // namespace gsplines
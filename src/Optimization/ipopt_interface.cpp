@@ -1,8 +1,44 @@
 #include <gsplines/Optimization/ipopt_interface.hpp>
+#include <stdexcept>
 
 namespace gsplines {
 namespace optimization {
 
+namespace {
+/// Interval lengths variable set, looked up once when a set is linked with
+/// the variables of the problem
+std::shared_ptr<TimeSegmentLenghtsVar>
+time_segment_lengths(const ifopt::Composite::Ptr& _variables) {
+  std::shared_ptr<TimeSegmentLenghtsVar> result =
+      std::dynamic_pointer_cast<TimeSegmentLenghtsVar>(
+          _variables->GetComponent("TimeSegmentLenghtsVar"));
+  if (result == nullptr) {
+    throw std::logic_error(
+        "The problem has not a TimeSegmentLenghtsVar variable set");
+  }
+  return result;
+}
+
+/// Row major sparse matrix storing all its entries, equal to _value
+ifopt::Component::Jacobian dense_jacobian(long _rows, long _cols,
+                                          double _value) {
+  ifopt::Component::Jacobian result(_rows, _cols);
+  result.reserve(Eigen::VectorXi::Constant(_rows, static_cast<int>(_cols)));
+  for (long i = 0; i < _rows; i++) {
+    for (long j = 0; j < _cols; j++) {
+      result.insert(i, j) = _value;
+    }
+  }
+  result.makeCompressed();
+  return result;
+}
+
+/// Values of a dense_jacobian, in row major order
+Eigen::Map<Eigen::VectorXd> jacobian_values(ifopt::Component::Jacobian& _jac) {
+  return Eigen::Map<Eigen::VectorXd>(_jac.valuePtr(), _jac.nonZeros());
+}
+}  // namespace
+
 TimeSegmentLenghtsVar::TimeSegmentLenghtsVar(std::size_t _num_intervals,
                                              double _exec_time)
     : VariableSet(static_cast<int>(_num_intervals), "TimeSegmentLenghtsVar"),
@@ -15,6 +51,12 @@ TimeSegmentLenghtsVar::TimeSegmentLenghtsVar(std::size_t _num_intervals,
   bounds_ = ifopt::Component::VecBound(GetRows(), default_bound);
 }
 
+TimeSegmentLenghtsVar::TimeSegmentLenghtsVar(
+    const Eigen::Ref<const Eigen::VectorXd>& _initial_values, double _exec_time)
+    : TimeSegmentLenghtsVar(_initial_values.size(), _exec_time) {
+  values_ = _initial_values;
+}
+
 void TimeSegmentLenghtsVar::SetVariables(const Eigen::VectorXd& _vec) {
   values_ = _vec;
 }
@@ -27,16 +69,22 @@ ifopt::Component::VecBound TimeSegmentLenghtsVar::GetBounds() const {
 
 ExecTimeConstraint::ExecTimeConstraint(std::size_t _num_intervals,
                                        double _exec_time)
-    : ConstraintSet(1, "ExecTimeConstraint"), values_(1) {
+    : ConstraintSet(1, "ExecTimeConstraint"),
+      values_(1),
+      jacobian_(dense_jacobian(1, static_cast<long>(_num_intervals), 1.0)) {
   ifopt::Bounds default_bound(_exec_time, _exec_time);
   bounds_ = ifopt::Component::VecBound(1, default_bound);
 }
 
+void ExecTimeConstraint::InitVariableDependedQuantities(
+    const VariablesPtr& _variables) {
+  time_var_ = time_segment_lengths(_variables);
+}
+
 Eigen::VectorXd ExecTimeConstraint::GetValues() const {
   Eigen::VectorXd result(1);
 
-  result(0) =
-      GetVariables()->GetComponent("TimeSegmentLenghtsVar")->GetValues().sum();
+  result(0) = time_var_->GetValuesRef().sum();
   return result;
 }
 ifopt::Component::VecBound ExecTimeConstraint::GetBounds() const {
@@ -46,11 +94,7 @@ ifopt::Component::VecBound ExecTimeConstraint::GetBounds() const {
 void ExecTimeConstraint::FillJacobianBlock(std::string _set_name,
                                            Jacobian& _jac_block) const {
   (void)_set_name;
-  for (unsigned int i = 0;
-       i < GetVariables()->GetComponent("TimeSegmentLenghtsVar")->GetRows();
-       i++) {
-    _jac_block.coeffRef(0, i) = 1.0;
-  }
+  _jac_block = jacobian_;
 }
 
 SobolevNorm::SobolevNorm(
@@ -63,27 +107,98 @@ SobolevNorm::SobolevNorm(
       weights_(_weights),
       waypoints_(_waypoints),
       sobol_norm_(_waypoints, _basis, _weights),
-      buff_1_(_waypoints.rows() - 1),
-      buff_2_(_waypoints.rows() - 1) {}
+      jacobian_(dense_jacobian(1, _waypoints.rows() - 1, 0.0)) {}
+
+void SobolevNorm::InitVariableDependedQuantities(
+    const VariablesPtr& _variables) {
+  time_var_ = time_segment_lengths(_variables);
+}
 
 double SobolevNorm::GetCost() const {
-  buff_1_.noalias() =
-      GetVariables()->GetComponent("TimeSegmentLenghtsVar")->GetValues();
-  return sobol_norm_(buff_1_);
+  return sobol_norm_(time_var_->GetValuesRef());
 }
 void SobolevNorm::FillJacobianBlock(std::string _var_set,
                                     Jacobian& _jac) const {
   (void)_var_set;
-  buff_1_.noalias() =
-      GetVariables()->GetComponent("TimeSegmentLenghtsVar")->GetValues();
+  sobol_norm_.deriv_wrt_interval_len(time_var_->GetValuesRef(),
+                                     jacobian_values(jacobian_));
+  _jac = jacobian_;
+}
 
-  sobol_norm_.deriv_wrt_interval_len(buff_1_, buff_2_);
+void SobolevNorm::FillHessianBlock(std::string _var_set,
+                                   Eigen::Ref<Eigen::MatrixXd> _hess) const {
+  (void)_var_set;
+  sobol_norm_.hessian_wrt_interval_len(time_var_->GetValuesRef(), _hess);
+}
+KinematicConstraintSet::KinematicConstraintSet(
+    const Eigen::Ref<const Eigen::MatrixXd>& _waypoints,
+    const gsplines::basis::Basis& _basis, std::size_t _samples_per_interval,
+    const std::optional<std::vector<double>>& _velocity_bounds,
+    const std::optional<std::vector<double>>& _acceleration_bounds)
+    : ConstraintSet(kSpecifyLater, "KinematicConstraints"),
+      constraints_(_waypoints, _basis, _samples_per_interval, _velocity_bounds,
+                   _acceleration_bounds) {
+  const std::size_t rows = constraints_.get_number_of_constraints();
+  SetRows(static_cast<int>(rows));
+  for (std::size_t r = 0; r < rows; r++) {
+    const double bound = constraints_.get_bounds()(r);
+    bounds_.emplace_back(-bound, bound);
+  }
+  values_.resize(rows);
+  dense_jacobian_.resize(rows, constraints_.get_number_of_intervals());
+  jacobian_ = dense_jacobian(
+      static_cast<long>(rows),
+      static_cast<long>(constraints_.get_number_of_intervals()), 0.0);
+}
+
+void KinematicConstraintSet::InitVariableDependedQuantities(
+    const VariablesPtr& _variables) {
+  time_var_ = time_segment_lengths(_variables);
+}
+
+Eigen::VectorXd KinematicConstraintSet::GetValues() const {
+  constraints_.values(time_var_->GetValuesRef(), values_);
+  return values_;
+}
+
+ifopt::Component::VecBound KinematicConstraintSet::GetBounds() const {
+  return bounds_;
+}
 
-  for (unsigned int i = 0;
-       i < GetVariables()->GetComponent("TimeSegmentLenghtsVar")->GetRows();
-       i++) {
-    _jac.coeffRef(0, i) = buff_2_(i);
+void KinematicConstraintSet::FillJacobianBlock(std::string _set_name,
+                                               Jacobian& _jac_block) const {
+  if (_set_name != "TimeSegmentLenghtsVar") {
+    return;
   }
+  constraints_.jacobian(time_var_->GetValuesRef(), dense_jacobian_);
+  Eigen::Map<Eigen::Matrix<double, Eigen::Dynamic, Eigen::Dynamic,
+                           Eigen::RowMajor>>(jacobian_.valuePtr(),
+                                             dense_jacobian_.rows(),
+                                             dense_jacobian_.cols()) =
+      dense_jacobian_;
+  _jac_block = jacobian_;
 }
+
+ExecutionTimeCost::ExecutionTimeCost(const std::string& _name)
+    : CostTerm(_name) {}
+
+void ExecutionTimeCost::InitVariableDependedQuantities(
+    const VariablesPtr& _variables) {
+  time_var_ = time_segment_lengths(_variables);
+  jacobian_ = dense_jacobian(1, time_var_->GetRows(), 1.0);
+}
+
+double ExecutionTimeCost::GetCost() const {
+  return time_var_->GetValuesRef().sum();
+}
+
+void ExecutionTimeCost::FillJacobianBlock(std::string var_set,
+                                          Jacobian& jac) const {
+  if (var_set != "TimeSegmentLenghtsVar") {
+    return;
+  }
+  jac = jacobian_;
+}
+
 }  // namespace optimization
 }  // namespace gsplines
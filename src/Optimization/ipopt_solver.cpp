@@ -3,209 +3,812 @@
 #include "gsplines/Collocation/GaussLobattoPointsWeights.hpp"
 #include <gsplines/Basis/BasisLegendre.hpp>
 #include <gsplines/Collocation/GaussLobattoLagrangeFunctionals.hpp>
+#include <gsplines/FunctionalAnalysis/Sobolev.hpp>
 #include <gsplines/GSpline.hpp>
 #include <gsplines/Interpolator.hpp>
 #include <gsplines/Optimization/ipopt_interface.hpp>
 #include <gsplines/Optimization/ipopt_solver.hpp>
+#include <IpIpoptApplication.hpp>
+#include <IpTNLP.hpp>
 #include <ifopt/ipopt_solver.h>
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <functional>
 #include <iostream>
+#include <limits>
 #include <memory>
+#include <stdexcept>
 
 namespace gsplines {
 namespace optimization {
 
-enum class IpoptReturnStatus : int {
-  Solve_Succeeded = 0,
-  Solved_To_Acceptable_Level = 1,
-  Infeasible_Problem_Detected = 2,
-  Search_Direction_Becomes_Too_Small = 3,
-  Diverging_Iterates = 4,
-  User_Requested_Stop = 5,
-  Feasible_Point_Found = 6,
-
-  Maximum_Iterations_Exceeded = -1,
-  Restoration_Failed = -2,
-  Error_In_Step_Computation = -3,
-  Maximum_CpuTime_Exceeded = -4,
-  Not_Enough_Degrees_Of_Freedom = -10,
-  Invalid_Problem_Definition = -11,
-  Invalid_Option = -12,
-  Invalid_Number_Detected = -13,
-
-  Unrecoverable_Exception = -100,
-  NonIpopt_Exception_Thrown = -101,
-  Insufficient_Memory = -102,
-  Internal_Error = -199
-};
-
 std::optional<IpoptSolverOptions> IpoptSolverOptions::instance_ = std::nullopt;
+std::mutex IpoptSolverOptions::instance_mutex_;
 
 IpoptSolverOptions::IpoptSolverOptions() = default;
 
+namespace {
+template <typename T>
+void set_option_value(std::vector<std::pair<std::string, T>>& _options,
+                      const std::string& _option_name, const T& _option_value) {
+  auto iter = std::find_if(
+      _options.begin(), _options.end(),
+      [&_option_name](const auto& in) { return in.first == _option_name; });
+
+  if (iter == _options.end()) {
+    _options.emplace_back(_option_name, _option_value);
+  } else {
+    iter->second = _option_value;
+  }
+}
+}  // namespace
+
+IpoptSolverOptions& IpoptSolverOptions::set(const std::string& _option_name,
+                                            const std::string& _option_value) {
+  set_option_value(string_options_, _option_name, _option_value);
+  return *this;
+}
+
+IpoptSolverOptions& IpoptSolverOptions::set(const std::string& _option_name,
+                                            int _option_value) {
+  set_option_value(int_options_, _option_name, _option_value);
+  return *this;
+}
+
+IpoptSolverOptions& IpoptSolverOptions::set(const std::string& _option_name,
+                                            double _option_value) {
+  set_option_value(double_options_, _option_name, _option_value);
+  return *this;
+}
+
+void IpoptSolverOptions::apply(ifopt::IpoptSolver& solver) const {
+  for (const auto& p : string_options_) {
+    solver.SetOption(p.first, p.second);
+  }
+
+  for (const auto& p : int_options_) {
+    solver.SetOption(p.first, p.second);
+  }
+
+  for (const auto& p : double_options_) {
+    solver.SetOption(p.first, p.second);
+  }
+}
+
+void IpoptSolverOptions::apply(Ipopt::IpoptApplication& _application) const {
+  for (const auto& p : string_options_) {
+    _application.Options()->SetStringValue(p.first, p.second);
+  }
+
+  for (const auto& p : int_options_) {
+    _application.Options()->SetIntegerValue(p.first, p.second);
+  }
+
+  for (const auto& p : double_options_) {
+    _application.Options()->SetNumericValue(p.first, p.second);
+  }
+}
+
+bool IpoptSolverOptions::exact_hessian() const {
+  return std::any_of(string_options_.begin(), string_options_.end(),
+                     [](const auto& in) {
+                       return in.first == "hessian_approximation" and
+                              in.second == "exact";
+                     });
+}
+
 IpoptSolverOptions& IpoptSolverOptions::instance() {
+  std::lock_guard<std::mutex> lock(instance_mutex_);
   if (!instance_.has_value()) {
     instance_ = IpoptSolverOptions();
   }
   return instance_.value();
 }
 
+IpoptSolverOptions IpoptSolverOptions::defaults() {
+  IpoptSolverOptions& options = instance();
+  std::lock_guard<std::mutex> lock(instance_mutex_);
+  return options;
+}
+
 void IpoptSolverOptions::set_option(const std::string& _option_name,
                                     const std::string& _option_value) {
-  auto iter = std::find_if(
-      instance().string_options_.begin(), instance().string_options_.end(),
-      [_option_name](const auto& in) { return in.first == _option_name; });
-
-  if (iter == instance().string_options_.end()) {
-    instance().string_options_.emplace_back(_option_name, _option_value);
-  } else {
-    iter->second = _option_value;
-  }
+  IpoptSolverOptions& options = instance();
+  std::lock_guard<std::mutex> lock(instance_mutex_);
+  options.set(_option_name, _option_value);
 }
 
 void IpoptSolverOptions::set_option(const std::string& _option_name,
                                     int _option_value) {
-  auto iter = std::find_if(
-      instance().int_options_.begin(), instance().int_options_.end(),
-      [_option_name](const auto& in) { return in.first == _option_name; });
-
-  if (iter == instance().int_options_.end()) {
-    instance().int_options_.emplace_back(_option_name, _option_value);
-  } else {
-    iter->second = _option_value;
-  }
+  IpoptSolverOptions& options = instance();
+  std::lock_guard<std::mutex> lock(instance_mutex_);
+  options.set(_option_name, _option_value);
 }
 
 void IpoptSolverOptions::set_option(const std::string& _option_name,
                                     double _option_value) {
-  auto iter = std::find_if(
-      instance().double_options_.begin(), instance().double_options_.end(),
-      [_option_name](const auto& in) { return in.first == _option_name; });
+  IpoptSolverOptions& options = instance();
+  std::lock_guard<std::mutex> lock(instance_mutex_);
+  options.set(_option_name, _option_value);
+}
 
-  if (iter == instance().double_options_.end()) {
-    instance().double_options_.emplace_back(_option_name, _option_value);
-  } else {
-    iter->second = _option_value;
+void IpoptSolverOptions::set_options_on_interface(ifopt::IpoptSolver& solver) {
+  defaults().apply(solver);
+}
+
+namespace {
+Eigen::VectorXd scaled_initial_interval_lengths(
+    const Eigen::Ref<const Eigen::VectorXd>& _initial_interval_lengths,
+    std::size_t _num_intervals, double _exec_time) {
+  if (_initial_interval_lengths.size() != (long)_num_intervals or
+      (_initial_interval_lengths.array() <= 0.0).any()) {
+    throw std::invalid_argument(
+        "optimal_sobolev_norm: the initial interval lengths must be "
+        "positive, one per interval");
   }
+  return _initial_interval_lengths *
+         (_exec_time / _initial_interval_lengths.sum());
 }
-void IpoptSolverOptions::set_options_on_interface(ifopt::IpoptSolver& solver) {
-  for (const auto& p : instance().string_options_) {
-    solver.SetOption(p.first, p.second);
+
+std::optional<::gsplines::GSpline> unit_execution_time(
+    const std::optional<::gsplines::GSpline>& _result) {
+  if (_result.has_value()) {
+    return _result.value().linear_scaling_new_execution_time(1.0);
   }
+  return std::nullopt;
+}
 
-  for (const auto& p : instance().int_options_) {
-    solver.SetOption(p.first, p.second);
+/**
+ * Called with the iteration number, the interval lengths and the cost of
+ * each iterate of IPOPT. IPOPT stops if it returns false.
+ */
+using IterateCallback =
+    std::function<bool(std::size_t, const Eigen::VectorXd&, double)>;
+
+/**
+ * IPOPT interface of an ifopt problem whose cost is a SobolevNorm and whose
+ * constraints are linear, as ifopt::IpoptAdapter but forwarding the exact
+ * Hessian of the cost and the iterates. The constraints do not contribute to
+ * the Hessian of the Lagrangian, which is dense: all its lower triangle is
+ * passed.
+ */
+class SobolevNormTNLP : public Ipopt::TNLP {
+ public:
+  using Index = Ipopt::Index;
+  using Number = Ipopt::Number;
+
+  /// IPOPT starts from the multipliers of _warm_start if it is not null
+  SobolevNormTNLP(ifopt::Problem& _nlp, const SobolevNorm& _cost,
+                  IterateCallback _on_iterate,
+                  const IpoptWarmStart* _warm_start)
+      : nlp_(_nlp),
+        cost_(_cost),
+        hessian_(_nlp.GetNumberOfOptimizationVariables(),
+                 _nlp.GetNumberOfOptimizationVariables()),
+        on_iterate_(std::move(_on_iterate)),
+        warm_start_(_warm_start) {}
+
+  /// Primal-dual point passed to finalize_solution
+  [[nodiscard]] const IpoptWarmStart& get_final_point() const {
+    return final_point_;
   }
 
-  for (const auto& p : instance().double_options_) {
-    solver.SetOption(p.first, p.second);
+  bool get_nlp_info(Index& _n, Index& _m, Index& _nnz_jac_g, Index& _nnz_h_lag,
+                    IndexStyleEnum& _index_style) override {
+    _n = nlp_.GetNumberOfOptimizationVariables();
+    _m = nlp_.GetNumberOfConstraints();
+    _nnz_jac_g = static_cast<Index>(nlp_.GetJacobianOfConstraints().nonZeros());
+    _nnz_h_lag = _n * (_n + 1) / 2;
+    _index_style = C_STYLE;
+    return true;
   }
-}
 
-std::optional<::gsplines::GSpline> optimal_sobolev_norm(
+  bool get_bounds_info(Index _n, Number* _x_l, Number* _x_u, Index _m,
+                       Number* _g_l, Number* _g_u) override {
+    const ifopt::Problem::VecBound variable_bounds =
+        nlp_.GetBoundsOnOptimizationVariables();
+    for (Index i = 0; i < _n; i++) {
+      _x_l[i] = variable_bounds[i].lower_;
+      _x_u[i] = variable_bounds[i].upper_;
+    }
+    const ifopt::Problem::VecBound constraint_bounds =
+        nlp_.GetBoundsOnConstraints();
+    for (Index i = 0; i < _m; i++) {
+      _g_l[i] = constraint_bounds[i].lower_;
+      _g_u[i] = constraint_bounds[i].upper_;
+    }
+    return true;
+  }
+
+  bool get_starting_point(Index _n, bool /*_init_x*/, Number* _x,
+                          bool _init_z, Number* _z_L, Number* _z_U, Index _m,
+                          bool _init_lambda, Number* _lambda) override {
+    Eigen::Map<Eigen::VectorXd>(_x, _n) = nlp_.GetVariableValues();
+    if ((_init_z or _init_lambda) and warm_start_ == nullptr) {
+      return false;
+    }
+    if (_init_z) {
+      Eigen::Map<Eigen::VectorXd>(_z_L, _n) =
+          warm_start_->lower_bound_multipliers;
+      Eigen::Map<Eigen::VectorXd>(_z_U, _n) =
+          warm_start_->upper_bound_multipliers;
+    }
+    if (_init_lambda) {
+      Eigen::Map<Eigen::VectorXd>(_lambda, _m) =
+          warm_start_->constraint_multipliers;
+    }
+    return true;
+  }
+
+  bool eval_f(Index /*_n*/, const Number* _x, bool /*_new_x*/,
+              Number& _obj_value) override {
+    _obj_value = nlp_.EvaluateCostFunction(_x);
+    return true;
+  }
+
+  bool eval_grad_f(Index _n, const Number* _x, bool /*_new_x*/,
+                   Number* _grad_f) override {
+    Eigen::Map<Eigen::VectorXd>(_grad_f, _n) =
+        nlp_.EvaluateCostFunctionGradient(_x);
+    return true;
+  }
+
+  bool eval_g(Index /*_n*/, const Number* _x, bool /*_new_x*/, Index _m,
+              Number* _g) override {
+    Eigen::Map<Eigen::VectorXd>(_g, _m) = nlp_.EvaluateConstraints(_x);
+    return true;
+  }
+
+  bool eval_jac_g(Index /*_n*/, const Number* _x, bool /*_new_x*/,
+                  Index /*_m*/, Index /*_nele_jac*/, Index* _i_row,
+                  Index* _j_col, Number* _values) override {
+    if (_values == nullptr) {
+      const ifopt::Problem::Jacobian jacobian =
+          nlp_.GetJacobianOfConstraints();
+      Index k = 0;
+      for (int i = 0; i < jacobian.outerSize(); i++) {
+        for (ifopt::Problem::Jacobian::InnerIterator it(jacobian, i); it;
+             ++it) {
+          _i_row[k] = static_cast<Index>(it.row());
+          _j_col[k] = static_cast<Index>(it.col());
+          k++;
+        }
+      }
+    } else {
+      nlp_.EvalNonzerosOfJacobian(_x, _values);
+    }
+    return true;
+  }
+
+  bool eval_h(Index _n, const Number* _x, bool /*_new_x*/, Number _obj_factor,
+              Index /*_m*/, const Number* /*_lambda*/, bool /*_new_lambda*/,
+              Index /*_nele_hess*/, Index* _i_row, Index* _j_col,
+              Number* _values) override {
+    Index k = 0;
+    if (_values == nullptr) {
+      for (Index i = 0; i < _n; i++) {
+        for (Index j = 0; j <= i; j++) {
+          _i_row[k] = i;
+          _j_col[k] = j;
+          k++;
+        }
+      }
+      return true;
+    }
+    nlp_.SetVariables(_x);
+    cost_.FillHessianBlock("TimeSegmentLenghtsVar", hessian_);
+    for (Index i = 0; i < _n; i++) {
+      for (Index j = 0; j <= i; j++) {
+        _values[k] = _obj_factor * hessian_(i, j);
+        k++;
+      }
+    }
+    return true;
+  }
+
+  /**
+   * Records the iterates as ifopt::IpoptAdapter does and passes them to the
+   * iterate callback with the cost computed by IPOPT. As in the adapter, the
+   * current iterate is the last point where the problem was evaluated. The
+   * iterates of the restoration phase, whose cost is not the one of the
+   * problem, are not passed.
+   */
+  bool intermediate_callback(
+      Ipopt::AlgorithmMode _mode, Index _iter, Number _obj_value,
+      Number /*_inf_pr*/, Number /*_inf_du*/, Number /*_mu*/,
+      Number /*_d_norm*/, Number /*_regularization_size*/,
+      Number /*_alpha_du*/, Number /*_alpha_pr*/, Index /*_ls_trials*/,
+      const Ipopt::IpoptData* /*_ip_data*/,
+      Ipopt::IpoptCalculatedQuantities* /*_ip_cq*/) override {
+    nlp_.SaveCurrent();
+    if (not on_iterate_ or _mode != Ipopt::RegularMode) {
+      return true;
+    }
+    return on_iterate_(static_cast<std::size_t>(_iter),
+                       nlp_.GetVariableValues(), _obj_value);
+  }
+
+  void finalize_solution(
+      Ipopt::SolverReturn /*_status*/, Index _n, const Number* _x,
+      const Number* _z_L, const Number* _z_U, Index _m, const Number* /*_g*/,
+      const Number* _lambda, Number /*_obj_value*/,
+      const Ipopt::IpoptData* /*_ip_data*/,
+      Ipopt::IpoptCalculatedQuantities* /*_ip_cq*/) override {
+    nlp_.SetVariables(_x);
+    nlp_.SaveCurrent();
+    final_point_.interval_lengths = Eigen::Map<const Eigen::VectorXd>(_x, _n);
+    final_point_.lower_bound_multipliers =
+        Eigen::Map<const Eigen::VectorXd>(_z_L, _n);
+    final_point_.upper_bound_multipliers =
+        Eigen::Map<const Eigen::VectorXd>(_z_U, _n);
+    final_point_.constraint_multipliers =
+        Eigen::Map<const Eigen::VectorXd>(_lambda, _m);
+  }
+
+ private:
+  ifopt::Problem& nlp_;
+  const SobolevNorm& cost_;
+  Eigen::MatrixXd hessian_;
+  IterateCallback on_iterate_;
+  const IpoptWarmStart* warm_start_;
+  IpoptWarmStart final_point_;
+};
+
+/**
+ * Interval lengths minimizing the Sobolev norm, computed by IPOPT. The
+ * iterates are recorded in _statistics while IPOPT runs, IPOPT stops when
+ * _stop returns true. If _warm_start has multipliers, IPOPT starts from
+ * them. On success, _solution receives the primal-dual solution.
+ */
+std::optional<Eigen::VectorXd> ipopt_optimal_interval_lengths(
     const Eigen::Ref<const Eigen::MatrixXd>& _waypoints,
     const gsplines::basis::Basis& _basis,
     const std::vector<std::pair<std::size_t, double>>& _weights,
-    double _exec_time) {
-  ifopt::Problem nlp;
+    double _exec_time,
+    const Eigen::Ref<const Eigen::VectorXd>& _initial_interval_lengths,
+    const IpoptSolverOptions& _options, SolverStatistics* _statistics,
+    const std::function<bool()>& _stop,
+    const IpoptWarmStart* _warm_start = nullptr,
+    IpoptWarmStart* _solution = nullptr) {
   std::size_t num_intervals = _waypoints.rows() - 1;
-  std::size_t codom_dim = _waypoints.cols();
-  gsplines::Interpolator inter(codom_dim, num_intervals, _basis);
+  const Eigen::VectorXd initial_tau = scaled_initial_interval_lengths(
+      _initial_interval_lengths, num_intervals, _exec_time);
+  const bool warm_start_multipliers =
+      _warm_start != nullptr and _warm_start->has_multipliers();
+  if (warm_start_multipliers and
+      (_warm_start->lower_bound_multipliers.size() != (long)num_intervals or
+       _warm_start->upper_bound_multipliers.size() != (long)num_intervals or
+       _warm_start->constraint_multipliers.size() != 1)) {
+    throw std::invalid_argument(
+        "optimal_sobolev_norm: the warm start multipliers must have one "
+        "entry per interval and one per constraint");
+  }
+
+  if (_statistics != nullptr) {
+    _statistics->clear();
+  }
+  const auto start = std::chrono::steady_clock::now();
+  auto finish = [&](IpoptReturnStatus _status) {
+    if (_statistics == nullptr) {
+      return;
+    }
+    _statistics->return_status = _status;
+    _statistics->total_time =
+        std::chrono::duration<double>(std::chrono::steady_clock::now() - start)
+            .count();
+    _statistics->solver_time =
+        _statistics->total_time - _statistics->cost_time();
+  };
 
   if (num_intervals == 1) {
-    Eigen::VectorXd tauv_aux(1);
-    tauv_aux(0) = _exec_time;
-    return inter.interpolate(tauv_aux, _waypoints);
+    finish(IpoptReturnStatus::Solve_Succeeded);
+    if (_solution != nullptr) {
+      *_solution = IpoptWarmStart();
+      _solution->interval_lengths = Eigen::VectorXd::Constant(1, _exec_time);
+    }
+    return Eigen::VectorXd::Constant(1, _exec_time);
   }
 
   // 1. Build problem objects
   // 1.1 Variables
   std::shared_ptr<TimeSegmentLenghtsVar> variable(
-      new TimeSegmentLenghtsVar(num_intervals, _exec_time));
+      new TimeSegmentLenghtsVar(initial_tau, _exec_time));
   // 1.2 Constraints
   std::shared_ptr<ExecTimeConstraint> constraints(
       new ExecTimeConstraint(num_intervals, _exec_time));
   // 1.3 Cost Function
   std::shared_ptr<SobolevNorm> cost_function(
       new SobolevNorm("Name", _waypoints, _basis, _weights));
+  cost_function->set_timings(_statistics ? &_statistics->cost_timings
+                                         : nullptr);
 
   // 2. Use the problem objects to build the problem
+  ifopt::Problem nlp;
   nlp.AddVariableSet(variable);
   nlp.AddConstraintSet(constraints);
   nlp.AddCostSet(cost_function);
-  // nlp.PrintCurrent();
 
-  // 3. Instantiate ipopt solver
-  ifopt::IpoptSolver ipopt;
+  // 3. Solve the problem. ifopt's IPOPT adapter only forwards first
+  // derivatives and does not expose the iterates, SobolevNormTNLP does.
+  auto on_iterate = [_statistics, &_stop](std::size_t _iter,
+                                          const Eigen::VectorXd& _tau,
+                                          double _cost) {
+    if (_statistics != nullptr) {
+      _statistics->iterations = _iter;
+      _statistics->cost_history.push_back(_cost);
+      if (_statistics->callback) {
+        _statistics->callback(_iter, _tau, _cost);
+      }
+    }
+    return not(_stop and _stop());
+  };
+  Ipopt::SmartPtr<Ipopt::IpoptApplication> application =
+      new Ipopt::IpoptApplication();
+  _options.apply(*application);
+  if (warm_start_multipliers) {
+    application->Options()->SetStringValue("warm_start_init_point", "yes");
+  }
+  IpoptReturnStatus status =
+      static_cast<IpoptReturnStatus>(application->Initialize());
+  SobolevNormTNLP* tnlp = new SobolevNormTNLP(
+      nlp, *cost_function, on_iterate,
+      warm_start_multipliers ? _warm_start : nullptr);
+  // tnlp_ptr owns the TNLP, which holds the solution after the solve
+  Ipopt::SmartPtr<Ipopt::TNLP> tnlp_ptr = tnlp;
+  if (status == IpoptReturnStatus::Solve_Succeeded) {
+    status =
+        static_cast<IpoptReturnStatus>(application->OptimizeTNLP(tnlp_ptr));
+  }
+  finish(status);
+  if (status != IpoptReturnStatus::Solve_Succeeded) {
+    return std::nullopt;
+  }
+  if (_solution != nullptr) {
+    *_solution = tnlp->get_final_point();
+  }
+  // 4. Retrive problem solution
+  return nlp.GetOptVariables()->GetValues();
+}
+}  // namespace
+
+std::optional<::gsplines::GSpline> optimal_sobolev_norm(
+    const Eigen::Ref<const Eigen::MatrixXd>& _waypoints,
+    const gsplines::basis::Basis& _basis,
+    const std::vector<std::pair<std::size_t, double>>& _weights,
+    double _exec_time) {
+  return optimal_sobolev_norm(_waypoints, _basis, _weights, _exec_time,
+                              Eigen::VectorXd::Ones(_waypoints.rows() - 1),
+                              SolverBackend::IPOPT);
+}
+
+std::optional<::gsplines::GSpline> optimal_sobolev_norm(
+    const Eigen::Ref<const Eigen::MatrixXd>& _waypoints,
+    const gsplines::basis::Basis& _basis,
+    const std::vector<std::pair<std::size_t, double>>& _weights,
+    double _exec_time, SolverBackend _backend) {
+  return optimal_sobolev_norm(_waypoints, _basis, _weights, _exec_time,
+                              Eigen::VectorXd::Ones(_waypoints.rows() - 1),
+                              _backend);
+}
 
-  // 3.1 Customize the solver
-  IpoptSolverOptions::set_options_on_interface(ipopt);
+std::optional<::gsplines::GSpline> optimal_sobolev_norm(
+    const Eigen::Ref<const Eigen::MatrixXd>& _waypoints,
+    const gsplines::basis::Basis& _basis,
+    const std::vector<std::pair<std::size_t, double>>& _weights,
+    double _exec_time,
+    const Eigen::Ref<const Eigen::VectorXd>& _initial_interval_lengths,
+    SolverBackend _backend, SolverStatistics* _statistics) {
+
+  if (_backend == SolverBackend::IPOPT) {
+    return optimal_sobolev_norm(_waypoints, _basis, _weights, _exec_time,
+                                _initial_interval_lengths,
+                                IpoptSolverOptions::defaults(), _statistics);
+  }
+  const Eigen::VectorXd initial_tau = scaled_initial_interval_lengths(
+      _initial_interval_lengths, _waypoints.rows() - 1, _exec_time);
+  std::optional<Eigen::VectorXd> tauv = newton_optimal_interval_lengths(
+      _waypoints, _basis, _weights, _exec_time, initial_tau,
+      NewtonSolverOptions(), _statistics);
+  if (not tauv.has_value()) {
+    return std::nullopt;
+  }
+  return interpolate(tauv.value(), _waypoints, _basis);
+}
+
+std::optional<::gsplines::GSpline> optimal_sobolev_norm(
+    const Eigen::Ref<const Eigen::MatrixXd>& _waypoints,
+    const gsplines::basis::Basis& _basis,
+    const std::vector<std::pair<std::size_t, double>>& _weights,
+    double _exec_time, const IpoptSolverOptions& _options) {
+  return optimal_sobolev_norm(_waypoints, _basis, _weights, _exec_time,
+                              Eigen::VectorXd::Ones(_waypoints.rows() - 1),
+                              _options);
+}
+
+std::optional<::gsplines::GSpline> optimal_sobolev_norm(
+    const Eigen::Ref<const Eigen::MatrixXd>& _waypoints,
+    const gsplines::basis::Basis& _basis,
+    const std::vector<std::pair<std::size_t, double>>& _weights,
+    double _exec_time,
+    const Eigen::Ref<const Eigen::VectorXd>& _initial_interval_lengths,
+    const IpoptSolverOptions& _options, SolverStatistics* _statistics) {
+  const std::optional<Eigen::VectorXd> tauv = ipopt_optimal_interval_lengths(
+      _waypoints, _basis, _weights, _exec_time, _initial_interval_lengths,
+      _options, _statistics, nullptr);
+  if (not tauv.has_value()) {
+    return std::nullopt;
+  }
+  return interpolate(tauv.value(), _waypoints, _basis);
+}
+
+std::optional<::gsplines::GSpline> optimal_sobolev_norm(
+    const Eigen::Ref<const Eigen::MatrixXd>& _waypoints,
+    const gsplines::basis::Basis& _basis,
+    const std::vector<std::pair<std::size_t, double>>& _weights,
+    double _exec_time, const IpoptWarmStart& _warm_start,
+    const IpoptSolverOptions& _options, IpoptWarmStart* _solution,
+    SolverStatistics* _statistics) {
+  const std::optional<Eigen::VectorXd> tauv = ipopt_optimal_interval_lengths(
+      _waypoints, _basis, _weights, _exec_time, _warm_start.interval_lengths,
+      _options, _statistics, nullptr, &_warm_start, _solution);
+  if (not tauv.has_value()) {
+    return std::nullopt;
+  }
+  return interpolate(tauv.value(), _waypoints, _basis);
+}
+
+AnytimeSolution optimal_sobolev_norm_anytime(
+    const Eigen::Ref<const Eigen::MatrixXd>& _waypoints,
+    const gsplines::basis::Basis& _basis,
+    const std::vector<std::pair<std::size_t, double>>& _weights,
+    double _exec_time, double _time_budget,
+    const Eigen::Ref<const Eigen::VectorXd>& _initial_interval_lengths,
+    SolverBackend _backend) {
+
+  if (not(_time_budget > 0.0)) {
+    throw std::invalid_argument(
+        "optimal_sobolev_norm_anytime: the time budget must be positive");
+  }
+  const auto start = std::chrono::steady_clock::now();
+  const std::size_t num_intervals = _waypoints.rows() - 1;
+  Eigen::VectorXd best_tau = scaled_initial_interval_lengths(
+      _initial_interval_lengths, num_intervals, _exec_time);
+  double best_cost = std::numeric_limits<double>::infinity();
+
+  // The iterates of both solvers are passed to the callback while they run.
+  // The Newton iterates satisfy the sum constraint, those of IPOPT only up
+  // to its tolerance. An iterate is accepted only if it is feasible.
+  const double sum_tolerance = 1.0e-6 * _exec_time;
+  auto feasible = [_exec_time, sum_tolerance](const Eigen::VectorXd& _tau) {
+    return (_tau.array() > 0.0).all() and
+           std::abs(_tau.sum() - _exec_time) <= sum_tolerance;
+  };
+  SolverStatistics statistics;
+  statistics.callback = [&best_tau, &best_cost, &feasible](
+                            std::size_t, const Eigen::VectorXd& _tau,
+                            double _cost) {
+    if (_cost < best_cost and feasible(_tau)) {
+      best_cost = _cost;
+      best_tau = _tau;
+    }
+  };
+
+  bool converged = false;
+  if (_backend == SolverBackend::IPOPT) {
+    IpoptSolverOptions options = IpoptSolverOptions::defaults();
+    options.set("max_cpu_time", _time_budget);
+    // max_cpu_time counts the CPU time of the process, the deadline is
+    // checked on the wall clock at each iterate
+    const auto deadline =
+        start + std::chrono::duration_cast<std::chrono::steady_clock::duration>(
+                    std::chrono::duration<double>(_time_budget));
+    const std::optional<Eigen::VectorXd> result =
+        ipopt_optimal_interval_lengths(
+            _waypoints, _basis, _weights, _exec_time, best_tau, options,
+            &statistics, [&deadline]() {
+              return std::chrono::steady_clock::now() > deadline;
+            });
+    if (result.has_value() and feasible(result.value())) {
+      converged = true;
+      best_tau = result.value();
+    }
+  } else {
+    NewtonSolverOptions options;
+    options.max_wall_time = _time_budget;
+    const std::optional<Eigen::VectorXd> result =
+        newton_optimal_interval_lengths(_waypoints, _basis, _weights,
+                                        _exec_time, best_tau, options,
+                                        &statistics);
+    if (result.has_value()) {
+      converged = true;
+      best_tau = result.value();
+    }
+  }
+
+  functional_analysis::SobolevNorm cost(_waypoints, _basis, _weights);
+  Eigen::VectorXd gradient(num_intervals);
+  cost.deriv_wrt_interval_len(best_tau, gradient);
+  const double gradient_norm = gradient.norm();
+  const double suboptimality =
+      gradient_norm > 0.0
+          ? (gradient.array() - gradient.mean()).matrix().norm() / gradient_norm
+          : 0.0;
+
+  GSpline curve = interpolate(best_tau, _waypoints, _basis);
+  const double elapsed_time =
+      std::chrono::duration<double>(std::chrono::steady_clock::now() - start)
+          .count();
+  return {std::move(curve), converged, suboptimality, elapsed_time};
+}
+
+AnytimeSolution optimal_sobolev_norm_anytime(
+    const Eigen::Ref<const Eigen::MatrixXd>& _waypoints,
+    const gsplines::basis::Basis& _basis,
+    const std::vector<std::pair<std::size_t, double>>& _weights,
+    double _exec_time, double _time_budget, SolverBackend _backend) {
+  return optimal_sobolev_norm_anytime(
+      _waypoints, _basis, _weights, _exec_time, _time_budget,
+      Eigen::VectorXd::Ones(_waypoints.rows() - 1), _backend);
+}
+
+std::optional<::gsplines::GSpline> minimum_time_path(
+    const Eigen::Ref<const Eigen::MatrixXd>& _waypoints,
+    const gsplines::basis::Basis& _basis,
+    const std::optional<std::vector<double>>& _velocity_bounds,
+    const std::optional<std::vector<double>>& _acceleration_bounds,
+    std::size_t _samples_per_interval, const IpoptSolverOptions& _options) {
+  const std::size_t num_intervals = _waypoints.rows() - 1;
+
+  // Initial point: uniform interval lengths scaled to be strictly feasible.
+  // With one interval this is the solution.
+  KinematicConstraints bounds(_waypoints, _basis, _samples_per_interval,
+                              _velocity_bounds, _acceleration_bounds);
+  const Eigen::VectorXd uniform = Eigen::VectorXd::Ones(num_intervals);
+  const double scaling = bounds.min_scaling_factor(uniform);
+  if (num_intervals == 1) {
+    return interpolate(scaling * uniform, _waypoints, _basis);
+  }
+  const Eigen::VectorXd initial_tau = 1.05 * scaling * uniform;
+
+  ifopt::Problem nlp;
+  nlp.AddVariableSet(std::make_shared<TimeSegmentLenghtsVar>(
+      initial_tau, initial_tau.sum()));
+  nlp.AddConstraintSet(std::make_shared<KinematicConstraintSet>(
+      _waypoints, _basis, _samples_per_interval, _velocity_bounds,
+      _acceleration_bounds));
+  nlp.AddCostSet(std::make_shared<ExecutionTimeCost>("ExecutionTime"));
+
+  ifopt::IpoptSolver ipopt;
+  IpoptSolverOptions options = _options;
+  // The Jacobian of the kinematic constraints depends on tau, and their
+  // Hessian is not available
+  options.set("jac_c_constant", std::string("no"));
+  options.set("hessian_approximation", std::string("limited-memory"));
+  options.apply(ipopt);
 
-  // 4. Ask the solver to solve the problem
   ipopt.Solve(nlp);
   if (ipopt.GetReturnStatus() !=
       static_cast<int>(IpoptReturnStatus::Solve_Succeeded)) {
     return std::nullopt;
   }
-  // 5. Retrive problem solution
-  Eigen::VectorXd tauv = nlp.GetOptVariables()->GetValues();
-  // std::cout << tauv << '\n';
-  // 6. Return solution
-  return inter.interpolate(tauv, _waypoints);
+  const Eigen::VectorXd tauv = nlp.GetOptVariables()->GetValues();
+  return interpolate(tauv, _waypoints, _basis);
 }
 
 std::optional<::gsplines::GSpline> broken_lines_path(
     const Eigen::Ref<const Eigen::MatrixXd>& _waypoints) {
-  auto result = optimal_sobolev_norm(
-      _waypoints, gsplines::basis::BasisLegendre(2), {{1, 1.0}},
-      static_cast<double>(_waypoints.rows() - 1));
-  if (result.has_value()) {
-    return result.value().linear_scaling_new_execution_time(1.0);
-  }
-  return std::nullopt;
+  return broken_lines_path(_waypoints,
+                           Eigen::VectorXd::Ones(_waypoints.rows() - 1));
 }
 
 std::optional<::gsplines::GSpline> minimum_acceleration_path(
     const Eigen::Ref<const Eigen::MatrixXd>& _waypoints) {
-  auto result = optimal_sobolev_norm(
-      _waypoints, gsplines::basis::BasisLegendre(4), {{2, 1.0}},
-      static_cast<double>(_waypoints.rows() - 1));
-  if (result.has_value()) {
-    return result.value().linear_scaling_new_execution_time(1.0);
-  }
-  return std::nullopt;
+  return minimum_acceleration_path(
+      _waypoints, Eigen::VectorXd::Ones(_waypoints.rows() - 1));
 }
 
 std::optional<::gsplines::GSpline> minimum_jerk_path(
     const Eigen::Ref<const Eigen::MatrixXd>& _waypoints) {
-  auto result = optimal_sobolev_norm(
-      _waypoints, gsplines::basis::BasisLegendre(6), {{3, 1.0}},
-      static_cast<double>(_waypoints.rows() - 1));
-  if (result.has_value()) {
-    return result.value().linear_scaling_new_execution_time(1.0);
-  }
-  return std::nullopt;
+  return minimum_jerk_path(_waypoints,
+                           Eigen::VectorXd::Ones(_waypoints.rows() - 1));
 }
 
 std::optional<::gsplines::GSpline> minimum_snap_path(
     const Eigen::Ref<const Eigen::MatrixXd>& _waypoints) {
-  auto result = optimal_sobolev_norm(
-      _waypoints, gsplines::basis::BasisLegendre(8), {{4, 1.0}},
-      static_cast<double>(_waypoints.rows() - 1));
-  if (result.has_value()) {
-    return result.value().linear_scaling_new_execution_time(1.0);
-  }
-  return std::nullopt;
+  return minimum_snap_path(_waypoints,
+                           Eigen::VectorXd::Ones(_waypoints.rows() - 1));
 }
 
 std::optional<::gsplines::GSpline> minimum_crackle_path(
     const Eigen::Ref<const Eigen::MatrixXd>& _waypoints) {
-  auto result = optimal_sobolev_norm(
+  return minimum_crackle_path(_waypoints,
+                              Eigen::VectorXd::Ones(_waypoints.rows() - 1));
+}
+
+std::optional<::gsplines::GSpline> broken_lines_path(
+    const Eigen::Ref<const Eigen::MatrixXd>& _waypoints,
+    const Eigen::Ref<const Eigen::VectorXd>& _initial_interval_lengths) {
+  return unit_execution_time(optimal_sobolev_norm(
+      _waypoints, gsplines::basis::BasisLegendre(2), {{1, 1.0}},
+      static_cast<double>(_waypoints.rows() - 1), _initial_interval_lengths));
+}
+
+std::optional<::gsplines::GSpline> broken_lines_path(
+    const Eigen::Ref<const Eigen::MatrixXd>& _waypoints,
+    const IpoptWarmStart& _warm_start, IpoptWarmStart* _solution) {
+  return unit_execution_time(optimal_sobolev_norm(
+      _waypoints, gsplines::basis::BasisLegendre(2), {{1, 1.0}},
+      static_cast<double>(_waypoints.rows() - 1), _warm_start,
+      IpoptSolverOptions::defaults(), _solution));
+}
+
+std::optional<::gsplines::GSpline> minimum_acceleration_path(
+    const Eigen::Ref<const Eigen::MatrixXd>& _waypoints,
+    const Eigen::Ref<const Eigen::VectorXd>& _initial_interval_lengths) {
+  return unit_execution_time(optimal_sobolev_norm(
+      _waypoints, gsplines::basis::BasisLegendre(4), {{2, 1.0}},
+      static_cast<double>(_waypoints.rows() - 1), _initial_interval_lengths));
+}
+
+std::optional<::gsplines::GSpline> minimum_acceleration_path(
+    const Eigen::Ref<const Eigen::MatrixXd>& _waypoints,
+    const IpoptWarmStart& _warm_start, IpoptWarmStart* _solution) {
+  return unit_execution_time(optimal_sobolev_norm(
+      _waypoints, gsplines::basis::BasisLegendre(4), {{2, 1.0}},
+      static_cast<double>(_waypoints.rows() - 1), _warm_start,
+      IpoptSolverOptions::defaults(), _solution));
+}
+
+std::optional<::gsplines::GSpline> minimum_jerk_path(
+    const Eigen::Ref<const Eigen::MatrixXd>& _waypoints,
+    const Eigen::Ref<const Eigen::VectorXd>& _initial_interval_lengths) {
+  return unit_execution_time(optimal_sobolev_norm(
+      _waypoints, gsplines::basis::BasisLegendre(6), {{3, 1.0}},
+      static_cast<double>(_waypoints.rows() - 1), _initial_interval_lengths));
+}
+
+std::optional<::gsplines::GSpline> minimum_jerk_path(
+    const Eigen::Ref<const Eigen::MatrixXd>& _waypoints,
+    const IpoptWarmStart& _warm_start, IpoptWarmStart* _solution) {
+  return unit_execution_time(optimal_sobolev_norm(
+      _waypoints, gsplines::basis::BasisLegendre(6), {{3, 1.0}},
+      static_cast<double>(_waypoints.rows() - 1), _warm_start,
+      IpoptSolverOptions::defaults(), _solution));
+}
+
+std::optional<::gsplines::GSpline> minimum_snap_path(
+    const Eigen::Ref<const Eigen::MatrixXd>& _waypoints,
+    const Eigen::Ref<const Eigen::VectorXd>& _initial_interval_lengths) {
+  return unit_execution_time(optimal_sobolev_norm(
+      _waypoints, gsplines::basis::BasisLegendre(8), {{4, 1.0}},
+      static_cast<double>(_waypoints.rows() - 1), _initial_interval_lengths));
+}
+
+std::optional<::gsplines::GSpline> minimum_snap_path(
+    const Eigen::Ref<const Eigen::MatrixXd>& _waypoints,
+    const IpoptWarmStart& _warm_start, IpoptWarmStart* _solution) {
+  return unit_execution_time(optimal_sobolev_norm(
+      _waypoints, gsplines::basis::BasisLegendre(8), {{4, 1.0}},
+      static_cast<double>(_waypoints.rows() - 1), _warm_start,
+      IpoptSolverOptions::defaults(), _solution));
+}
+
+std::optional<::gsplines::GSpline> minimum_crackle_path(
+    const Eigen::Ref<const Eigen::MatrixXd>& _waypoints,
+    const Eigen::Ref<const Eigen::VectorXd>& _initial_interval_lengths) {
+  return unit_execution_time(optimal_sobolev_norm(
       _waypoints, gsplines::basis::BasisLegendre(10), {{5, 1.0}},
-      static_cast<double>(_waypoints.rows() - 1));
-  if (result.has_value()) {
-    return result.value().linear_scaling_new_execution_time(1.0);
-  }
-  return std::nullopt;
+      static_cast<double>(_waypoints.rows() - 1), _initial_interval_lengths));
+}
+
+std::optional<::gsplines::GSpline> minimum_crackle_path(
+    const Eigen::Ref<const Eigen::MatrixXd>& _waypoints,
+    const IpoptWarmStart& _warm_start, IpoptWarmStart* _solution) {
+  return unit_execution_time(optimal_sobolev_norm(
+      _waypoints, gsplines::basis::BasisLegendre(10), {{5, 1.0}},
+      static_cast<double>(_waypoints.rows() - 1), _warm_start,
+      IpoptSolverOptions::defaults(), _solution));
 }
 
 std::optional<::gsplines::GSpline> rojas_path(
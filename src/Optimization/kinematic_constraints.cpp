@@ -0,0 +1,165 @@
+#include <gsplines/Optimization/kinematic_constraints.hpp>
+#include <algorithm>
+#include <cmath>
+#include <stdexcept>
+
+namespace gsplines {
+namespace optimization {
+
+namespace {
+Eigen::VectorXd checked_bounds(const std::vector<double>& _bounds,
+                               std::size_t _codom_dim) {
+  if (_bounds.size() != _codom_dim) {
+    throw std::invalid_argument(
+        "KinematicConstraints: the bounds must have one entry per component");
+  }
+  const Eigen::Map<const Eigen::VectorXd> result(
+      _bounds.data(), static_cast<long>(_bounds.size()));
+  if ((result.array() <= 0.0).any()) {
+    throw std::invalid_argument(
+        "KinematicConstraints: the bounds must be positive");
+  }
+  return result;
+}
+}  // namespace
+
+KinematicConstraints::KinematicConstraints(
+    const Eigen::Ref<const Eigen::MatrixXd> _waypoints,
+    const basis::Basis& _basis, std::size_t _samples_per_interval,
+    const std::optional<std::vector<double>>& _velocity_bounds,
+    const std::optional<std::vector<double>>& _acceleration_bounds)
+    : basis_(_basis.clone()),
+      num_intervals_(_waypoints.rows() - 1),
+      codom_dim_(_waypoints.cols()),
+      waypoints_(_waypoints),
+      interpolator_(codom_dim_, num_intervals_, _basis),
+      samples_(Eigen::VectorXd::LinSpaced(_samples_per_interval, -1.0, 1.0)),
+      basis_buffer_(_basis.get_dim(), _samples_per_interval),
+      basis_deriv_buffer_(_basis.get_dim(), _samples_per_interval) {
+
+  if (not _velocity_bounds.has_value() and
+      not _acceleration_bounds.has_value()) {
+    throw std::invalid_argument(
+        "KinematicConstraints: a velocity or acceleration bound is required");
+  }
+  if (_samples_per_interval < 2) {
+    throw std::invalid_argument(
+        "KinematicConstraints: at least two samples per interval are "
+        "required");
+  }
+  if (_velocity_bounds.has_value()) {
+    orders_.push_back(1);
+    order_bounds_.push_back(
+        checked_bounds(_velocity_bounds.value(), codom_dim_));
+  }
+  if (_acceleration_bounds.has_value()) {
+    orders_.push_back(2);
+    order_bounds_.push_back(
+        checked_bounds(_acceleration_bounds.value(), codom_dim_));
+  }
+
+  bounds_.resize(num_intervals_ * samples_.size() * orders_.size() *
+                 codom_dim_);
+  for (std::size_t i = 0; i < num_intervals_; i++) {
+    for (long k = 0; k < samples_.size(); k++) {
+      for (std::size_t o = 0; o < orders_.size(); o++) {
+        bounds_.segment(row(i, k, o), codom_dim_) = order_bounds_[o];
+      }
+    }
+  }
+}
+
+void KinematicConstraints::update_coefficients(
+    const Eigen::Ref<const Eigen::VectorXd> _tau) {
+  if (memo_interval_lengths_.size() == _tau.size() and
+      (memo_interval_lengths_.array() == _tau.array()).all()) {
+    return;
+  }
+  memo_interval_lengths_.resize(0);
+  coeff_derivatives_valid_ = false;
+  coefficients_ = interpolator_.solve_interpolation(_tau, waypoints_);
+  memo_interval_lengths_ = _tau;
+}
+
+void KinematicConstraints::eval_basis(double _tau, unsigned int _order,
+                                      bool _deriv_wrt_tau) {
+  for (long k = 0; k < samples_.size(); k++) {
+    basis_->eval_derivative_on_window(samples_(k), _tau, _order,
+                                      basis_buffer_.col(k));
+    if (_deriv_wrt_tau) {
+      basis_->eval_derivative_wrt_tau_on_window(samples_(k), _tau, _order,
+                                                basis_deriv_buffer_.col(k));
+    }
+  }
+}
+
+void KinematicConstraints::values(const Eigen::Ref<const Eigen::VectorXd> _tau,
+                                  Eigen::Ref<Eigen::VectorXd> _result) {
+  update_coefficients(_tau);
+  const std::size_t basis_dim = basis_->get_dim();
+  for (std::size_t i = 0; i < num_intervals_; i++) {
+    for (std::size_t o = 0; o < orders_.size(); o++) {
+      eval_basis(_tau(i), orders_[o], false);
+      for (std::size_t c = 0; c < codom_dim_; c++) {
+        const auto y = coefficients_.segment(
+            (i * codom_dim_ + c) * basis_dim, basis_dim);
+        for (long k = 0; k < samples_.size(); k++) {
+          _result(row(i, k, o) + c) = basis_buffer_.col(k).dot(y);
+        }
+      }
+    }
+  }
+}
+
+void KinematicConstraints::jacobian(
+    const Eigen::Ref<const Eigen::VectorXd> _tau,
+    Eigen::Ref<Eigen::MatrixXd> _result) {
+  update_coefficients(_tau);
+  const std::size_t basis_dim = basis_->get_dim();
+
+  if (not coeff_derivatives_valid_) {
+    coeff_derivatives_.resize(coefficients_.size(), num_intervals_);
+    for (std::size_t j = 0; j < num_intervals_; j++) {
+      coeff_derivatives_.col(j) =
+          interpolator_.get_coeff_derivative_wrt_tau(coefficients_, _tau, j);
+    }
+    coeff_derivatives_valid_ = true;
+  }
+
+  for (std::size_t i = 0; i < num_intervals_; i++) {
+    for (std::size_t o = 0; o < orders_.size(); o++) {
+      eval_basis(_tau(i), orders_[o], true);
+      for (std::size_t c = 0; c < codom_dim_; c++) {
+        const std::size_t offset = (i * codom_dim_ + c) * basis_dim;
+        const auto y = coefficients_.segment(offset, basis_dim);
+        const auto dy = coeff_derivatives_.middleRows(offset, basis_dim);
+        for (long k = 0; k < samples_.size(); k++) {
+          const std::size_t r = row(i, k, o) + c;
+          _result.row(r).noalias() = basis_buffer_.col(k).transpose() * dy;
+          _result(r, i) += basis_deriv_buffer_.col(k).dot(y);
+        }
+      }
+    }
+  }
+}
+
+double KinematicConstraints::min_scaling_factor(
+    const Eigen::Ref<const Eigen::VectorXd> _tau) {
+  Eigen::VectorXd sampled(get_number_of_constraints());
+  values(_tau, sampled);
+  const Eigen::ArrayXd ratios = sampled.array().abs() / bounds_.array();
+  double result = 0.0;
+  for (std::size_t i = 0; i < num_intervals_; i++) {
+    for (long k = 0; k < samples_.size(); k++) {
+      for (std::size_t o = 0; o < orders_.size(); o++) {
+        const double ratio =
+            ratios.segment(row(i, k, o), codom_dim_).maxCoeff();
+        result = std::max(result, orders_[o] == 1 ? ratio : std::sqrt(ratio));
+      }
+    }
+  }
+  return result;
+}
+
+}  // namespace optimization
+}  // namespace gsplines
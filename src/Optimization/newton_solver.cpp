@@ -0,0 +1,241 @@
+#include <eigen3/Eigen/Cholesky>
+#include <gsplines/FunctionalAnalysis/Sobolev.hpp>
+#include <gsplines/Optimization/newton_solver.hpp>
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <stdexcept>
+
+namespace gsplines {
+namespace optimization {
+
+namespace {
+/// Fraction of the distance to the boundary tau = 0 that a step can cover
+constexpr double fraction_to_boundary = 0.995;
+/// Sufficient decrease parameter of the Armijo line search
+constexpr double armijo = 1.0e-4;
+constexpr double min_step = 1.0e-12;
+/// Number of times the regularization of the Hessian is increased before
+/// the step computation is given up
+constexpr std::size_t max_regularizations = 30;
+
+void record_iterate(SolverStatistics* _statistics, std::size_t _iteration,
+                    const Eigen::VectorXd& _tau, double _value) {
+  if (_statistics == nullptr) {
+    return;
+  }
+  _statistics->iterations = _iteration;
+  _statistics->cost_history.push_back(_value);
+  if (_statistics->callback) {
+    _statistics->callback(_iteration, _tau, _value);
+  }
+}
+
+std::optional<Eigen::VectorXd>
+newton_iterations(functional_analysis::SobolevNorm& _cost,
+                  const Eigen::VectorXd& _initial_tau, double _exec_time,
+                  const NewtonSolverOptions& _options,
+                  std::chrono::steady_clock::time_point _start,
+                  IpoptReturnStatus& _status, SolverStatistics* _statistics) {
+  const std::size_t num_intervals = _initial_tau.size();
+  Eigen::VectorXd tau = _initial_tau;
+
+  Eigen::VectorXd gradient(num_intervals);
+  Eigen::VectorXd projected_gradient(num_intervals);
+  Eigen::VectorXd step(num_intervals);
+  Eigen::VectorXd tau_trial(num_intervals);
+  Eigen::VectorXd gradient_trial(num_intervals);
+  Eigen::MatrixXd hessian(num_intervals, num_intervals);
+  Eigen::MatrixXd reduced_hessian(num_intervals, num_intervals);
+  Eigen::LLT<Eigen::MatrixXd> llt(num_intervals);
+
+  // The projector onto the hyperplane sum(tau) = const is P = I - 1 1^T / n
+  const double inv_n = 1.0 / static_cast<double>(num_intervals);
+  const Eigen::MatrixXd projector =
+      Eigen::MatrixXd::Identity(num_intervals, num_intervals).array() - inv_n;
+  auto project = [inv_n](Eigen::Ref<Eigen::VectorXd> _vec) {
+    _vec.array() -= _vec.sum() * inv_n;
+  };
+
+  bool exact_hessian = true;
+  bool bfgs_initialized = false;
+  hessian.setIdentity();
+
+  double value = _cost(tau);
+  _cost.deriv_wrt_interval_len(tau, gradient);
+  record_iterate(_statistics, 0, tau, value);
+
+  for (std::size_t iter = 0; iter < _options.max_iter; iter++) {
+    const double elapsed = std::chrono::duration<double>(
+                               std::chrono::steady_clock::now() - _start)
+                               .count();
+    if (elapsed > _options.max_wall_time) {
+      _status = IpoptReturnStatus::Maximum_CpuTime_Exceeded;
+      return std::nullopt;
+    }
+    // 1. Hessian
+    if (exact_hessian) {
+      try {
+        _cost.hessian_wrt_interval_len(tau, hessian);
+      } catch (const std::logic_error&) {
+        exact_hessian = false;
+        hessian.setIdentity();
+      }
+    }
+    // 2. Newton step on the hyperplane, P H P + 1 1^T / n is positive
+    // definite iff the Hessian is positive definite on the hyperplane.
+    // Otherwise it is regularized.
+    reduced_hessian.noalias() = projector * hessian * projector;
+    reduced_hessian.array() += inv_n;
+
+    projected_gradient = gradient;
+    project(projected_gradient);
+
+    // A Hessian with non finite entries, e.g. after an overflow at tiny
+    // interval lengths, cannot be factorized however it is regularized.
+    if (not reduced_hessian.allFinite() or not gradient.allFinite()) {
+      _status = IpoptReturnStatus::Invalid_Number_Detected;
+      return std::nullopt;
+    }
+    double regularization = 0.0;
+    const double scale =
+        std::max(1.0, reduced_hessian.diagonal().cwiseAbs().maxCoeff());
+    llt.compute(reduced_hessian);
+    for (std::size_t attempt = 0; llt.info() != Eigen::Success; attempt++) {
+      if (attempt == max_regularizations) {
+        _status = IpoptReturnStatus::Error_In_Step_Computation;
+        return std::nullopt;
+      }
+      regularization = regularization == 0.0 ? 1.0e-8 * scale
+                                             : 10.0 * regularization;
+      llt.compute(reduced_hessian +
+                  regularization *
+                      Eigen::MatrixXd::Identity(num_intervals, num_intervals));
+    }
+    step = -llt.solve(projected_gradient);
+    project(step);
+
+    // 3. Convergence test on the decrease predicted by the Newton step
+    const double slope = gradient.dot(step);
+    if (-0.5 * slope <= _options.tol * std::max(1.0, std::abs(value))) {
+      _status = IpoptReturnStatus::Solve_Succeeded;
+      return tau;
+    }
+
+    // 4. Line search, keeping the interval lengths positive
+    double alpha = 1.0;
+    for (long i = 0; i < step.size(); i++) {
+      if (step(i) < 0.0) {
+        alpha = std::min(alpha, -fraction_to_boundary * tau(i) / step(i));
+      }
+    }
+    double value_trial = 0.0;
+    while (true) {
+      tau_trial = tau + alpha * step;
+      tau_trial *= _exec_time / tau_trial.sum();
+      value_trial = _cost(tau_trial);
+      if (std::isfinite(value_trial) and
+          value_trial <= value + armijo * alpha * slope) {
+        break;
+      }
+      alpha *= 0.5;
+      if (alpha < min_step) {
+        _status = IpoptReturnStatus::Search_Direction_Becomes_Too_Small;
+        return std::nullopt;
+      }
+    }
+    _cost.deriv_wrt_interval_len(tau_trial, gradient_trial);
+
+    // 5. Without second derivatives, update the BFGS approximation
+    if (not exact_hessian) {
+      const Eigen::VectorXd s = tau_trial - tau;
+      const Eigen::VectorXd y = gradient_trial - gradient;
+      const double sy = s.dot(y);
+      if (sy > 1.0e-12 * s.norm() * y.norm()) {
+        if (not bfgs_initialized) {
+          hessian = (y.dot(y) / sy) *
+                    Eigen::MatrixXd::Identity(num_intervals, num_intervals);
+          bfgs_initialized = true;
+        }
+        const Eigen::VectorXd hs = hessian * s;
+        hessian += y * y.transpose() / sy - hs * hs.transpose() / s.dot(hs);
+      }
+    }
+    tau = tau_trial;
+    gradient = gradient_trial;
+    value = value_trial;
+    record_iterate(_statistics, iter + 1, tau, value);
+  }
+  _status = IpoptReturnStatus::Maximum_Iterations_Exceeded;
+  return std::nullopt;
+}
+}  // namespace
+
+std::optional<Eigen::VectorXd> newton_optimal_interval_lengths(
+    const Eigen::Ref<const Eigen::MatrixXd>& _waypoints,
+    const basis::Basis& _basis,
+    const std::vector<std::pair<std::size_t, double>>& _weights,
+    double _exec_time, const NewtonSolverOptions& _options,
+    SolverStatistics* _statistics) {
+
+  if (_waypoints.rows() < 2) {
+    throw std::invalid_argument(
+        "newton_optimal_interval_lengths: at least two waypoints are "
+        "required");
+  }
+  const std::size_t num_intervals = _waypoints.rows() - 1;
+  return newton_optimal_interval_lengths(
+      _waypoints, _basis, _weights, _exec_time,
+      Eigen::VectorXd::Ones(num_intervals), _options, _statistics);
+}
+
+std::optional<Eigen::VectorXd> newton_optimal_interval_lengths(
+    const Eigen::Ref<const Eigen::MatrixXd>& _waypoints,
+    const basis::Basis& _basis,
+    const std::vector<std::pair<std::size_t, double>>& _weights,
+    double _exec_time,
+    const Eigen::Ref<const Eigen::VectorXd>& _initial_interval_lengths,
+    const NewtonSolverOptions& _options, SolverStatistics* _statistics) {
+
+  if (_waypoints.rows() < 2 or _exec_time <= 0.0) {
+    throw std::invalid_argument(
+        "newton_optimal_interval_lengths: at least two waypoints and a "
+        "positive execution time are required");
+  }
+  const std::size_t num_intervals = _waypoints.rows() - 1;
+  if (_initial_interval_lengths.size() != (long)num_intervals or
+      (_initial_interval_lengths.array() <= 0.0).any()) {
+    throw std::invalid_argument(
+        "newton_optimal_interval_lengths: the initial interval lengths must "
+        "be positive, one per interval");
+  }
+
+  Eigen::VectorXd tau =
+      _initial_interval_lengths * (_exec_time / _initial_interval_lengths.sum());
+  if (_statistics != nullptr) {
+    _statistics->clear();
+  }
+  const auto start = std::chrono::steady_clock::now();
+  IpoptReturnStatus status = IpoptReturnStatus::Solve_Succeeded;
+  std::optional<Eigen::VectorXd> result;
+  if (num_intervals == 1) {
+    result = tau;
+  } else {
+    functional_analysis::SobolevNorm cost(_waypoints, _basis, _weights);
+    cost.set_timings(_statistics ? &_statistics->cost_timings : nullptr);
+    result = newton_iterations(cost, tau, _exec_time, _options, start, status,
+                               _statistics);
+  }
+  if (_statistics != nullptr) {
+    _statistics->return_status = status;
+    _statistics->total_time =
+        std::chrono::duration<double>(std::chrono::steady_clock::now() - start)
+            .count();
+    _statistics->solver_time =
+        _statistics->total_time - _statistics->cost_time();
+  }
+  return result;
+}
+
+}  // namespace optimization
+}  // namespace gsplines
@@ -1,4 +1,8 @@
 #include <gsplines/Tools.hpp>
+#include <algorithm>
+#include <atomic>
+#include <thread>
+#include <vector>
 
 namespace gsplines {
 namespace tools {
@@ -77,6 +81,35 @@ bool approx_zero(const Eigen::MatrixXd &_rhs, double _tol) {
 bool approx_zero(const GSplineBase &_rhs, double _tol) {
   return approx_zero(_rhs.get_coefficients(), _tol);
 }
+
+std::size_t worker_count(std::size_t _num_threads, std::size_t _num_tasks) {
+  if (_num_threads == 0) {
+    _num_threads = std::max(1u, std::thread::hardware_concurrency());
+  }
+  return std::max<std::size_t>(1, std::min(_num_threads, _num_tasks));
+}
+
+void parallel_for(
+    std::size_t _num_tasks, std::size_t _num_workers,
+    const std::function<void(std::size_t, std::size_t)> &_task) {
+
+  std::atomic<std::size_t> next_task(0);
+  auto worker = [&](std::size_t _worker) {
+    for (std::size_t task = next_task++; task < _num_tasks;
+         task = next_task++) {
+      _task(_worker, task);
+    }
+  };
+
+  std::vector<std::thread> pool;
+  for (std::size_t k = 1; k < _num_workers; k++) {
+    pool.emplace_back(worker, k);
+  }
+  worker(0);
+  for (std::thread &t : pool) {
+    t.join();
+  }
+}
 } // namespace tools
 
 } // namespace gsplines
@@ -0,0 +1,61 @@
+#ifndef ALLOCATION_COUNTER
+#define ALLOCATION_COUNTER
+
+// Counts heap allocations by interposing the allocation functions of glibc.
+// This covers both operator new and the allocations of Eigen, which calls
+// malloc directly. Include this header in exactly one translation unit of a
+// test executable. On other C libraries nothing is counted and
+// allocation_counter::supported is false, so tests skip their assertions on
+// the number of allocations.
+
+#include <atomic>
+#include <cstddef>
+
+#if defined(__GLIBC__)
+extern "C" {
+void *__libc_malloc(std::size_t _size);
+void *__libc_calloc(std::size_t _num, std::size_t _size);
+void *__libc_realloc(void *_ptr, std::size_t _size);
+}
+#endif
+
+namespace allocation_counter {
+#if defined(__GLIBC__)
+inline constexpr bool supported = true;
+#else
+inline constexpr bool supported = false;
+#endif
+
+inline std::atomic<std::size_t> &count() {
+  static std::atomic<std::size_t> result(0);
+  return result;
+}
+/// Number of heap allocations since the construction of the scope
+class Scope {
+ private:
+  std::size_t start_;
+
+ public:
+  Scope() : start_(count().load()) {}
+  std::size_t allocations() const { return count().load() - start_; }
+};
+}  // namespace allocation_counter
+
+#if defined(__GLIBC__)
+extern "C" {
+void *malloc(std::size_t _size) noexcept {
+  allocation_counter::count()++;
+  return __libc_malloc(_size);
+}
+void *calloc(std::size_t _num, std::size_t _size) noexcept {
+  allocation_counter::count()++;
+  return __libc_calloc(_num, _size);
+}
+void *realloc(void *_ptr, std::size_t _size) noexcept {
+  allocation_counter::count()++;
+  return __libc_realloc(_ptr, _size);
+}
+}
+#endif
+
+#endif  // ifndef ALLOCATION_COUNTER
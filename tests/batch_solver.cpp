@@ -0,0 +1,78 @@
+#include <eigen3/Eigen/Core>
+#include <gsplines/Basis/BasisLegendre.hpp>
+#include <gsplines/Optimization/batch_solver.hpp>
+#include <gsplines/Optimization/ipopt_solver.hpp>
+#include <gsplines/Tools.hpp>
+#include <gtest/gtest.h>
+#include <cstddef>
+#include <stdexcept>
+#include <vector>
+
+using namespace gsplines;
+
+TEST(BatchSolver, Order) {
+  const basis::BasisLegendre basis(6);
+  std::vector<Eigen::MatrixXd> wp;
+  std::vector<double> exec_times;
+  for (std::size_t k = 0; k < 13; k++) {
+    wp.emplace_back(Eigen::MatrixXd::Random(2 + k % 5, 3));
+    exec_times.push_back(1.0 + static_cast<double>(k));
+  }
+  // The failure of one problem does not stop the batch
+  exec_times[4] = -1.0;
+
+  optimization::BatchOptions options;
+  options.backend = optimization::SolverBackend::NEWTON;
+  for (std::size_t threads : {1, 3, 16}) {
+    options.num_threads = threads;
+    const std::vector<optimization::BatchResult> result =
+        optimization::optimal_sobolev_norm_batch(wp, basis, {{3, 1.0}},
+                                                 exec_times, options);
+    ASSERT_EQ(result.size(), wp.size());
+    for (std::size_t k = 0; k < wp.size(); k++) {
+      EXPECT_LT(result[k].worker, threads);
+      EXPECT_GE(result[k].solve_time, 0.0);
+      if (k == 4) {
+        EXPECT_EQ(result[k].status, optimization::BatchStatus::FAILED);
+        EXPECT_FALSE(result[k].solution.has_value());
+        EXPECT_FALSE(result[k].message.empty());
+        continue;
+      }
+      ASSERT_EQ(result[k].status, optimization::BatchStatus::SOLVED);
+      const std::optional<GSpline> single = optimization::optimal_sobolev_norm(
+          wp[k], basis, {{3, 1.0}}, exec_times[k],
+          optimization::SolverBackend::NEWTON);
+      ASSERT_TRUE(single.has_value());
+      EXPECT_TRUE(tools::approx_equal(result[k].solution->get_coefficients(),
+                                      single->get_coefficients(), 1.0e-9));
+    }
+  }
+  exec_times.pop_back();
+  EXPECT_THROW(optimization::optimal_sobolev_norm_batch(wp, basis, {{3, 1.0}},
+                                                        exec_times, options),
+               std::invalid_argument);
+}
+
+TEST(BatchSolver, MinimumJerk) {
+  std::vector<Eigen::MatrixXd> wp;
+  for (std::size_t k = 0; k < 6; k++) {
+    wp.emplace_back(Eigen::MatrixXd::Random(4, 2));
+  }
+  optimization::BatchOptions options;
+  options.backend = optimization::SolverBackend::NEWTON;
+  options.num_threads = 2;
+  const std::vector<optimization::BatchResult> result =
+      optimization::minimum_jerk_path_batch(wp, options);
+  ASSERT_EQ(result.size(), wp.size());
+  for (std::size_t k = 0; k < wp.size(); k++) {
+    ASSERT_EQ(result[k].status, optimization::BatchStatus::SOLVED);
+    EXPECT_NEAR(result[k].solution->get_domain_length(), 1.0, 1.0e-9);
+    EXPECT_TRUE(tools::approx_equal(result[k].solution->get_waypoints(), wp[k],
+                                    1.0e-9));
+  }
+}
+
+int main(int argc, char **argv) {
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
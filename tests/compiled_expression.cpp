@@ -0,0 +1,135 @@
+#include "allocation_counter.h"
+#include <eigen3/Eigen/Core>
+#include <gsplines/Functions/CompiledExpression.hpp>
+#include <gsplines/Functions/ElementalFunctions.hpp>
+#include <gsplines/Functions/FunctionExpression.hpp>
+#include <gsplines/GSpline.hpp>
+#include <gsplines/Tools.hpp>
+#include <gtest/gtest.h>
+#include <algorithm>
+#include <cstddef>
+#include <vector>
+
+using namespace gsplines;
+using namespace gsplines::functions;
+
+namespace {
+void expect_same_values(const FunctionExpression &_expression,
+                        const Eigen::VectorXd &_points) {
+  const CompiledExpression compiled = _expression.compile();
+  EXPECT_TRUE(tools::approx_equal(compiled(_points), _expression(_points),
+                                  1.0e-10));
+}
+
+long count(const CompiledExpression &_compiled,
+           CompiledExpression::OpCode _op) {
+  const std::vector<CompiledExpression::Instruction> &tape =
+      _compiled.get_tape();
+  return std::count_if(tape.begin(), tape.end(),
+                       [_op](const CompiledExpression::Instruction &_i) {
+                         return _i.op == _op;
+                       });
+}
+} // namespace
+
+TEST(CompiledExpression, ElementalFunctions) {
+  const Eigen::VectorXd points = Eigen::VectorXd::Random(50);
+  Sin sin({-1.0, 1.0});
+  Cos cos({-1.0, 1.0});
+  Identity identity({-1.0, 1.0});
+
+  const FunctionExpression g =
+      (sin + identity + sin.compose(sin)).compose(sin).compose(cos);
+  for (std::size_t deg = 0; deg < 3; deg++) {
+    expect_same_values(g.derivate(deg), points);
+  }
+  expect_same_values(-2 * sin.compose(DomainLinearDilation({-1, 1}, 2)),
+                     points);
+}
+
+TEST(CompiledExpression, GSplines) {
+  const Eigen::VectorXd points = Eigen::VectorXd::LinSpaced(101, 0.0, 2.0);
+  const GSpline g1 = random_gspline({0.0, 1.0}, 3);
+  const GSpline g2 = random_gspline({0.0, 1.0}, 1);
+
+  const FunctionExpression product =
+      g1.derivate().to_expression() * g2.to_expression();
+  expect_same_values(product.derivate(2), points.head(51));
+
+  const FunctionExpression dot = g1.dot(g1.derivate()).to_expression();
+  expect_same_values(dot.derivate(), points.head(51));
+
+  expect_same_values(
+      g2.to_expression().concat(Cos({1.0, 2.0}).to_expression()), points);
+
+  // Copies and moves keep a valid plan
+  CompiledExpression compiled = product.compile();
+  const CompiledExpression copy(compiled);
+  const CompiledExpression moved(std::move(compiled));
+  EXPECT_TRUE(tools::approx_equal(copy(points.head(51)),
+                                  moved(points.head(51)), 1.0e-12));
+  EXPECT_TRUE(tools::approx_equal(copy.derivate()(points.head(51)),
+                                  product.derivate()(points.head(51)),
+                                  1.0e-10));
+}
+
+TEST(CompiledExpression, SharedSubexpressions) {
+  const Eigen::VectorXd points = Eigen::VectorXd::Random(50);
+  Sin sin({-1.0, 1.0});
+  Cos cos({-1.0, 1.0});
+
+  // Each copy of f is a different node, but they are evaluated once
+  const FunctionExpression f = sin.compose(cos);
+  const FunctionExpression g = f * f + f;
+  const CompiledExpression compiled = g.compile();
+  EXPECT_EQ(count(compiled, CompiledExpression::EVAL), 2);
+  EXPECT_TRUE(tools::approx_equal(compiled(points), g(points), 1.0e-10));
+
+  // Reordered sums are shared too
+  const FunctionExpression h = (sin + cos) * (cos + sin) - (sin + cos);
+  EXPECT_EQ(count(h.compile(), CompiledExpression::EVAL), 2);
+  EXPECT_EQ(count(h.compile(), CompiledExpression::ADD), 2);
+  expect_same_values(h, points);
+
+  const GSpline g1 = random_gspline({0.0, 1.0}, 3);
+  const FunctionExpression dot =
+      g1.dot(g1.derivate()).to_expression().derivate(3);
+  expect_same_values(dot, points.cwiseAbs());
+}
+
+TEST(CompiledExpression, NoAllocations) {
+  const Eigen::VectorXd points = Eigen::VectorXd::LinSpaced(200, 0.0, 1.0);
+  const GSpline g1 = random_gspline({0.0, 1.0}, 3);
+  const GSpline g2 = random_gspline({0.0, 1.0}, 1);
+
+  const FunctionExpression expression =
+      (g1.derivate().to_expression() * g2.to_expression() -
+       g1.derivate(2).to_expression())
+          .derivate();
+  const CompiledExpression compiled = expression.compile();
+  Eigen::MatrixXd result(points.size(), 3);
+  compiled.value(points, result);
+  {
+    allocation_counter::Scope scope;
+    for (std::size_t k = 0; k < 10; k++) {
+      compiled.value(points, result);
+    }
+    if (allocation_counter::supported) {
+      EXPECT_EQ(scope.allocations(), 0);
+    }
+  }
+  {
+    // Sanity check of the counter: returning a new matrix allocates
+    allocation_counter::Scope scope;
+    const Eigen::MatrixXd fresh = compiled(points);
+    if (allocation_counter::supported) {
+      EXPECT_GT(scope.allocations(), 0);
+    }
+  }
+  EXPECT_TRUE(tools::approx_equal(result, compiled(points), 1.0e-10));
+}
+
+int main(int argc, char **argv) {
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
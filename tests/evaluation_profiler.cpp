@@ -0,0 +1,84 @@
+#include <eigen3/Eigen/Core>
+#include <gsplines/Basis/BasisLegendre.hpp>
+#include <gsplines/Functions/ElementalFunctions.hpp>
+#include <gsplines/Functions/EvaluationProfiler.hpp>
+#include <gsplines/Functions/FunctionExpression.hpp>
+#include <gsplines/GSpline.hpp>
+#include <gtest/gtest.h>
+#include <map>
+#include <string>
+
+using namespace gsplines;
+using namespace gsplines::functions;
+
+TEST(EvaluationProfiler, CallTree) {
+  const GSpline gspline = random_gspline({0.0, 1.0}, 1);
+  const Exponential exp({0.0, 1.0});
+  const FunctionExpression expression =
+      gspline.to_expression() * exp + exp.compose(gspline.to_expression());
+  const Eigen::VectorXd points = Eigen::VectorXd::LinSpaced(100, 0.0, 1.0);
+
+  EvaluationProfiler &profiler = EvaluationProfiler::thread_instance();
+  profiler.clear();
+  expression(points);
+  EXPECT_TRUE(profiler.get_root().children.empty());
+
+  profiler.enable();
+  EXPECT_TRUE(EvaluationProfiler::is_any_enabled());
+  expression(points);
+  expression(points.head(10));
+  profiler.disable();
+  expression(points);
+
+  ASSERT_EQ(profiler.get_root().children.size(), 1);
+  const EvaluationProfiler::Node &sum = *profiler.get_root().children.front();
+  EXPECT_EQ(sum.label, "SUM");
+  EXPECT_EQ(sum.calls, 2);
+  EXPECT_EQ(sum.points, 110);
+  EXPECT_GE(sum.get_self_time(), 0.0);
+
+  ASSERT_EQ(sum.children.size(), 2);
+  EXPECT_EQ(sum.children[0]->label, "MULTIPLICATION");
+  EXPECT_EQ(sum.children[1]->label, "COMPOSITION");
+  EXPECT_EQ(sum.children[0]->children.size(), 2);
+
+  const std::map<std::string, EvaluationProfiler::Summary> summary =
+      profiler.get_summary();
+  EXPECT_EQ(summary.at("Exponential").calls, 4);
+  EXPECT_EQ(summary.at("Exponential").points, 220);
+
+  const std::string json = profiler.to_json();
+  EXPECT_EQ(json.front(), '[');
+  EXPECT_EQ(json.back(), ']');
+  EXPECT_NE(json.find("\"label\": \"COMPOSITION\""), std::string::npos);
+
+  profiler.clear();
+  EXPECT_TRUE(profiler.get_root().children.empty());
+}
+
+/* Names with quotes and control characters give valid JSON strings */
+TEST(EvaluationProfiler, JsonEscape) {
+  const GSpline gspline({0.0, 1.0}, 1, 1, basis::BasisLegendre(2),
+                        Eigen::VectorXd(Eigen::VectorXd::Ones(2)),
+                        Eigen::VectorXd(Eigen::VectorXd::Ones(1)),
+                        "a\"b\\c\nd\te\x01");
+
+  EvaluationProfiler &profiler = EvaluationProfiler::thread_instance();
+  profiler.clear();
+  profiler.enable();
+  gspline(Eigen::VectorXd::LinSpaced(10, 0.0, 1.0));
+  profiler.disable();
+
+  const std::string json = profiler.to_json();
+  EXPECT_NE(json.find("\"label\": \"a\\\"b\\\\c\\u000ad\\u0009e\\u0001\""),
+            std::string::npos);
+  for (char c : json) {
+    EXPECT_GE(static_cast<unsigned char>(c), 0x20);
+  }
+  profiler.clear();
+}
+
+int main(int argc, char **argv) {
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
@@ -0,0 +1,92 @@
+#include "allocation_counter.h"
+#include <eigen3/Eigen/Core>
+#include <gsplines/Functions/ElementalFunctions.hpp>
+#include <gsplines/Functions/EvaluationWorkspace.hpp>
+#include <gsplines/Functions/FunctionExpression.hpp>
+#include <gsplines/GSpline.hpp>
+#include <gsplines/Tools.hpp>
+#include <gtest/gtest.h>
+#include <cstddef>
+#include <thread>
+#include <vector>
+
+using namespace gsplines;
+using namespace gsplines::functions;
+
+namespace {
+/// Expression with sums, products, compositions, concatenations and dot
+/// products
+FunctionExpression test_expression() {
+  const GSpline g1 = random_gspline({0.0, 1.0}, 3);
+  const GSpline g2 = random_gspline({0.0, 1.0}, 1);
+  const Sin sin({0.0, 1.0});
+  const FunctionExpression product =
+      (g1.derivate().to_expression() * g2.to_expression() -
+       g1.derivate(2).to_expression())
+          .derivate();
+  const FunctionExpression scalar =
+      g1.dot(g1.derivate()).to_expression() + sin.compose(g2.to_expression());
+  return product * scalar.concat(Cos({1.0, 2.0}).to_expression())
+                       .compose(DomainLinearDilation({0.0, 1.0}, 2.0));
+}
+} // namespace
+
+TEST(EvaluationWorkspace, NoAllocations) {
+  const FunctionExpression expression = test_expression();
+  const Eigen::VectorXd points = Eigen::VectorXd::LinSpaced(200, 0.0, 1.0);
+  Eigen::MatrixXd result(points.size(), expression.get_codom_dim());
+  const EvaluationWorkspace &workspace = EvaluationWorkspace::thread_instance();
+
+  expression.value(points, result);
+  const Eigen::MatrixXd expected = result;
+  const std::size_t growths = workspace.get_number_of_growths();
+  {
+    allocation_counter::Scope scope;
+    for (std::size_t k = 0; k < 10; k++) {
+      expression.value(points, result);
+    }
+    if (allocation_counter::supported) {
+      EXPECT_EQ(scope.allocations(), 0);
+    }
+  }
+  EXPECT_EQ(workspace.get_number_of_growths(), growths);
+  EXPECT_TRUE(tools::approx_equal(result, expected, 1.0e-12));
+
+  // Fewer points reuse the same buffers
+  {
+    allocation_counter::Scope scope;
+    expression.value(points.head(50), result.topRows(50));
+    if (allocation_counter::supported) {
+      EXPECT_EQ(scope.allocations(), 0);
+    }
+  }
+  EXPECT_TRUE(
+      tools::approx_equal(result.topRows(50), expected.topRows(50), 1.0e-12));
+}
+
+TEST(EvaluationWorkspace, Threads) {
+  const FunctionExpression expression = test_expression();
+  const Eigen::VectorXd points = Eigen::VectorXd::LinSpaced(100, 0.0, 1.0);
+  const Eigen::MatrixXd expected = expression(points);
+
+  std::vector<Eigen::MatrixXd> results(4);
+  std::vector<std::thread> threads;
+  for (std::size_t k = 0; k < results.size(); k++) {
+    threads.emplace_back([&, k]() {
+      for (std::size_t i = 0; i < 20; i++) {
+        results[k] = expression(points);
+      }
+    });
+  }
+  for (std::thread &t : threads) {
+    t.join();
+  }
+  for (const Eigen::MatrixXd &result : results) {
+    EXPECT_TRUE(tools::approx_equal(result, expected, 1.0e-12));
+  }
+}
+
+int main(int argc, char **argv) {
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
@@ -1,8 +1,11 @@
 #include <cmath>
+#include <gsplines/Basis/BasisLegendre.hpp>
 #include <gsplines/Functions/ElementalFunctions.hpp>
+#include <gsplines/GSpline.hpp>
 #include <gsplines/Tools.hpp>
 #include <gtest/gtest.h>
 #include <iostream>
+#include <memory>
 using namespace gsplines::functions;
 
 std::size_t number_of_wp = 3;
@@ -84,6 +87,144 @@ TEST(FunctionCont, Value) {
   < 1.0e-9);*/
 }
 
+TEST(FunctionCont, ManyPieces) {
+  const std::size_t pieces = 20;
+  const Eigen::VectorXd coeff = Eigen::VectorXd::Random(4);
+
+  // FunctionExpression is not assignable, so the partial results are held
+  // through pointers
+  std::unique_ptr<FunctionExpression> moved_ptr =
+      std::make_unique<FunctionExpression>(
+          CanonicPolynomial({0, 1}, coeff).to_expression());
+  std::unique_ptr<FunctionExpression> copied_ptr =
+      std::make_unique<FunctionExpression>(*moved_ptr);
+  for (std::size_t k = 1; k < pieces; k++) {
+    const double t = static_cast<double>(k);
+    const FunctionExpression piece =
+        CanonicPolynomial({t, t + 1.0}, (t + 1.0) * coeff).to_expression();
+    moved_ptr = std::make_unique<FunctionExpression>(
+        std::move(*moved_ptr).concat(piece));
+    copied_ptr =
+        std::make_unique<FunctionExpression>(copied_ptr->concat(piece));
+  }
+  const FunctionExpression &moved = *moved_ptr;
+  const FunctionExpression &copied = *copied_ptr;
+  // The pieces are stored flat, without their wrapping expressions
+  ASSERT_EQ(moved.get_type(), FunctionExpression::CONCATENATION);
+  EXPECT_EQ(moved.function_array_.size(), pieces);
+  EXPECT_EQ(copied.function_array_.size(), pieces);
+  EXPECT_NEAR(moved.get_domain().second, pieces, 1.0e-12);
+
+  const FunctionExpression copy(moved);
+  for (std::size_t k = 0; k < pieces; k++) {
+    const double t = static_cast<double>(k);
+    Eigen::VectorXd points = Eigen::VectorXd::LinSpaced(5, t, t + 0.99);
+    Eigen::MatrixXd nom =
+        CanonicPolynomial({t, t + 1.0}, (t + 1.0) * coeff)(points);
+    Eigen::MatrixXd test_moved = moved(points);
+    Eigen::MatrixXd test_copied = copied(points);
+    Eigen::MatrixXd test_copy = copy(points);
+    compare_assert(nom, test_moved);
+    compare_assert(nom, test_copied);
+    compare_assert(nom, test_copy);
+  }
+}
+
+TEST(FunctionCont, UnorderedPoints) {
+  const std::size_t pieces = 8;
+  std::unique_ptr<FunctionExpression> concatenation =
+      std::make_unique<FunctionExpression>(
+          ConstFunction({0, 1}, 1, 0.0).to_expression());
+  for (std::size_t k = 1; k < pieces; k++) {
+    const double t = static_cast<double>(k);
+    concatenation = std::make_unique<FunctionExpression>(
+        std::move(*concatenation).concat(ConstFunction({t, t + 1.0}, 1, t)));
+  }
+
+  // Each piece takes the value of its left break point. The break points
+  // belong to the piece at their right, and points out of the domain take
+  // the value at the closest bound.
+  Eigen::VectorXd points(9);
+  points << 3.5, 0.2, 3.0, 2.9, 7.5, 8.0, 9.0, -1.0, 5.0;
+  Eigen::MatrixXd nom(9, 1);
+  nom << 3.0, 0.0, 3.0, 2.0, 7.0, 7.0, 7.0, 0.0, 5.0;
+  Eigen::MatrixXd test = (*concatenation)(points);
+  compare_assert(nom, test);
+
+  Eigen::VectorXd sorted = Eigen::VectorXd::LinSpaced(64, 0.0, 7.99);
+  Eigen::MatrixXd nom_sorted = sorted.array().floor().matrix();
+  Eigen::MatrixXd test_sorted = concatenation->derivate(0)(sorted);
+  compare_assert(nom_sorted, test_sorted);
+}
+
+TEST(FunctionCont, GSplines) {
+  const std::size_t pieces = 5;
+  const gsplines::basis::BasisLegendre basis(6);
+  std::vector<gsplines::GSpline> gsplines;
+  for (std::size_t k = 0; k < pieces; k++) {
+    const double t = static_cast<double>(k);
+    const Eigen::VectorXd coefficients = Eigen::VectorXd::Random(24);
+    const Eigen::VectorXd interval_lengths = Eigen::VectorXd::Constant(2, 0.5);
+    gsplines.emplace_back(std::pair<double, double>{t, t + 1.0}, 2, 2, basis,
+                          coefficients, interval_lengths);
+  }
+
+  std::unique_ptr<FunctionExpression> copied =
+      std::make_unique<FunctionExpression>(gsplines.front().to_expression());
+  std::unique_ptr<FunctionExpression> moved =
+      std::make_unique<FunctionExpression>(*copied);
+  for (std::size_t k = 1; k < pieces; k++) {
+    copied = std::make_unique<FunctionExpression>(
+        copied->concat(gsplines[k].to_expression()));
+    moved = std::make_unique<FunctionExpression>(
+        std::move(*moved).concat(gsplines[k].to_expression()));
+  }
+
+  // The pieces are fused into one GSpline
+  for (const FunctionExpression *concatenation : {copied.get(), moved.get()}) {
+    ASSERT_EQ(concatenation->get_type(), FunctionExpression::UNIQUE);
+    const gsplines::GSpline *gspline = dynamic_cast<const gsplines::GSpline *>(
+        concatenation->function_array_.front().get());
+    ASSERT_NE(gspline, nullptr);
+    EXPECT_EQ(gspline->get_number_of_intervals(), 2 * pieces);
+    EXPECT_NEAR(concatenation->get_domain().second, pieces, 1.0e-12);
+
+    for (std::size_t k = 0; k < pieces; k++) {
+      const double t = static_cast<double>(k);
+      Eigen::VectorXd points = Eigen::VectorXd::LinSpaced(7, t + 0.01, t + 0.99);
+      Eigen::MatrixXd nom = gsplines[k].derivate(2)(points);
+      Eigen::MatrixXd test = concatenation->derivate(2)(points);
+      compare_assert(nom, test);
+    }
+
+    // Out of the domain, the polynomial of the last interval is extrapolated
+    const Eigen::VectorXd after = Eigen::VectorXd::Constant(1, pieces + 0.1);
+    Eigen::MatrixXd nom = gsplines.back()(after);
+    Eigen::MatrixXd test = (*concatenation)(after);
+    compare_assert(nom, test);
+
+    // A joint is evaluated with the piece on its left
+    const Eigen::VectorXd joint = Eigen::VectorXd::Constant(1, 1.0);
+    nom = gsplines.front()(joint);
+    test = (*concatenation)(joint);
+    compare_assert(nom, test);
+  }
+
+  // Only GSplines which start where the first one ends are appended
+  gsplines::GSpline first = gsplines[0];
+  EXPECT_THROW(first.append(gsplines[2]), std::invalid_argument);
+  EXPECT_EQ(first.get_number_of_intervals(), 2);
+
+  // Functions which are not GSplines of the same basis stay apart
+  const FunctionExpression mixed =
+      gsplines[0]
+          .to_expression()
+          .concat(ConstFunction({1.0, 2.0}, 2, 1.0))
+          .concat(gsplines[2].to_expression());
+  EXPECT_EQ(mixed.get_type(), FunctionExpression::CONCATENATION);
+  EXPECT_EQ(mixed.function_array_.size(), 3);
+}
+
 int main(int argc, char **argv) {
 
   ::testing::InitGoogleTest(&argc, argv);
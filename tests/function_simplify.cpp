@@ -0,0 +1,67 @@
+#include <eigen3/Eigen/Core>
+#include <gsplines/Functions/ElementalFunctions.hpp>
+#include <gsplines/Functions/FunctionExpression.hpp>
+#include <gsplines/GSpline.hpp>
+#include <gsplines/Tools.hpp>
+#include <gtest/gtest.h>
+
+using namespace gsplines;
+using namespace gsplines::functions;
+
+namespace {
+void expect_same_values(const FunctionExpression &_expression,
+                        const Eigen::VectorXd &_points) {
+  const FunctionExpression simplified = _expression.simplify();
+  EXPECT_TRUE(tools::approx_equal(simplified(_points), _expression(_points),
+                                  1.0e-9));
+  EXPECT_LE(simplified.get_number_of_nodes(),
+            _expression.get_number_of_nodes());
+  EXPECT_EQ(simplified.get_codom_dim(), _expression.get_codom_dim());
+}
+} // namespace
+
+TEST(Simplify, ElementalFunctions) {
+  const Eigen::VectorXd points = Eigen::VectorXd::Random(20);
+  Sin sin({-1.0, 1.0});
+  Cos cos({-1.0, 1.0});
+  ConstFunction two({-1.0, 1.0}, 1, 2.0);
+
+  const FunctionExpression f = 3.0 * (2.0 * sin + two) * (-(-cos));
+  for (std::size_t deg = 0; deg < 4; deg++) {
+    expect_same_values(f.derivate(deg), points);
+  }
+  expect_same_values(two.compose(sin) * sin, points);
+
+  // Derivatives of constant factors vanish
+  const FunctionExpression g = (two * sin).derivate(3);
+  EXPECT_LT(g.simplify().get_number_of_nodes(), g.get_number_of_nodes());
+
+  const FunctionExpression zero = (sin * two).derivate(0) - sin * two;
+  EXPECT_TRUE(tools::approx_zero(zero.simplify()(points), 1.0e-12));
+}
+
+TEST(Simplify, GSplines) {
+  const Eigen::VectorXd points = Eigen::VectorXd::LinSpaced(30, 0.0, 1.0);
+  const GSpline g1 = random_gspline({0.0, 1.0}, 3);
+  const GSpline g2 = random_gspline({0.0, 1.0}, 3);
+  const GSpline g3 = random_gspline({0.0, 1.0}, 1);
+
+  // Sums and scalings of GSplines of the same space collapse into one
+  const FunctionExpression sum =
+      g1.to_expression() + 2.0 * g2.to_expression() - g1.to_expression();
+  const FunctionExpression simplified_sum = sum.simplify();
+  EXPECT_EQ(simplified_sum.get_type(), FunctionExpression::UNIQUE);
+  EXPECT_EQ(simplified_sum.get_number_of_nodes(), 2);
+  EXPECT_TRUE(
+      tools::approx_equal(simplified_sum(points), 2.0 * g2(points), 1.0e-9));
+
+  const FunctionExpression product = g1.to_expression() * g3.to_expression();
+  for (std::size_t deg = 0; deg < 4; deg++) {
+    expect_same_values(product.derivate(deg), points);
+  }
+}
+
+int main(int argc, char **argv) {
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
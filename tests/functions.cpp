@@ -19,6 +19,43 @@ TEST(Function, Addition) {
       gsplines::tools::approx_equal(m(time_spam), 6 * exp_value, 1.0e-9));
 }
 
+TEST(Function, InPlaceOperations) {
+
+  Exponential s({-1.0, 1.0});
+  Sin g({-1.0, 1.0});
+  Eigen::VectorXd time_spam = Eigen::VectorXd::Random(4);
+
+  FunctionExpression sum(s);
+  FunctionExpression terms = s + g;
+  for (std::size_t k = 0; k < 10; k++) {
+    sum += s + g;
+    sum += terms;
+  }
+  sum += sum;
+
+  // The terms of the sums are spliced in a single flat sum
+  EXPECT_EQ(sum.get_type(), FunctionExpression::SUM);
+  EXPECT_EQ(sum.function_array_.size(), 82);
+  EXPECT_TRUE(gsplines::tools::approx_equal(
+      sum(time_spam), 2.0 * (21.0 * s(time_spam) + 20.0 * g(time_spam)),
+      1.0e-9));
+
+  FunctionExpression product(s);
+  for (std::size_t k = 0; k < 3; k++) {
+    product *= g;
+  }
+  EXPECT_EQ(product.get_type(), FunctionExpression::MULTIPLICATION);
+  EXPECT_EQ(product.function_array_.size(), 4);
+  EXPECT_TRUE(gsplines::tools::approx_equal(
+      product(time_spam),
+      s(time_spam).array() * g(time_spam).array().pow(3), 1.0e-9));
+
+  FunctionExpression vector = ConstFunction({-1.0, 1.0}, 2, 3.0);
+  EXPECT_THROW(product *= vector, std::invalid_argument);
+  EXPECT_THROW(sum += vector, std::invalid_argument);
+  EXPECT_NO_THROW(vector *= product);
+}
+
 int main(int argc, char **argv) {
   ::testing::InitGoogleTest(&argc, argv);
   return RUN_ALL_TESTS();
@@ -0,0 +1,90 @@
+#include <eigen3/Eigen/Core>
+#include <gsplines/Basis/BasisLagrange.hpp>
+#include <gsplines/Basis/BasisLegendre.hpp>
+#include <gsplines/Functions/FunctionExpression.hpp>
+#include <gsplines/GSpline.hpp>
+#include <gsplines/Interpolator.hpp>
+#include <gsplines/Tools.hpp>
+#include <gtest/gtest.h>
+#include <stdexcept>
+
+using namespace gsplines;
+using namespace gsplines::functions;
+
+namespace {
+/// Expects that _gspline and _expression have the same derivatives up to
+/// order 2
+void expect_same_derivatives(const GSpline &_gspline,
+                             const FunctionExpression &_expression) {
+  const Eigen::VectorXd points = Eigen::VectorXd::LinSpaced(
+      301, _gspline.get_domain().first, _gspline.get_domain().second);
+  for (std::size_t deg = 0; deg < 3; deg++) {
+    const Eigen::MatrixXd expected = _expression.derivate(deg)(points);
+    EXPECT_TRUE(tools::approx_equal(_gspline.derivate(deg)(points), expected,
+                                    1.0e-7 * (1.0 + expected.norm())))
+        << "derivative " << deg;
+  }
+}
+} // namespace
+
+TEST(GSplineAlgebra, Product) {
+  const GSpline g1 = random_gspline({0.0, 1.0}, 3);
+  const GSpline g2 = random_gspline({0.0, 1.0}, 1);
+  const GSpline g3 =
+      random_gspline({0.0, 1.0}, 1, basis::BasisLagrangeGaussLobatto(4));
+
+  const GSpline product = gspline_product(g1, g2);
+  EXPECT_EQ(product.get_codom_dim(), 3);
+  EXPECT_EQ(product.get_basis().get_dim(), 11);
+  EXPECT_LE(product.get_number_of_intervals(),
+            g1.get_number_of_intervals() + g2.get_number_of_intervals());
+  expect_same_derivatives(product, g1.to_expression() * g2.to_expression());
+
+  // The scalar factor may come first, and the bases may differ
+  expect_same_derivatives(gspline_product(g3, g1),
+                          g1.to_expression() * g3.to_expression());
+
+  EXPECT_THROW(gspline_product(g1, g1), std::invalid_argument);
+  EXPECT_THROW(gspline_product(g1, random_gspline({0.0, 2.0}, 1)),
+               std::invalid_argument);
+}
+
+TEST(GSplineAlgebra, Composition) {
+  const GSpline outer = random_gspline({0.0, 1.0}, 2);
+
+  // A scalar GSpline with values in [0, 1] which is not monotone
+  Eigen::MatrixXd waypoints(5, 1);
+  waypoints << 0.3, 0.6, 0.4, 0.7, 0.5;
+  const GSpline inner = interpolate(Eigen::VectorXd::Constant(4, 0.5),
+                                    waypoints, basis::BasisLegendre(4));
+
+  const GSpline composition = gspline_composition(outer, inner);
+  EXPECT_EQ(composition.get_domain(), inner.get_domain());
+  EXPECT_EQ(composition.get_codom_dim(), 2);
+  EXPECT_GE(composition.get_number_of_intervals(),
+            inner.get_number_of_intervals());
+  expect_same_derivatives(composition,
+                          outer.compose(inner.to_expression()));
+
+  EXPECT_THROW(gspline_composition(outer, 3.0 * inner),
+               std::invalid_argument);
+  EXPECT_THROW(gspline_composition(inner, outer), std::invalid_argument);
+}
+
+TEST(GSplineAlgebra, Simplify) {
+  const Eigen::VectorXd points = Eigen::VectorXd::LinSpaced(101, 0.0, 1.0);
+  const GSpline g1 = random_gspline({0.0, 1.0}, 3);
+  const GSpline g2 = random_gspline({0.0, 1.0}, 1);
+
+  const FunctionExpression product =
+      g1.to_expression() * g2.to_expression() * g2.to_expression();
+  const FunctionExpression simplified = product.simplify();
+  EXPECT_EQ(simplified.get_number_of_nodes(), 2);
+  EXPECT_TRUE(
+      tools::approx_equal(simplified(points), product(points), 1.0e-8));
+}
+
+int main(int argc, char **argv) {
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
@@ -7,6 +7,9 @@
 #include <gsplines/Tools.hpp>
 #include <gtest/gtest.h>
 #include <cstddef>
+#include <vector>
+
+#include "allocation_counter.h"
 using namespace gsplines;
 TEST(Interpolator, Value) {
   for (std::size_t i = 1; i < 3; i++) {
@@ -31,6 +34,134 @@ TEST(Interpolator, Value) {
   }
   EXPECT_TRUE(true);
 }
+TEST(Interpolator, Batch) {
+  const basis::BasisLegendre basis(6);
+  const std::size_t dim = 3;
+  const std::size_t intervals = 5;
+  const std::size_t batch_size = 4;
+  const Eigen::VectorXd tau =
+      Eigen::VectorXd::Random(intervals).array() + 1.2;
+  std::vector<Eigen::MatrixXd> wp_batch;
+  for (std::size_t k = 0; k < batch_size; k++) {
+    wp_batch.push_back(Eigen::MatrixXd::Random(intervals + 1, dim));
+  }
+  Interpolator inter(dim, intervals, basis);
+  const std::vector<GSpline> result = inter.interpolate_batch(tau, wp_batch);
+  ASSERT_EQ(result.size(), batch_size);
+
+  for (std::size_t k = 0; k < batch_size; k++) {
+    const GSpline single = interpolate(tau, wp_batch[k], basis);
+    EXPECT_TRUE(tools::approx_equal(result[k].get_coefficients(),
+                                    single.get_coefficients(), 1.0e-9));
+    EXPECT_TRUE(
+        tools::approx_equal(result[k].get_waypoints(), wp_batch[k], 1.0e-9));
+  }
+}
+
+TEST(Interpolator, Many) {
+  const basis::BasisLegendre basis(6);
+  std::vector<Eigen::VectorXd> tau;
+  std::vector<Eigen::MatrixXd> wp;
+  for (std::size_t k = 0; k < 20; k++) {
+    // mix problem shapes so that workers need several workspaces
+    const std::size_t intervals = 2 + k % 3;
+    const std::size_t dim = 1 + k % 2;
+    tau.emplace_back(Eigen::VectorXd::Random(intervals).array() + 1.2);
+    wp.emplace_back(Eigen::MatrixXd::Random(intervals + 1, dim));
+  }
+  for (std::size_t threads : {1, 3, 8}) {
+    const std::vector<GSpline> result =
+        interpolate_many(tau, wp, basis, threads);
+    ASSERT_EQ(result.size(), wp.size());
+    for (std::size_t k = 0; k < wp.size(); k++) {
+      const GSpline single = interpolate(tau[k], wp[k], basis);
+      EXPECT_TRUE(tools::approx_equal(result[k].get_coefficients(),
+                                      single.get_coefficients(), 1.0e-9));
+    }
+  }
+  tau.back().setZero();
+  EXPECT_THROW(interpolate_many(tau, wp, basis, 4), std::invalid_argument);
+}
+TEST(Interpolator, UpdateIntervalLength) {
+  const basis::BasisLegendre basis(6);
+  const std::size_t dim = 2;
+  for (std::size_t intervals : {1, 2, 6}) {
+    Eigen::VectorXd tau = Eigen::VectorXd::Random(intervals).array() + 1.2;
+    const Eigen::MatrixXd wp = Eigen::MatrixXd::Random(intervals + 1, dim);
+    Interpolator inter(dim, intervals, basis);
+    EXPECT_THROW(inter.update_interval_length(0, 1.0), std::logic_error);
+    ASSERT_TRUE(inter.factorize_interpolating_matrix(tau));
+    // update every interval once, first, middle and last blocks
+    for (std::size_t i = 0; i < intervals; i++) {
+      tau(i) += 0.3;
+      ASSERT_TRUE(inter.update_interval_length(i, tau(i)));
+      EXPECT_TRUE(tools::approx_equal(inter.get_factorized_interval_lengths(),
+                                      tau, 1.0e-12));
+      const Eigen::VectorXd coeff = inter.solve_interpolation(tau, wp);
+      const GSpline fresh = interpolate(tau, wp, basis);
+      EXPECT_TRUE(
+          tools::approx_equal(coeff, fresh.get_coefficients(), 1.0e-9));
+    }
+    EXPECT_THROW(inter.update_interval_length(intervals, 1.0),
+                 std::invalid_argument);
+  }
+}
+TEST(Interpolator, NoAllocation) {
+  const basis::BasisLegendre basis(6);
+  const std::size_t dim = 3;
+  const std::size_t intervals = 8;
+  const Eigen::VectorXd tau = Eigen::VectorXd::Random(intervals).array() + 1.2;
+  std::vector<Eigen::MatrixXd> wp_batch;
+  for (std::size_t k = 0; k < 5; k++) {
+    wp_batch.push_back(Eigen::MatrixXd::Random(intervals + 1, dim));
+  }
+  Interpolator inter(dim, intervals, basis);
+  GSpline result = inter.interpolate(tau, wp_batch[0]);
+  Eigen::VectorXd coefficients(result.get_coefficients().size());
+
+  {
+    allocation_counter::Scope scope;
+    for (const Eigen::MatrixXd &wp : wp_batch) {
+      inter.interpolate(tau, wp, result);
+      inter.solve_interpolation(tau, wp, coefficients);
+    }
+    // Only the forward substitution of SparseLU allocates its workspace,
+    // once per solve
+    if (allocation_counter::supported) {
+      EXPECT_LE(scope.allocations(), 2 * wp_batch.size());
+    }
+  }
+  {
+    // Sanity check of the counter: returning a new GSpline allocates
+    allocation_counter::Scope scope;
+    const GSpline fresh = inter.interpolate(tau, wp_batch[0]);
+    if (allocation_counter::supported) {
+      EXPECT_GT(scope.allocations(), 0);
+    }
+  }
+  for (const Eigen::MatrixXd &wp : wp_batch) {
+    inter.interpolate(tau, wp, result);
+    inter.solve_interpolation(tau, wp, coefficients);
+    const GSpline fresh = interpolate(tau, wp, basis);
+    EXPECT_TRUE(tools::approx_equal(result.get_coefficients(),
+                                    fresh.get_coefficients(), 1.0e-9));
+    EXPECT_TRUE(tools::approx_equal(coefficients, fresh.get_coefficients(),
+                                    1.0e-9));
+    EXPECT_TRUE(tools::approx_equal(result.get_waypoints(), wp, 1.0e-9));
+  }
+  // The GSpline takes the new interval lengths
+  const Eigen::VectorXd new_tau = 2.0 * tau;
+  inter.interpolate(new_tau, wp_batch[0], result);
+  EXPECT_TRUE(tools::approx_equal(result.get_interval_lengths(), new_tau,
+                                  1.0e-12));
+  EXPECT_NEAR(result.get_domain_length(), new_tau.sum(), 1.0e-9);
+
+  GSpline wrong_shape = interpolate(tau.head(intervals - 1),
+                                    wp_batch[0].topRows(intervals), basis);
+  EXPECT_THROW(inter.interpolate(tau, wp_batch[0], wrong_shape),
+               std::invalid_argument);
+}
+
 int main(int argc, char** argv) {
   ::testing::InitGoogleTest(&argc, argv);
   return RUN_ALL_TESTS();
@@ -1,7 +1,17 @@
 #include <gsplines/Basis/BasisLegendre.hpp>
+#include <gsplines/FunctionalAnalysis/Sobolev.hpp>
+#include <gsplines/Optimization/batch_solver.hpp>
+#include <gsplines/Optimization/ipopt_interface.hpp>
 #include <gsplines/Optimization/ipopt_solver.hpp>
+#include <gsplines/Optimization/kinematic_constraints.hpp>
 #include <gsplines/Tools.hpp>
 #include <gtest/gtest.h>
+#include <ifopt/problem.h>
+#include <memory>
+#include <optional>
+#include <stdexcept>
+#include <thread>
+#include <vector>
 
 TEST(Iport, TestRun) {
   long number_of_wp = 3;
@@ -20,6 +30,245 @@ TEST(Iport, TestRun) {
   EXPECT_TRUE(gsplines::optimization::minimum_jerk_path(wp));
   EXPECT_TRUE(gsplines::optimization::minimum_snap_path(wp));
 }
+/* Concurrent solves, each with its own options */
+TEST(Iport, ConcurrentOptions) {
+  const std::size_t num_problems = 8;
+  const gsplines::basis::BasisLegendre basis(6);
+  std::vector<Eigen::MatrixXd> wp;
+  std::vector<gsplines::optimization::IpoptSolverOptions> options;
+  std::vector<Eigen::VectorXd> expected;
+  for (std::size_t k = 0; k < num_problems; k++) {
+    wp.emplace_back(Eigen::MatrixXd::Random(5, 3));
+    options.emplace_back(gsplines::optimization::IpoptSolverOptions().set(
+        "tol", k % 2 == 0 ? 1.0e-3 : 1.0e-8));
+    const auto result = gsplines::optimization::optimal_sobolev_norm(
+        wp[k], basis, {{3, 1.0}}, 4.0, options[k]);
+    ASSERT_TRUE(result.has_value());
+    expected.push_back(result->get_interval_lengths());
+  }
+
+  std::vector<std::optional<gsplines::GSpline>> results(num_problems);
+  std::vector<std::thread> threads;
+  for (std::size_t k = 0; k < num_problems; k++) {
+    threads.emplace_back([&, k]() {
+      const auto result = gsplines::optimization::optimal_sobolev_norm(
+          wp[k], basis, {{3, 1.0}}, 4.0, options[k]);
+      if (result.has_value()) {
+        results[k].emplace(result.value());
+      }
+    });
+  }
+  // The process-wide options can change while the solves run
+  gsplines::optimization::IpoptSolverOptions::set_option("tol", 1.0e-2);
+  for (std::thread& t : threads) {
+    t.join();
+  }
+  gsplines::optimization::IpoptSolverOptions::set_option("tol", 1.0e-3);
+
+  for (std::size_t k = 0; k < num_problems; k++) {
+    ASSERT_TRUE(results[k].has_value());
+    EXPECT_TRUE(gsplines::tools::approx_equal(
+        results[k]->get_interval_lengths(), expected[k], 1.0e-9));
+  }
+}
+
+/* A batch solved by IPOPT on several workers gives the solutions of the
+ * sequential solves */
+TEST(Iport, Batch) {
+  const std::size_t num_problems = 12;
+  std::vector<Eigen::MatrixXd> wp;
+  for (std::size_t k = 0; k < num_problems; k++) {
+    wp.emplace_back(Eigen::MatrixXd::Random(3 + k % 4, 3));
+  }
+  gsplines::optimization::BatchOptions options;
+  ASSERT_EQ(options.backend, gsplines::optimization::SolverBackend::IPOPT);
+  options.num_threads = 4;
+  const std::vector<gsplines::optimization::BatchResult> result =
+      gsplines::optimization::minimum_jerk_path_batch(wp, options);
+
+  ASSERT_EQ(result.size(), num_problems);
+  for (std::size_t k = 0; k < num_problems; k++) {
+    ASSERT_EQ(result[k].status, gsplines::optimization::BatchStatus::SOLVED);
+    EXPECT_LT(result[k].worker, options.num_threads);
+    const auto single = gsplines::optimization::minimum_jerk_path(wp[k]);
+    ASSERT_TRUE(single.has_value());
+    EXPECT_TRUE(gsplines::tools::approx_equal(
+        result[k].solution->get_interval_lengths(),
+        single->get_interval_lengths(), 1.0e-9));
+    EXPECT_TRUE(gsplines::tools::approx_equal(
+        result[k].solution->get_waypoints(), wp[k], 1.0e-9));
+  }
+}
+
+TEST(Iport, Statistics) {
+  const Eigen::MatrixXd wp = Eigen::MatrixXd::Random(6, 3);
+  gsplines::optimization::SolverStatistics statistics;
+  std::vector<double> costs;
+  statistics.callback = [&costs](std::size_t, const Eigen::VectorXd&,
+                                 double _cost) { costs.push_back(_cost); };
+  const auto result = gsplines::optimization::optimal_sobolev_norm(
+      wp, gsplines::basis::BasisLegendre(6), {{3, 1.0}}, 5.0,
+      Eigen::VectorXd::Ones(5), gsplines::optimization::IpoptSolverOptions(),
+      &statistics);
+  ASSERT_TRUE(result.has_value());
+  EXPECT_EQ(statistics.return_status,
+            gsplines::optimization::IpoptReturnStatus::Solve_Succeeded);
+  EXPECT_GT(statistics.iterations, 0);
+  EXPECT_EQ(statistics.cost_history.size(), statistics.iterations + 1);
+  EXPECT_EQ(costs, statistics.cost_history);
+  EXPECT_GT(statistics.cost_timings.evaluations, 0);
+  EXPECT_GT(statistics.cost_timings.gradient_evaluations, 0);
+  EXPECT_GE(statistics.total_time, statistics.cost_time());
+}
+
+/* Solving again from the primal-dual solution gives the same solution, and
+ * the multipliers must have the size of the problem */
+TEST(Iport, WarmStartMultipliers) {
+  using namespace gsplines::optimization;
+  const Eigen::MatrixXd wp = Eigen::MatrixXd::Random(6, 3);
+  const gsplines::basis::BasisLegendre basis(6);
+  IpoptSolverOptions options;
+  options.set("tol", 1.0e-8);
+
+  IpoptWarmStart uniform;
+  uniform.interval_lengths = Eigen::VectorXd::Ones(5);
+  EXPECT_FALSE(uniform.has_multipliers());
+  IpoptWarmStart solution;
+  const auto cold = optimal_sobolev_norm(wp, basis, {{3, 1.0}}, 5.0, uniform,
+                                         options, &solution);
+  ASSERT_TRUE(cold.has_value());
+  ASSERT_TRUE(solution.has_multipliers());
+  EXPECT_EQ(solution.upper_bound_multipliers.size(), 5);
+  EXPECT_EQ(solution.constraint_multipliers.size(), 1);
+  EXPECT_TRUE(gsplines::tools::approx_equal(solution.interval_lengths,
+                                            cold->get_interval_lengths(),
+                                            1.0e-12));
+
+  SolverStatistics statistics;
+  const auto warm = optimal_sobolev_norm(wp, basis, {{3, 1.0}}, 5.0, solution,
+                                         options, nullptr, &statistics);
+  ASSERT_TRUE(warm.has_value());
+  EXPECT_TRUE(gsplines::tools::approx_equal(
+      warm->get_interval_lengths(), cold->get_interval_lengths(), 1.0e-6));
+
+  IpoptWarmStart wrong = solution;
+  wrong.constraint_multipliers = Eigen::VectorXd::Zero(2);
+  EXPECT_THROW(
+      optimal_sobolev_norm(wp, basis, {{3, 1.0}}, 5.0, wrong, options),
+      std::invalid_argument);
+}
+
+/* IPOPT with the exact Hessian reaches the solution of the L-BFGS
+ * approximation and evaluates the Hessian of the cost */
+TEST(Iport, ExactHessian) {
+  const Eigen::MatrixXd wp = Eigen::MatrixXd::Random(6, 3);
+  const gsplines::basis::BasisLegendre basis(6);
+  gsplines::optimization::IpoptSolverOptions options;
+  options.set("tol", 1.0e-8);
+  const auto limited_memory = gsplines::optimization::optimal_sobolev_norm(
+      wp, basis, {{3, 1.0}}, 5.0, options);
+
+  options.set("hessian_approximation", std::string("exact"));
+  EXPECT_TRUE(options.exact_hessian());
+  gsplines::optimization::SolverStatistics statistics;
+  const auto exact = gsplines::optimization::optimal_sobolev_norm(
+      wp, basis, {{3, 1.0}}, 5.0, Eigen::VectorXd::Ones(5), options,
+      &statistics);
+  ASSERT_TRUE(limited_memory.has_value());
+  ASSERT_TRUE(exact.has_value());
+  EXPECT_TRUE(gsplines::tools::approx_equal(
+      exact->get_interval_lengths(), limited_memory->get_interval_lengths(),
+      1.0e-4));
+  EXPECT_GT(statistics.cost_timings.hessian_evaluations, 0);
+}
+
+/* The anytime solution with IPOPT always satisfies the constraints, with
+ * the budget exhausted or not */
+TEST(Iport, Anytime) {
+  const std::size_t intervals = 8;
+  const Eigen::MatrixXd wp = Eigen::MatrixXd::Random(intervals + 1, 3);
+  const gsplines::basis::BasisLegendre basis(6);
+  const double exec_time = 5.0;
+
+  const gsplines::optimization::AnytimeSolution early =
+      gsplines::optimization::optimal_sobolev_norm_anytime(
+          wp, basis, {{3, 1.0}}, exec_time, 1.0e-12);
+  EXPECT_FALSE(early.converged);
+  EXPECT_TRUE((early.curve.get_interval_lengths().array() > 0.0).all());
+  EXPECT_NEAR(early.curve.get_interval_lengths().sum(), exec_time,
+              1.0e-6 * exec_time);
+  EXPECT_TRUE(gsplines::tools::approx_equal(early.curve.get_waypoints(), wp,
+                                            1.0e-9));
+
+  const gsplines::optimization::AnytimeSolution solution =
+      gsplines::optimization::optimal_sobolev_norm_anytime(
+          wp, basis, {{3, 1.0}}, exec_time, 60.0);
+  EXPECT_TRUE(solution.converged);
+  EXPECT_LT(solution.suboptimality, early.suboptimality);
+  EXPECT_NEAR(solution.curve.get_interval_lengths().sum(), exec_time,
+              1.0e-6 * exec_time);
+  EXPECT_GT(solution.elapsed_time, 0.0);
+}
+
+TEST(Iport, MinimumTime) {
+  const Eigen::MatrixXd wp = Eigen::MatrixXd::Random(6, 3);
+  const gsplines::basis::BasisLegendre basis(6);
+  const std::vector<double> velocity(3, 1.0);
+  const std::vector<double> acceleration(3, 2.0);
+  const auto result = gsplines::optimization::minimum_time_path(
+      wp, basis, velocity, acceleration, 10);
+  ASSERT_TRUE(result.has_value());
+  EXPECT_TRUE(gsplines::tools::approx_equal(result->get_waypoints(), wp,
+                                            1.0e-9));
+
+  // Feasible and not slower than scaling the uniform allocation
+  gsplines::optimization::KinematicConstraints bounds(wp, basis, 10, velocity,
+                                                      acceleration);
+  EXPECT_LE(bounds.min_scaling_factor(result->get_interval_lengths()),
+            1.0 + 1.0e-6);
+  const double uniform_time =
+      5.0 * bounds.min_scaling_factor(Eigen::VectorXd::Ones(5));
+  EXPECT_LE(result->get_domain_length(), uniform_time * (1.0 + 1.0e-6));
+}
+
+/* The Jacobians keep their structure between evaluations and hold the
+ * derivatives of the cost */
+TEST(Iport, JacobianStructure) {
+  using namespace gsplines::optimization;
+  const Eigen::MatrixXd wp = Eigen::MatrixXd::Random(4, 3);
+  const std::size_t num_intervals = wp.rows() - 1;
+  const gsplines::basis::BasisLegendre basis(6);
+  const std::vector<std::pair<std::size_t, double>> weights = {{3, 1.0}};
+
+  ifopt::Problem nlp;
+  nlp.AddVariableSet(
+      std::make_shared<TimeSegmentLenghtsVar>(num_intervals, 3.0));
+  nlp.AddConstraintSet(
+      std::make_shared<ExecTimeConstraint>(num_intervals, 3.0));
+  auto kinematic = std::make_shared<KinematicConstraintSet>(
+      wp, basis, 5, std::vector<double>(3, 1.0), std::nullopt);
+  nlp.AddConstraintSet(kinematic);
+  nlp.AddCostSet(std::make_shared<SobolevNorm>("jerk", wp, basis, weights));
+
+  const Eigen::VectorXd tau_1 = Eigen::VectorXd::Ones(num_intervals);
+  const Eigen::VectorXd tau_2 =
+      Eigen::VectorXd::Random(num_intervals).array().abs() + 0.5;
+
+  nlp.SetVariables(tau_1.data());
+  const auto jac_1 = nlp.GetJacobianOfConstraints();
+  nlp.SetVariables(tau_2.data());
+  const auto jac_2 = nlp.GetJacobianOfConstraints();
+  EXPECT_EQ(jac_1.nonZeros(), jac_2.nonZeros());
+  EXPECT_EQ(static_cast<std::size_t>(jac_2.nonZeros()),
+            (1 + kinematic->GetRows()) * num_intervals);
+
+  gsplines::functional_analysis::SobolevNorm cost(wp, basis, weights);
+  Eigen::VectorXd gradient(num_intervals);
+  cost.deriv_wrt_interval_len(tau_2, gradient);
+  EXPECT_TRUE(gsplines::tools::approx_equal(
+      nlp.EvaluateCostFunctionGradient(tau_2.data()), gradient, 1.0e-9));
+}
+
 int main(int argc, char** argv) {
   ::testing::InitGoogleTest(&argc, argv);
   return RUN_ALL_TESTS();
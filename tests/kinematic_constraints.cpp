@@ -0,0 +1,116 @@
+#include <eigen3/Eigen/Core>
+#include <gsplines/Basis/BasisLegendre.hpp>
+#include <gsplines/Interpolator.hpp>
+#include <gsplines/Optimization/kinematic_constraints.hpp>
+#include <gsplines/Tools.hpp>
+#include <gtest/gtest.h>
+#include <cstddef>
+#include <stdexcept>
+#include <vector>
+
+using namespace gsplines;
+
+namespace {
+const std::size_t intervals = 5;
+const std::size_t dim = 3;
+const std::size_t samples = 7;
+}  // namespace
+
+TEST(KinematicConstraints, Values) {
+  const basis::BasisLegendre basis(6);
+  const Eigen::MatrixXd wp = Eigen::MatrixXd::Random(intervals + 1, dim);
+  const Eigen::VectorXd tau = Eigen::VectorXd::Random(intervals).array() + 1.5;
+  optimization::KinematicConstraints constraints(
+      wp, basis, samples, std::vector<double>(dim, 1.0),
+      std::vector<double>(dim, 2.0));
+  ASSERT_EQ(constraints.get_number_of_constraints(),
+            intervals * samples * 2 * dim);
+
+  Eigen::VectorXd values(constraints.get_number_of_constraints());
+  constraints.values(tau, values);
+
+  const GSpline curve = interpolate(tau, wp, basis);
+  const functions::FunctionExpression velocity = curve.derivate();
+  const functions::FunctionExpression acceleration = curve.derivate(2);
+  const Eigen::VectorXd s = Eigen::VectorXd::LinSpaced(samples, -1.0, 1.0);
+  std::size_t row = 0;
+  double t0 = 0.0;
+  for (std::size_t i = 0; i < intervals; i++) {
+    // Stay inside the interval, the end points are shared with the
+    // neighbours and the derivatives are continuous there anyway
+    Eigen::VectorXd t = t0 + (s.array() + 1.0) * 0.5 * tau(i);
+    t(0) += 1.0e-12;
+    t(samples - 1) -= 1.0e-12;
+    const Eigen::MatrixXd vel = velocity(t);
+    const Eigen::MatrixXd acc = acceleration(t);
+    for (std::size_t k = 0; k < samples; k++) {
+      EXPECT_TRUE(tools::approx_equal(values.segment(row, dim),
+                                      vel.row(k).transpose(), 1.0e-7));
+      row += dim;
+      EXPECT_TRUE(tools::approx_equal(values.segment(row, dim),
+                                      acc.row(k).transpose(), 1.0e-7));
+      row += dim;
+    }
+    t0 += tau(i);
+  }
+}
+
+TEST(KinematicConstraints, Jacobian) {
+  const basis::BasisLegendre basis(6);
+  const Eigen::MatrixXd wp = Eigen::MatrixXd::Random(intervals + 1, dim);
+  const Eigen::VectorXd tau = Eigen::VectorXd::Random(intervals).array() + 1.5;
+  optimization::KinematicConstraints constraints(
+      wp, basis, samples, std::vector<double>(dim, 1.0),
+      std::vector<double>(dim, 2.0));
+  const std::size_t rows = constraints.get_number_of_constraints();
+
+  Eigen::MatrixXd jacobian(rows, intervals);
+  constraints.jacobian(tau, jacobian);
+
+  const double dtau = 1.0e-6;
+  Eigen::VectorXd plus(rows);
+  Eigen::VectorXd minus(rows);
+  for (std::size_t j = 0; j < intervals; j++) {
+    Eigen::VectorXd tau_aux = tau;
+    tau_aux(j) += dtau;
+    constraints.values(tau_aux, plus);
+    tau_aux(j) -= 2.0 * dtau;
+    constraints.values(tau_aux, minus);
+    const Eigen::VectorXd fd = (plus - minus) / (2.0 * dtau);
+    EXPECT_LT((fd - jacobian.col(j)).norm(), 1.0e-6 * jacobian.norm());
+  }
+}
+
+TEST(KinematicConstraints, Scaling) {
+  const basis::BasisLegendre basis(6);
+  const Eigen::MatrixXd wp = Eigen::MatrixXd::Random(intervals + 1, dim);
+  const Eigen::VectorXd tau = Eigen::VectorXd::Random(intervals).array() + 1.5;
+  for (bool velocity : {true, false}) {
+    optimization::KinematicConstraints constraints(
+        wp, basis, samples,
+        velocity ? std::optional<std::vector<double>>(
+                       std::vector<double>(dim, 0.3))
+                 : std::nullopt,
+        std::vector<double>(dim, 0.2));
+    const double factor = constraints.min_scaling_factor(tau);
+    EXPECT_NEAR(constraints.min_scaling_factor(factor * tau), 1.0, 1.0e-9);
+
+    Eigen::VectorXd values(constraints.get_number_of_constraints());
+    constraints.values(factor * tau, values);
+    EXPECT_TRUE((values.array().abs() <=
+                 constraints.get_bounds().array() * (1.0 + 1.0e-9))
+                    .all());
+  }
+  EXPECT_THROW(optimization::KinematicConstraints(wp, basis, samples,
+                                                  std::nullopt, std::nullopt),
+               std::invalid_argument);
+  EXPECT_THROW(optimization::KinematicConstraints(
+                   wp, basis, samples, std::vector<double>(dim + 1, 1.0),
+                   std::nullopt),
+               std::invalid_argument);
+}
+
+int main(int argc, char **argv) {
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
@@ -1,6 +1,7 @@
 #include <eigen3/Eigen/Core>
 #include <gsplines/Basis/Basis.hpp>
 #include <gsplines/Basis/Basis0101.hpp>
+#include <gsplines/Basis/BasisLagrange.hpp>
 #include <gsplines/Basis/BasisLegendre.hpp>
 #include <gsplines/GSpline.hpp>
 #include <gsplines/Tools.hpp>
@@ -81,6 +82,43 @@ TEST(LinearScaling, Basis0101) {
   }
 }
 
+/** Test that the exact maxima of the derivatives bound a dense sampling and
+ * are attained up to the sampling error, and that a single bound is enough.
+ **/
+TEST(LinearScaling, MaxAbsDerivative) {
+  std::vector<std::unique_ptr<basis::Basis>> basis_vec;
+  basis_vec.push_back(std::make_unique<basis::BasisLegendre>(6));
+  basis_vec.push_back(std::make_unique<basis::BasisLagrange>(
+      Eigen::VectorXd::LinSpaced(6, -1.0, 1.0)));
+
+  for (const auto& basis : basis_vec) {
+    auto g1 = random_gspline({0.0, 10.0}, 3, *basis);
+    const Eigen::VectorXd time_spam = Eigen::VectorXd::LinSpaced(
+        20000, g1.get_domain().first, g1.get_domain().second);
+    for (std::size_t deg = 0; deg < 4; deg++) {
+      const Eigen::VectorXd exact = g1.max_abs_derivative(deg);
+      const Eigen::VectorXd sampled = g1.derivate(deg)(time_spam)
+                                          .array()
+                                          .abs()
+                                          .colwise()
+                                          .maxCoeff()
+                                          .transpose();
+      EXPECT_TRUE(((exact - sampled).array() >=
+                   -1.0e-9 * (1.0 + sampled.array()))
+                      .all());
+      EXPECT_TRUE(tools::approx_equal(exact, sampled,
+                                      1.0e-3 * (1.0 + sampled.norm())));
+    }
+
+    auto g2 = g1.linear_scaling_new_execution_time_max_velocity_max_acceleration(
+        0.4, std::nullopt);
+    EXPECT_NEAR(g2.max_abs_derivative(1).maxCoeff(), 0.4, 1.0e-9);
+    auto g3 = g1.linear_scaling_new_execution_time_max_velocity_max_acceleration(
+        std::nullopt, 0.6);
+    EXPECT_NEAR(g3.max_abs_derivative(2).maxCoeff(), 0.6, 1.0e-9);
+  }
+}
+
 int main(int argc, char** argv) {
   ::testing::InitGoogleTest(&argc, argv);
   return RUN_ALL_TESTS();
@@ -0,0 +1,215 @@
+#include <eigen3/Eigen/Core>
+#include <gsplines/Basis/Basis0101.hpp>
+#include <gsplines/Basis/BasisLegendre.hpp>
+#include <gsplines/FunctionalAnalysis/Sobolev.hpp>
+#include <gsplines/Optimization/ipopt_solver.hpp>
+#include <gsplines/Optimization/newton_solver.hpp>
+#include <gsplines/Tools.hpp>
+#include <gtest/gtest.h>
+#include <cstddef>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+using namespace gsplines;
+
+/* Check the first order optimality conditions on the simplex */
+void expect_optimal(const Eigen::MatrixXd &_wp, const basis::Basis &_basis,
+                    const std::vector<std::pair<std::size_t, double>> &_weights,
+                    double _exec_time, const Eigen::VectorXd &_tau) {
+  const std::size_t intervals = _wp.rows() - 1;
+  EXPECT_NEAR(_tau.sum(), _exec_time, 1.0e-9);
+  EXPECT_TRUE((_tau.array() > 0.0).all());
+
+  functional_analysis::SobolevNorm cost(_wp, _basis, _weights);
+  Eigen::VectorXd gradient(intervals);
+  cost.deriv_wrt_interval_len(_tau, gradient);
+  const Eigen::VectorXd projected_gradient =
+      gradient.array() - gradient.mean();
+  EXPECT_LT(projected_gradient.norm(), 1.0e-4 * gradient.norm());
+
+  const Eigen::VectorXd uniform =
+      Eigen::VectorXd::Constant(intervals, _exec_time / intervals);
+  EXPECT_LE(cost(_tau), cost(uniform));
+}
+
+TEST(NewtonSolver, ExactHessian) {
+  const std::size_t intervals = 6;
+  const Eigen::MatrixXd wp = Eigen::MatrixXd::Random(intervals + 1, 3);
+  const basis::BasisLegendre basis(6);
+  const double exec_time = 5.0;
+
+  const std::optional<Eigen::VectorXd> tau =
+      optimization::newton_optimal_interval_lengths(wp, basis, {{3, 1.0}},
+                                                    exec_time);
+  ASSERT_TRUE(tau.has_value());
+  expect_optimal(wp, basis, {{3, 1.0}}, exec_time, tau.value());
+
+  const std::optional<GSpline> curve = optimization::optimal_sobolev_norm(
+      wp, basis, {{3, 1.0}}, exec_time, optimization::SolverBackend::NEWTON);
+  ASSERT_TRUE(curve.has_value());
+  EXPECT_TRUE(tools::approx_equal(curve->get_waypoints(), wp, 1.0e-9));
+  EXPECT_TRUE(
+      tools::approx_equal(curve->get_interval_lengths(), tau.value(), 1.0e-9));
+}
+
+/* Basis0101 has no second derivatives wrt tau, the solver uses BFGS */
+TEST(NewtonSolver, QuasiNewton) {
+  const std::size_t intervals = 5;
+  const Eigen::MatrixXd wp = Eigen::MatrixXd::Random(intervals + 1, 2);
+  const double alpha = 0.5;
+  const basis::Basis0101 basis(alpha);
+  const std::vector<std::pair<std::size_t, double>> weights = {
+      {1, alpha}, {3, 1.0 - alpha}};
+  const double exec_time = 4.0;
+
+  const std::optional<Eigen::VectorXd> tau =
+      optimization::newton_optimal_interval_lengths(wp, basis, weights,
+                                                    exec_time);
+  ASSERT_TRUE(tau.has_value());
+  expect_optimal(wp, basis, weights, exec_time, tau.value());
+}
+
+/* Replanning: start from the solution of a close problem */
+TEST(NewtonSolver, WarmStart) {
+  const std::size_t intervals = 8;
+  const Eigen::MatrixXd wp = Eigen::MatrixXd::Random(intervals + 1, 3);
+  const basis::BasisLegendre basis(6);
+  const double exec_time = 5.0;
+
+  const std::optional<Eigen::VectorXd> tau =
+      optimization::newton_optimal_interval_lengths(wp, basis, {{3, 1.0}},
+                                                    exec_time);
+  ASSERT_TRUE(tau.has_value());
+
+  // The initial guess is scaled to the execution time
+  const std::optional<Eigen::VectorXd> same_tau =
+      optimization::newton_optimal_interval_lengths(
+          wp, basis, {{3, 1.0}}, exec_time, 3.0 * tau.value());
+  ASSERT_TRUE(same_tau.has_value());
+  EXPECT_TRUE(tools::approx_equal(same_tau.value(), tau.value(), 1.0e-6));
+
+  const Eigen::MatrixXd new_wp =
+      wp + 1.0e-2 * Eigen::MatrixXd::Random(intervals + 1, 3);
+  const std::optional<GSpline> curve = optimization::optimal_sobolev_norm(
+      new_wp, basis, {{3, 1.0}}, exec_time, tau.value(),
+      optimization::SolverBackend::NEWTON);
+  ASSERT_TRUE(curve.has_value());
+  expect_optimal(new_wp, basis, {{3, 1.0}}, exec_time,
+                 curve->get_interval_lengths());
+
+  EXPECT_THROW(optimization::newton_optimal_interval_lengths(
+                   wp, basis, {{3, 1.0}}, exec_time,
+                   Eigen::VectorXd::Ones(intervals - 1)),
+               std::invalid_argument);
+  EXPECT_THROW(optimization::optimal_sobolev_norm(
+                   wp, basis, {{3, 1.0}}, exec_time,
+                   -Eigen::VectorXd::Ones(intervals),
+                   optimization::SolverBackend::NEWTON),
+               std::invalid_argument);
+}
+
+TEST(NewtonSolver, Statistics) {
+  const std::size_t intervals = 6;
+  const Eigen::MatrixXd wp = Eigen::MatrixXd::Random(intervals + 1, 3);
+  const basis::BasisLegendre basis(6);
+  const double exec_time = 5.0;
+
+  optimization::SolverStatistics statistics;
+  std::size_t calls = 0;
+  statistics.callback = [&calls](std::size_t _iter, const Eigen::VectorXd &_tau,
+                                 double /*_cost*/) {
+    EXPECT_EQ(_iter, calls);
+    EXPECT_NEAR(_tau.sum(), 5.0, 1.0e-9);
+    calls++;
+  };
+  const std::optional<GSpline> curve = optimization::optimal_sobolev_norm(
+      wp, basis, {{3, 1.0}}, exec_time, Eigen::VectorXd::Ones(intervals),
+      optimization::SolverBackend::NEWTON, &statistics);
+  ASSERT_TRUE(curve.has_value());
+
+  EXPECT_EQ(statistics.return_status,
+            optimization::IpoptReturnStatus::Solve_Succeeded);
+  EXPECT_GT(statistics.iterations, 0);
+  ASSERT_EQ(statistics.cost_history.size(), statistics.iterations + 1);
+  EXPECT_EQ(calls, statistics.iterations + 1);
+  for (std::size_t k = 1; k < statistics.cost_history.size(); k++) {
+    EXPECT_LE(statistics.cost_history[k], statistics.cost_history[k - 1]);
+  }
+  functional_analysis::SobolevNorm cost(wp, basis, {{3, 1.0}});
+  EXPECT_NEAR(statistics.cost_history.back(),
+              cost(curve->get_interval_lengths()),
+              1.0e-9 * statistics.cost_history.back());
+
+  const functional_analysis::SobolevNormTimings &timings =
+      statistics.cost_timings;
+  EXPECT_GT(timings.interpolation.factorizations, 0);
+  EXPECT_GT(timings.evaluations, 0);
+  EXPECT_GE(timings.hessian_evaluations, statistics.iterations);
+  EXPECT_GT(timings.interpolation.assembly, 0.0);
+  EXPECT_GT(timings.interpolation.factorization, 0.0);
+  EXPECT_GT(statistics.total_time, 0.0);
+  EXPECT_GE(statistics.total_time, statistics.cost_time());
+  EXPECT_NEAR(statistics.solver_time,
+              statistics.total_time - statistics.cost_time(), 1.0e-12);
+
+  // The statistics are reset by each solve, the callback is kept
+  calls = 0;
+  ASSERT_TRUE(optimization::newton_optimal_interval_lengths(
+      wp, basis, {{3, 1.0}}, exec_time, curve->get_interval_lengths(),
+      optimization::NewtonSolverOptions(), &statistics));
+  EXPECT_EQ(statistics.cost_history.size(), statistics.iterations + 1);
+  EXPECT_EQ(calls, statistics.iterations + 1);
+}
+
+TEST(NewtonSolver, Anytime) {
+  const std::size_t intervals = 8;
+  const Eigen::MatrixXd wp = Eigen::MatrixXd::Random(intervals + 1, 3);
+  const basis::BasisLegendre basis(6);
+  const double exec_time = 5.0;
+
+  // The budget is exhausted before the first iteration, the initial point is
+  // returned
+  const optimization::AnytimeSolution early =
+      optimization::optimal_sobolev_norm_anytime(
+          wp, basis, {{3, 1.0}}, exec_time, 1.0e-12,
+          optimization::SolverBackend::NEWTON);
+  EXPECT_FALSE(early.converged);
+  EXPECT_TRUE(tools::approx_equal(
+      early.curve.get_interval_lengths(),
+      Eigen::VectorXd::Constant(intervals, exec_time / intervals), 1.0e-12));
+  EXPECT_GT(early.suboptimality, 1.0e-4);
+  EXPECT_TRUE(tools::approx_equal(early.curve.get_waypoints(), wp, 1.0e-9));
+
+  const optimization::AnytimeSolution solution =
+      optimization::optimal_sobolev_norm_anytime(
+          wp, basis, {{3, 1.0}}, exec_time, 60.0,
+          optimization::SolverBackend::NEWTON);
+  EXPECT_TRUE(solution.converged);
+  EXPECT_LT(solution.suboptimality, 1.0e-4);
+  EXPECT_GT(solution.elapsed_time, 0.0);
+  expect_optimal(wp, basis, {{3, 1.0}}, exec_time,
+                 solution.curve.get_interval_lengths());
+
+  EXPECT_THROW(optimization::optimal_sobolev_norm_anytime(
+                   wp, basis, {{3, 1.0}}, exec_time, 0.0,
+                   optimization::SolverBackend::NEWTON),
+               std::invalid_argument);
+}
+
+/* Waypoints so large that the cost overflows give a non finite Hessian,
+ * the solver gives up instead of regularizing it forever */
+TEST(NewtonSolver, NonFiniteHessian) {
+  const Eigen::MatrixXd wp = 1.0e200 * Eigen::MatrixXd::Random(5, 2);
+  optimization::SolverStatistics statistics;
+  EXPECT_FALSE(optimization::newton_optimal_interval_lengths(
+      wp, basis::BasisLegendre(6), {{3, 1.0}}, 4.0,
+      optimization::NewtonSolverOptions(), &statistics));
+  EXPECT_EQ(statistics.return_status,
+            optimization::IpoptReturnStatus::Invalid_Number_Detected);
+}
+
+int main(int argc, char **argv) {
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
@@ -0,0 +1,82 @@
+#include <gsplines/SmallVector.hpp>
+#include <gtest/gtest.h>
+#include <iterator>
+#include <memory>
+#include <utility>
+#include <vector>
+
+using gsplines::tools::SmallVector;
+
+namespace {
+std::vector<int> values(const SmallVector<std::unique_ptr<int>, 2> &_array) {
+  std::vector<int> result;
+  for (const std::unique_ptr<int> &element : _array) {
+    result.push_back(*element);
+  }
+  return result;
+}
+} // namespace
+
+TEST(SmallVector, Growth) {
+  SmallVector<std::unique_ptr<int>, 2> array;
+  array.push_back(std::make_unique<int>(1));
+  array.push_back(std::make_unique<int>(2));
+  EXPECT_TRUE(array.is_inline());
+
+  array.push_back(std::make_unique<int>(3));
+  EXPECT_FALSE(array.is_inline());
+  EXPECT_EQ(values(array), std::vector<int>({1, 2, 3}));
+
+  array.insert(array.begin(), std::make_unique<int>(0));
+  EXPECT_EQ(values(array), std::vector<int>({0, 1, 2, 3}));
+
+  array.erase(array.begin() + 1);
+  EXPECT_EQ(values(array), std::vector<int>({0, 2, 3}));
+
+  SmallVector<std::unique_ptr<int>, 2> other;
+  other.push_back(std::make_unique<int>(-2));
+  other.push_back(std::make_unique<int>(-1));
+  array.insert(array.begin(), std::make_move_iterator(other.begin()),
+               std::make_move_iterator(other.end()));
+  EXPECT_EQ(values(array), std::vector<int>({-2, -1, 0, 2, 3}));
+  EXPECT_EQ(*array.front(), -2);
+  EXPECT_EQ(*array.back(), 3);
+  EXPECT_EQ(**array.rbegin(), 3);
+
+  array.clear();
+  EXPECT_TRUE(array.empty());
+}
+
+TEST(SmallVector, CopyAndMove) {
+  for (int size : {1, 2, 5}) {
+    SmallVector<std::unique_ptr<int>, 2> array;
+    std::vector<int> expected;
+    for (int k = 0; k < size; k++) {
+      array.emplace_back(new int(k));
+      expected.push_back(k);
+    }
+    SmallVector<std::unique_ptr<int>, 2> moved(std::move(array));
+    EXPECT_TRUE(array.empty());
+    EXPECT_EQ(values(moved), expected);
+
+    array = std::move(moved);
+    EXPECT_TRUE(moved.empty());
+    EXPECT_EQ(values(array), expected);
+  }
+
+  SmallVector<int, 2> numbers;
+  for (int k = 0; k < 5; k++) {
+    numbers.push_back(k);
+  }
+  SmallVector<int, 2> copy(numbers);
+  numbers[0] = 10;
+  EXPECT_EQ(copy[0], 0);
+  EXPECT_EQ(copy.size(), 5);
+  copy = numbers;
+  EXPECT_EQ(copy[0], 10);
+}
+
+int main(int argc, char **argv) {
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}
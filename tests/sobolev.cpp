@@ -0,0 +1,96 @@
+#include <eigen3/Eigen/Core>
+#include <gsplines/Basis/BasisLagrange.hpp>
+#include <gsplines/Basis/BasisLegendre.hpp>
+#include <gsplines/Collocation/GaussLobattoPointsWeights.hpp>
+#include <gsplines/FunctionalAnalysis/Sobolev.hpp>
+#include <gsplines/Tools.hpp>
+#include <gtest/gtest.h>
+#include <cstddef>
+#include <vector>
+
+using namespace gsplines;
+
+/* Test that the memoized evaluation of the Sobolev norm and of its gradient
+ * agree with a fresh evaluation and with finite differences */
+TEST(SobolevNorm, Memo) {
+  const std::size_t intervals = 5;
+  const std::size_t dim = 3;
+  const basis::BasisLegendre basis(6);
+  const Eigen::MatrixXd wp = Eigen::MatrixXd::Random(intervals + 1, dim);
+  const Eigen::VectorXd tau1 =
+      Eigen::VectorXd::Random(intervals).array() + 1.5;
+  const Eigen::VectorXd tau2 =
+      Eigen::VectorXd::Random(intervals).array() + 1.5;
+
+  functional_analysis::SobolevNorm cost(wp, basis, {{3, 1.0}});
+
+  const double value_1 = cost(tau1);
+  Eigen::VectorXd gradient_1(intervals);
+  cost.deriv_wrt_interval_len(tau1, gradient_1);
+
+  // Evaluate somewhere else and come back
+  cost(tau2);
+  Eigen::VectorXd gradient_2(intervals);
+  cost.deriv_wrt_interval_len(tau2, gradient_2);
+  EXPECT_DOUBLE_EQ(cost(tau1), value_1);
+
+  functional_analysis::SobolevNorm fresh_cost(wp, basis, {{3, 1.0}});
+  Eigen::VectorXd gradient_fresh(intervals);
+  fresh_cost.deriv_wrt_interval_len(tau1, gradient_fresh);
+  EXPECT_DOUBLE_EQ(fresh_cost(tau1), value_1);
+  EXPECT_TRUE(tools::approx_equal(gradient_fresh, gradient_1, 1.0e-9));
+
+  const double dt = 1.0e-6;
+  for (std::size_t i = 0; i < intervals; i++) {
+    Eigen::VectorXd tau_plus = tau1;
+    Eigen::VectorXd tau_minus = tau1;
+    tau_plus(i) += dt;
+    tau_minus(i) -= dt;
+    const double fd = (cost(tau_plus) - cost(tau_minus)) / (2.0 * dt);
+    EXPECT_NEAR(fd, gradient_1(i), 1.0e-4 * std::max(1.0, std::abs(fd)));
+  }
+}
+
+/* Test the exact Hessian against finite differences of the gradient */
+TEST(SobolevNorm, Hessian) {
+  const std::size_t intervals = 4;
+  const std::size_t dim = 2;
+  const Eigen::MatrixXd wp = Eigen::MatrixXd::Random(intervals + 1, dim);
+  const Eigen::VectorXd tau = Eigen::VectorXd::Random(intervals).array() + 2.0;
+  const basis::BasisLegendre legendre(6);
+  const basis::BasisLagrange lagrange(
+      collocation::legendre_gauss_lobatto_points(6));
+
+  for (const basis::Basis *basis :
+       std::vector<const basis::Basis *>{&legendre, &lagrange}) {
+    functional_analysis::SobolevNorm cost(wp, *basis, {{1, 0.5}, {3, 1.0}});
+    Eigen::MatrixXd hessian(intervals, intervals);
+    cost.hessian_wrt_interval_len(tau, hessian);
+
+    EXPECT_TRUE(tools::approx_equal(hessian, hessian.transpose(),
+                                    1.0e-9 * hessian.norm()))
+        << hessian;
+
+    const double dt = 1.0e-5;
+    Eigen::VectorXd gradient_plus(intervals);
+    Eigen::VectorXd gradient_minus(intervals);
+    for (std::size_t j = 0; j < intervals; j++) {
+      Eigen::VectorXd tau_plus = tau;
+      Eigen::VectorXd tau_minus = tau;
+      tau_plus(j) += dt;
+      tau_minus(j) -= dt;
+      cost.deriv_wrt_interval_len(tau_plus, gradient_plus);
+      cost.deriv_wrt_interval_len(tau_minus, gradient_minus);
+      const Eigen::VectorXd fd = (gradient_plus - gradient_minus) / (2.0 * dt);
+      // entries are of very different magnitudes, compare with the norm
+      for (std::size_t i = 0; i < intervals; i++) {
+        EXPECT_NEAR(fd(i), hessian(i, j), 1.0e-5 * hessian.norm());
+      }
+    }
+  }
+}
+
+int main(int argc, char **argv) {
+  ::testing::InitGoogleTest(&argc, argv);
+  return RUN_ALL_TESTS();
+}